@@ -20,6 +20,8 @@
 // MAST includes
 #include <mast/base/exceptions.hpp>
 #include <mast/base/scalar_constant.hpp>
+#include <mast/base/assembly/libmesh/accessor.hpp>
+#include <mast/base/assembly/libmesh/multi_output_derivative.hpp>
 #include <mast/fe/eval/fe_basis_derivatives.hpp>
 #include <mast/fe/libmesh/fe_data.hpp>
 #include <mast/fe/fe_var_data.hpp>
@@ -33,8 +35,10 @@
 #include <mast/optimization/topology/simp/libmesh/residual_and_jacobian.hpp>
 #include <mast/optimization/topology/simp/libmesh/assemble_output_sensitivity.hpp>
 #include <mast/optimization/topology/simp/libmesh/volume.hpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
 #include <mast/optimization/design_parameter.hpp>
 #include <mast/optimization/solvers/gcmma_interface.hpp>
+#include <mast/optimization/solvers/distributed_gcmma_interface.hpp>
 #include <mast/optimization/utility/design_history.hpp>
 #include <mast/util/getpot_wrapper.hpp>
 #include <mast/mesh/libmesh/geometric_filter.hpp>
@@ -232,6 +236,8 @@ public:
     k               (nullptr),
     qv              (nullptr),
     area            (nullptr),
+    temperature_p   (c.ex_init.input("temperature_pnorm",
+                                     "exponent of the p-norm of temperature", 8.)),
     _fe_data        (nullptr),
     _fe_var         (nullptr),
     _density_fe_var (nullptr),
@@ -373,11 +379,75 @@ public:
     }
 
     
+    /*!
+     * @returns the integral of \f$ |T|^p \f$ over the element, where \f$ p \f$ is
+     * \p temperature_p. This is used for the p-norm of temperature.
+     */
+    template <typename ContextType,
+              typename AccessorType>
+    inline scalar_t
+    temperature_pnorm_integral(ContextType                       &c,
+                               const AccessorType                &sol_v) {
+        
+        c.fe = &_fe_data->fe_derivative();
+        _fe_data->reinit(c);
+        _fe_var->init(c, sol_v);
+        
+        scalar_t
+        v = 0.;
+        
+        for (uint_t i=0; i<_fe_var->n_q_points(); i++)
+            v += std::pow(std::abs(_fe_var->u(i, 0)), temperature_p) *
+            _fe_data->fe_derivative().detJxW(i);
+        
+        return v;
+    }
+    
+    
+    /*!
+     * computes the derivative of \p temperature_pnorm_integral() with respect to the
+     * element temperature dofs in the only entry of \p dqdX_e. This is used by
+     * \p MultiOutputDerivative for the right-hand side of the adjoint problem of the
+     * temperature constraint.
+     */
+    template <typename ContextType,
+              typename AccessorType>
+    inline void
+    derivativeX(ContextType                       &c,
+                const AccessorType                &sol_v,
+                std::vector<vector_t>             &dqdX_e) {
+        
+        Assert1(dqdX_e.size() == 1, dqdX_e.size(), "Only one output is computed");
+        
+        c.fe = &_fe_data->fe_derivative();
+        _fe_data->reinit(c);
+        _fe_var->init(c, sol_v);
+        
+        const typename TraitsType::fe_shape_t
+        &fe = _fe_data->fe_derivative();
+        
+        scalar_t
+        T  = 0.,
+        dv = 0.;
+        
+        for (uint_t i=0; i<_fe_var->n_q_points(); i++) {
+            
+            T  = _fe_var->u(i, 0);
+            dv = temperature_p * std::pow(std::abs(T), temperature_p-1.) *
+            (T < 0.? -1. : 1.) * fe.detJxW(i);
+            
+            for (uint_t j=0; j<fe.n_basis(); j++)
+                dqdX_e[0](j) += dv * fe.phi(i, j);
+        }
+    }
+
+    
     // parameters
     typename TraitsType::density_t        *density;
     typename TraitsType::conductance_t    *k;
     typename TraitsType::source_t         *qv;
     typename TraitsType::area_t           *area;
+    real_t                                 temperature_p;
     
 private:
     
@@ -407,13 +477,37 @@ public:
     _e_ops        (e_ops),
     _c            (c),
     _dvs          (new MAST::Optimization::DesignParameterVector<scalar_t>(c.rho_sys->comm())),
+    _dv_map       (nullptr),
     _volume       (_c.ex_init.model->reference_volume(_c.ex_init)),
     _vf           (_c.ex_init.input("volume_fraction",
-                                    "upper limit for the volume fraction", 0.3)) {
+                                    "upper limit for the volume fraction", 0.3)),
+    _temp_max     (_c.ex_init.input("temperature_limit",
+                                    "upper limit for the p-norm of temperature, no constraint if zero", 0.)),
+    _temp_pnorm   (0.),
+    _subspace     (_c.ex_init.input("recycled_subspace_size",
+                                    "number of previous solutions used for initial guess of linear solves", 10)),
+    _linear_solver(c.eq_sys->comm().get()) {
+        
+        // optionally, the initial guess of each Krylov solve is computed from the
+        // previous solutions. This is not used with direct solvers.
+        if (_c.ex_init.input("recycled_subspace",
+                             "use previous solutions for initial guess of linear solves", false))
+            _linear_solver.set_recycled_subspace(&_subspace);
         
         // initialize the design variable vector
         _c.ex_init.model->init_simp_dvs(_c.ex_init, *_dvs);
         
+        // map from the design variables to the density dofs. The distributed optimizer
+        // provides only the local design variables and sensitivities on each rank,
+        // while the other optimizers replicate these on all ranks.
+        _dv_map = new MAST::Optimization::Utility::DesignParameterMap<scalar_t>
+        (*_dvs,
+         _c.ex_init.input("distributed_optimizer",
+                          "partition the design variables across ranks in the optimizer", false)?
+         MAST::Optimization::Utility::DesignParameterMap<scalar_t>::LOCAL:
+         MAST::Optimization::Utility::DesignParameterMap<scalar_t>::REPLICATED);
+        _volume_calc.set_design_parameter_map(*_dv_map);
+        
         // open the file where the history will be stored
         _history.open("optim_history.txt", std::ostream::out);
     }
@@ -421,22 +515,24 @@ public:
     virtual ~FunctionEvaluation() {
         
         _history.close();
+        delete _dv_map;
         delete _dvs;
     }
     
     
     inline uint_t n_vars() const {return _dvs->size();}
+    inline uint_t n_local_vars() const {return _dv_map->n_local();}
     inline uint_t   n_eq() const {return 0;}
-    inline uint_t n_ineq() const {return 1;}
+    inline uint_t n_ineq() const {return (_temp_max > 0.)? 2 : 1;}
     virtual void init_dvar(std::vector<scalar_t>& x,
                            std::vector<scalar_t>& xmin,
                            std::vector<scalar_t>& xmax) {
 
         Assert1(_dvs->size(), _dvs->size(), "Design variables must be initialized");
         
-        x.resize(_dvs->size(), 0.);
-        xmin.resize(_dvs->size());
-        xmax.resize(_dvs->size());
+        x.resize(_dv_map->vector_size(), 0.);
+        xmin.resize(_dv_map->vector_size());
+        xmax.resize(_dv_map->vector_size());
         
         std::fill(xmin.begin(), xmin.end(),      0.);
         std::fill(xmax.begin(), xmax.end(),    1.e0);
@@ -451,6 +547,10 @@ public:
         
         if (nm.length()) {
             
+            Error(_dv_map->layout() ==
+                  MAST::Optimization::Utility::DesignParameterMap<scalar_t>::REPLICATED,
+                  "Restart from file requires design variables replicated on all ranks");
+            
             uint_t
             iter = _c.ex_init.input("restart_optimization_iter",
                                     "restart iteration number from file", 0);
@@ -459,6 +559,12 @@ public:
                                                                         iter,
                                                                         x);
         }
+        else if (_dv_map->layout() ==
+                 MAST::Optimization::Utility::DesignParameterMap<scalar_t>::LOCAL) {
+            
+            for (uint_t i=_dvs->local_begin(); i<_dvs->local_end(); i++)
+                x[i-_dvs->local_begin()] = (*_dvs)[i]();
+        }
         else {
             
             for (uint_t i=_dvs->local_begin(); i<_dvs->local_end(); i++)
@@ -477,10 +583,229 @@ public:
                           std::vector<bool>           &eval_grads,
                           std::vector<scalar_t>       &grads) {
 
+        // the forward solve is reused if the last evaluation was at the same design
+        _forward_solve(x, obj, fvals);
+        
+        //////////////////////////////////////////////////////////////////////
+        // check to see if the sensitivity of constraint is requested
+        //////////////////////////////////////////////////////////////////////
+        bool if_grad_sens = false;
+        for (uint_t i=0; i<eval_grads.size(); i++)
+            if_grad_sens = (if_grad_sens || eval_grads[i]);
+        
+        //*********************************************************************
+        // DO NOT zero out the gradient vector, since GCMMA needs it for the  *
+        // subproblem solution                                                *
+        //*********************************************************************
+        
+        const uint_t
+        n_dofs = _c.ex_init.sys->n_dofs(),
+        n_con  = n_ineq();
+        
+        const bool
+        eval_temp_grad = (_temp_max > 0.) && eval_grads[1];
+        
+        //////////////////////////////////////////////////////////////////////
+        // adjoint solutions for the objective and the temperature constraint
+        //////////////////////////////////////////////////////////////////////
+        // the right-hand sides of all requested adjoint problems are solved together
+        // in a single block solve. Since the conduction operator is symmetric, \f$ K^T = K \f$.
+        std::vector<std::unique_ptr<libMesh::NumericVector<real_t>>>
+        rhs,
+        adj,
+        adj_localized;
+        std::vector<Vec>
+        rhs_v,
+        adj_v;
+        
+        if (eval_obj_grad) {
+            
+            // the adjoint solution for sum of temperature is obtained using a RHS vector
+            // of unit values scaled by the number of degrees-of-freedom, \f$ N \f$.
+            // \f[ K^T \lambda = - \{1\}/N \f]
+            //
+            rhs.push_back(std::unique_ptr<libMesh::NumericVector<real_t>>
+                          (_c.sys->solution->zero_clone().release()));
+            (*rhs.back()) = -1./(1.*n_dofs);
+        }
+        
+        if (eval_temp_grad) {
+            
+            // the derivative of the p-norm of temperature,
+            // \f$ T_p = \left( \frac{1}{V_0} \int_\Omega |T|^p d\Omega \right)^{1/p} \f$,
+            // is assembled from the derivative of the integral, which gives
+            // \f[ K^T \lambda = - \frac{T_p^{1-p}}{p V_0 T_{max}}
+            //    \frac{\partial}{\partial T} \int_\Omega |T|^p d\Omega \f]
+            rhs.push_back(std::unique_ptr<libMesh::NumericVector<real_t>>
+                          (_c.sys->solution->zero_clone().release()));
+            
+            MAST::Base::Assembly::libMeshWrapper::MultiOutputDerivative<scalar_t, ElemOps<TraitsType>>
+            dq_dX;
+            dq_dX.set_elem_ops(_e_ops);
+            
+            std::vector<libMesh::NumericVector<real_t>*>
+            dq_dX_v(1, rhs.back().get());
+            dq_dX.assemble(_c, *_c.sys->current_local_solution, dq_dX_v);
+            
+            rhs.back()->scale(-std::pow(_temp_pnorm, 1.-_e_ops.temperature_p)/
+                              (_e_ops.temperature_p * _volume * _temp_max));
+        }
+        
+        for (uint_t i=0; i<rhs.size(); i++) {
+            
+            adj.push_back(std::unique_ptr<libMesh::NumericVector<real_t>>
+                          (_c.sys->solution->zero_clone().release()));
+            adj_localized.push_back(std::unique_ptr<libMesh::NumericVector<real_t>>
+                                    (_c.sys->current_local_solution->zero_clone().release()));
+            rhs_v.push_back(dynamic_cast<libMesh::PetscVector<real_t>*>(rhs[i].get())->vec());
+            adj_v.push_back(dynamic_cast<libMesh::PetscVector<real_t>*>(adj[i].get())->vec());
+        }
+        
+        if (rhs.size()) {
+            
+            _linear_solver.solve(adj_v, rhs_v);
+            
+            for (uint_t i=0; i<adj.size(); i++)
+                adj[i]->localize(*adj_localized[i], _c.sys->get_dof_map().get_send_list());
+        }
+        
+        // neither output depends explicitly on the density, so the same element operations
+        // provide the residual and the output sensitivity.
+        MAST::Optimization::Topology::SIMP::libMeshWrapper::AssembleOutputSensitivity
+        <scalar_t, ElemOps<TraitsType>, ElemOps<TraitsType>>
+        output_sens;
+        
+        output_sens.set_elem_ops(_e_ops, _e_ops);
+        output_sens.set_design_parameter_map(*_dv_map);
+        
+        //////////////////////////////////////////////////////////////////////
+        // evaluate the objective sensitivities, if requested
+        //////////////////////////////////////////////////////////////////////
+        if (eval_obj_grad) {
+            
+            // This solves for the sensitivity of sum of temperature,
+            // \f$ T_s=\sum_{i=1}^N T_i \f$, with respect to a parameter \f$ \alpha \f$.
+            // \f{eqnarray*}{ \frac{dT_s)}{d\alpha}
+            //    & = & \frac{\partial T_s}{\partial \alpha} + \frac{\partial T_s}{\partial T}
+            //     \frac{dT}{d\alpha} \\
+            //    & = & 0 + \lambda^T \frac{\partial R(x)}{\partial \alpha}
+            // \f}
+            output_sens.assemble(_c,
+                                 *_c.sys->current_local_solution,      // solution
+                                 *_c.rho_sys->current_local_solution,  // filtered density
+                                 *adj_localized[0],                    // adjoint solution
+                                 *_c.ex_init.filter,                   // geometric filter
+                                 *_dvs,
+                                 obj_grad);
+        }
+        
+        
+        //////////////////////////////////////////////////////////////////////
+        // evaluate the sensitivities for constraints
+        //////////////////////////////////////////////////////////////////////
+        if (if_grad_sens) {
+            
+            //////////////////////////////////////////////////////////////////
+            // indices used by GCMMA follow this rule:
+            // grad_k = dfi/dxj  ,  where k = j*NFunc + i
+            //////////////////////////////////////////////////////////////////
+
+            std::vector<scalar_t>
+            sens(_dv_map->vector_size(), 0.);
+            
+            if (eval_grads[0]) {
+                
+                _volume_calc.derivative(_c,
+                                        *_c.rho_sys->current_local_solution,
+                                        *_c.ex_init.filter,
+                                        sens);
+                for (uint_t i=0; i<sens.size(); i++)
+                    grads[i*n_con] = sens[i]/_volume;
+            }
+            
+            if (eval_temp_grad) {
+                
+                output_sens.assemble(_c,
+                                     *_c.sys->current_local_solution,
+                                     *_c.rho_sys->current_local_solution,
+                                     *adj_localized.back(),
+                                     *_c.ex_init.filter,
+                                     *_dvs,
+                                     sens);
+                for (uint_t i=0; i<sens.size(); i++)
+                    grads[i*n_con+1] = sens[i];
+            }
+        }
+    }
+    
+    
+    /*!
+     * evaluates the objective and constraint functions only, without the adjoint solutions
+     * and sensitivity assembly. This is used for the trial points in the inner iterations
+     * of GCMMA. The forward solution is retained so that a subsequent call to
+     * \p evaluate() at the same design only computes the sensitivities.
+     */
+    inline void evaluate_values(const std::vector<scalar_t> &x,
+                                scalar_t                    &obj,
+                                std::vector<scalar_t>       &fvals) {
+        
+        _forward_solve(x, obj, fvals);
+    }
+    
+    
+    /*!
+     * clears the cached forward solution. This must be called if the analysis is changed
+     * without a change in design variables, for example, during continuation.
+     */
+    inline void clear_cache() {
+        
+        _x_cache.clear();
+    }
+    
+    inline void output(const uint_t                iter,
+                       const std::vector<real_t>  &dvars,
+                       real_t                     &o,
+                       std::vector<real_t>        &fvals) {
+        
+        std::ostringstream oss;
+        oss << "output_optim.e-s." << std::setfill('0') << std::setw(5) << iter ;
+        
+        _c.sys->time = iter;
+        libMesh::Nemesis_IO writer(*_c.mesh);
+        // "1" is the number of time-steps in the file,
+        // as opposed to the time-step number.
+        writer.write_timestep(oss.str(), *_c.eq_sys, 1, (real_t)iter);
+        
+        // also, save the design iteration to a text file
+        MAST::Optimization::Utility::write_obj_constr_history_to_file(*this,
+                                                                      _history,
+                                                                      iter,
+                                                                      o,
+                                                                      fvals);
+
+    }
+    
+private:
+    
+    /*!
+     * computes the filtered density, the forward solution and the functions at \p x.
+     * These are not recomputed if \p x is the design of the last forward solve.
+     */
+    inline void _forward_solve(const std::vector<scalar_t> &x,
+                               scalar_t                    &obj,
+                               std::vector<scalar_t>       &fvals) {
+        
+        if (!_x_cache.empty() && x == _x_cache) {
+            
+            obj   = _obj_cache;
+            fvals = _fvals_cache;
+            return;
+        }
+        
         std::cout << "New Evaluation" << std::endl;
         
-        Assert2(x.size() == _dvs->size(),
-                x.size(), _dvs->size(),
+        Assert2(x.size() == _dv_map->vector_size(),
+                x.size(), _dv_map->vector_size(),
                 "Incompatible design variable vector size.");
 
         libMesh::ExplicitSystem
@@ -502,11 +827,8 @@ public:
         // will be overwritten in \p rho_base.
         *rho_base = 1.;
         
-
-        for (uint_t i=_dvs->local_begin(); i<_dvs->local_end(); i++)
-            rho_base->set(_dvs->get_data_for_parameter((*_dvs)[i]).template get<int>("dof_id"),
-                          x[i]);
-        rho_base->close();
+        // copy the design variables to their density dofs
+        _dv_map->scatter(x, *rho_base);
         
         _c.ex_init.filter->compute_filtered_values
         (dynamic_cast<libMesh::PetscVector<scalar_t>*>(rho_base.get())->vec(),
@@ -516,18 +838,6 @@ public:
         // this will copy the solution to libMesh::System::current_local_soluiton
         _c.rho_sys->update();
 
-        //////////////////////////////////////////////////////////////////////
-        // check to see if the sensitivity of constraint is requested
-        //////////////////////////////////////////////////////////////////////
-        bool if_grad_sens = false;
-        for (uint_t i=0; i<eval_grads.size(); i++)
-            if_grad_sens = (if_grad_sens || eval_grads[i]);
-        
-        //*********************************************************************
-        // DO NOT zero out the gradient vector, since GCMMA needs it for the  *
-        // subproblem solution                                                *
-        //*********************************************************************
-        
         std::cout << "Static Solve" << std::endl;
 
         MAST::Optimization::Topology::SIMP::libMeshWrapper::ResidualAndJacobian<scalar_t, ElemOps<TraitsType>>
@@ -561,10 +871,10 @@ public:
         b   = dynamic_cast<libMesh::PetscVector<real_t>*>(res.get())->vec(),
         sol = dynamic_cast<libMesh::PetscVector<real_t>*>(_c.sys->solution.get())->vec();
         
-        MAST::Solvers::PETScWrapper::LinearSolver
-        linear_solver(_c.eq_sys->comm().get());
-        linear_solver.init(m);
-        linear_solver.solve(sol, b);
+        // the solver is retained across evaluations, and is setup again only if the
+        // matrix has changed. The same preconditioner is used for the adjoint solves.
+        _linear_solver.update_operators(m);
+        _linear_solver.solve(sol, b);
 
         _c.sys->get_dof_map().enforce_constraints_exactly(*_c.sys, _c.sys->solution.get());
 
@@ -579,10 +889,7 @@ public:
         //////////////////////////////////////////////////////////////////////
         
         // evaluate the volume for used in the problem setup
-        MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<scalar_t>
-        volume;
-        
-        vol = volume.compute(_c, *_c.rho_sys->current_local_solution);
+        vol = _volume_calc.compute(_c, *_c.rho_sys->current_local_solution);
         std::cout << "volume: " << vol << std::endl;
         
         // evaluate the output based on specified problem type
@@ -590,101 +897,64 @@ public:
         fvals[0]  = vol/_volume - _vf; // vol/vol0 - a <=
         std::cout << "Sum_i Temperature: " << temp_sum << std::endl;
         
-
-        //////////////////////////////////////////////////////////////////////
-        // evaluate the objective sensitivities, if requested
-        //////////////////////////////////////////////////////////////////////
-        if (eval_obj_grad) {
+        if (_temp_max > 0.) {
             
-            MAST::Optimization::Topology::SIMP::libMeshWrapper::AssembleOutputSensitivity
-            <scalar_t, ElemOps<TraitsType>, ElemOps<TraitsType>>
-            temp_sum_sens;
-            
-            temp_sum_sens.set_elem_ops(_e_ops, _e_ops);
-
-            // the adjoint solution for sum of temperature is obtained using a RHS vector
-            // of unit values scaled by the number of degrees-of-freedom, \f$ N \f$.
-            // \f[ K^T \lambda = - \{1\}/N \f]
-            //
-            (*res) = -1./(1.*n_dofs);
-            
-            std::unique_ptr<libMesh::NumericVector<real_t>>
-            adj(_c.sys->solution->zero_clone().release()),
-            adj_localized(_c.sys->current_local_solution->zero_clone().release());
-            Vec
-            adj_v = dynamic_cast<libMesh::PetscVector<real_t>*>(adj.get())->vec();
-            b     = dynamic_cast<libMesh::PetscVector<real_t>*>(res.get())->vec();
-            linear_solver.solve(adj_v, b);
-            adj->localize(*adj_localized, _c.sys->get_dof_map().get_send_list());
-            
-            // This solves for the sensitivity of sum of temperature,
-            // \f$ T_s=\sum_{i=1}^N T_i \f$, with respect to a parameter \f$ \alpha \f$.
-            // \f{eqnarray*}{ \frac{dT_s)}{d\alpha}
-            //    & = & \frac{\partial T_s}{\partial \alpha} + \frac{\partial T_s}{\partial T}
-            //     \frac{dT}{d\alpha} \\
-            //    & = & 0 + \lambda^T \frac{\partial R(x)}{\partial \alpha}
-            // \f}
-            temp_sum_sens.assemble(_c,
-                                   *_c.sys->current_local_solution,      // solution
-                                   *_c.rho_sys->current_local_solution,  // filtered density
-                                   *adj_localized,                       // adjoint solution
-                                   *_c.ex_init.filter,                   // geometric filter
-                                   *_dvs,
-                                   obj_grad);
+            _temp_pnorm = _temperature_pnorm();
+            fvals[1]    = _temp_pnorm/_temp_max - 1.; // T_p/T_max - 1 <=
+            std::cout << "p-norm Temperature: " << _temp_pnorm << std::endl;
         }
         
-        
-        //////////////////////////////////////////////////////////////////////
-        // evaluate the sensitivities for constraints
-        //////////////////////////////////////////////////////////////////////
-        if (if_grad_sens) {
-            
-            //////////////////////////////////////////////////////////////////
-            // indices used by GCMMA follow this rule:
-            // grad_k = dfi/dxj  ,  where k = j*NFunc + i
-            //////////////////////////////////////////////////////////////////
-
-            volume.derivative(_c,
-                              *_c.rho_sys->current_local_solution,
-                              *_c.ex_init.filter,
-                              *_dvs,
-                              grads);
-            for (uint_t i=0; i<grads.size(); i++)
-                grads[i] /= _volume;
-        }
+        _x_cache     = x;
+        _obj_cache   = obj;
+        _fvals_cache = fvals;
     }
     
-    inline void output(const uint_t                iter,
-                       const std::vector<real_t>  &dvars,
-                       real_t                     &o,
-                       std::vector<real_t>        &fvals) {
+    /*!
+     * @returns the p-norm of the current temperature solution,
+     * \f$ T_p = \left( \frac{1}{V_0} \int_\Omega |T|^p d\Omega \right)^{1/p} \f$, where
+     * \f$ V_0 \f$ is the reference volume. This approaches the maximum temperature
+     * for large \f$ p \f$.
+     */
+    inline scalar_t _temperature_pnorm() {
         
-        std::ostringstream oss;
-        oss << "output_optim.e-s." << std::setfill('0') << std::setw(5) << iter ;
+        MAST::Base::Assembly::libMeshWrapper::Accessor<scalar_t, libMesh::NumericVector<real_t>>
+        sol_accessor(*_c.sys, *_c.sys->current_local_solution);
         
-        _c.sys->time = iter;
-        libMesh::Nemesis_IO writer(*_c.mesh);
-        // "1" is the number of time-steps in the file,
-        // as opposed to the time-step number.
-        writer.write_timestep(oss.str(), *_c.eq_sys, 1, (real_t)iter);
+        scalar_t
+        v = 0.;
         
-        // also, save the design iteration to a text file
-        MAST::Optimization::Utility::write_obj_constr_history_to_file(*this,
-                                                                      _history,
-                                                                      iter,
-                                                                      o,
-                                                                      fvals);
-
+        libMesh::MeshBase::const_element_iterator
+        el     = _c.mesh->active_local_elements_begin(),
+        end_el = _c.mesh->active_local_elements_end();
+        
+        for ( ; el != end_el; ++el) {
+            
+            _c.elem = *el;
+            sol_accessor.init(*_c.elem);
+            v += _e_ops.temperature_pnorm_integral(_c, sol_accessor);
+        }
+        
+        _c.sys->comm().sum(v);
+        
+        return std::pow(v/_volume, 1./_e_ops.temperature_p);
     }
     
-private:
-    
     ElemOps<TraitsType>                                 &_e_ops;
     context_t                                           &_c;
     MAST::Optimization::DesignParameterVector<scalar_t> *_dvs;
+    MAST::Optimization::Utility::DesignParameterMap<scalar_t> *_dv_map;
     real_t                                               _volume;
     real_t                                               _vf;
+    real_t                                               _temp_max;
+    scalar_t                                             _temp_pnorm;
     std::ofstream                                        _history;
+    MAST::Solvers::PETScWrapper::RecycledSubspace        _subspace;
+    MAST::Solvers::PETScWrapper::LinearSolver            _linear_solver;
+    std::vector<scalar_t>                                _x_cache;
+    scalar_t                                             _obj_cache;
+    std::vector<scalar_t>                                _fvals_cache;
+    MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<scalar_t>
+                                                         _volume_calc;
 };
 } // namespace Example2
 } // namespace Conduction
@@ -693,21 +963,18 @@ private:
 
 #ifndef MAST_TESTING
 
-template <typename ModelType>
-void run(libMesh::LibMeshInit& init, MAST::Utility::GetPotWrapper& input) {
-    
-    using traits_t    = MAST::Examples::Conduction::Example2::Traits<real_t, real_t, real_t, ModelType>;
-    using elem_ops_t  = MAST::Examples::Conduction::Example2::ElemOps<traits_t>;
-    using func_eval_t = MAST::Examples::Conduction::Example2::FunctionEvaluation<traits_t>;
-
-    typename traits_t::ex_init_t ex_init(init.comm(), input);
-
-    typename traits_t::context_t  c(ex_init);
-    elem_ops_t           e_ops(c);
-    func_eval_t          f_eval(e_ops, c);
+template <typename OptimizerType,
+          typename ExInitType,
+          typename ElemOpsType,
+          typename FuncEvalType>
+void optimize(libMesh::LibMeshInit&         init,
+              MAST::Utility::GetPotWrapper& input,
+              ExInitType&                   ex_init,
+              ElemOpsType&                  e_ops,
+              FuncEvalType&                 f_eval) {
     
     // create an optimizer, attach the function evaluation
-    MAST::Optimization::Solvers::GCMMAInterface<func_eval_t> optimizer(init.comm());
+    OptimizerType optimizer(init.comm());
     optimizer.max_iters       = input("max_iters","maximum iterations for GCMMA", 50);
     optimizer.max_inner_iters = 6;
     optimizer.constr_penalty  = input("constr_penalty","constraint penalty for GCMMA", 1.e5);
@@ -720,12 +987,38 @@ void run(libMesh::LibMeshInit& init, MAST::Utility::GetPotWrapper& input) {
         
         ex_init.penalty = 1. + 0.5 * i;
      
-        e_ops.density->set_penalty(c.ex_init.penalty);
+        e_ops.density->set_penalty(ex_init.penalty);
+        f_eval.clear_cache();
 
         optimizer.optimize();
     }
 }
 
+
+template <typename ModelType>
+void run(libMesh::LibMeshInit& init, MAST::Utility::GetPotWrapper& input) {
+    
+    using traits_t    = MAST::Examples::Conduction::Example2::Traits<real_t, real_t, real_t, ModelType>;
+    using elem_ops_t  = MAST::Examples::Conduction::Example2::ElemOps<traits_t>;
+    using func_eval_t = MAST::Examples::Conduction::Example2::FunctionEvaluation<traits_t>;
+
+    typename traits_t::ex_init_t ex_init(init.comm(), input);
+
+    typename traits_t::context_t  c(ex_init);
+    elem_ops_t           e_ops(c);
+    func_eval_t          f_eval(e_ops, c);
+    
+    // the distributed optimizer stores only the local design variables on each rank,
+    // which is consistent with the layout of the design parameter map in f_eval
+    if (input("distributed_optimizer",
+              "partition the design variables across ranks in the optimizer", false))
+        optimize<MAST::Optimization::Solvers::DistributedGCMMAInterface<func_eval_t>>
+        (init, input, ex_init, e_ops, f_eval);
+    else
+        optimize<MAST::Optimization::Solvers::GCMMAInterface<func_eval_t>>
+        (init, input, ex_init, e_ops, f_eval);
+}
+
 int main(int argc, char** argv) {
     
     libMesh::LibMeshInit init(argc, argv);
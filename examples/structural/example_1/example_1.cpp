@@ -38,7 +38,8 @@
 #include <mast/base/assembly/libmesh/material_point_output_derivative.hpp>
 #include <mast/base/assembly/libmesh/material_point_output_sensitivity.hpp>
 #include <mast/numerics/libmesh/sparse_matrix_initialization.hpp>
-#include <mast/optimization/aggregation/discrete_aggregation.hpp>
+#include <mast/optimization/aggregation/discrete_aggregator.hpp>
+#include <mast/solvers/eigen/mixed_precision_solver.hpp>
 
 // libMesh includes
 #include <libmesh/replicated_mesh.h>
@@ -76,6 +77,7 @@ public:
     sys       (&eq_sys->add_system<libMesh::NonlinearImplicitSystem>("structural")),
     stress_sys(&eq_sys->add_system<libMesh::ExplicitSystem>("stress")),
     elem      (nullptr),
+    elem_idx  (0),
     qp        (-1),
     p_side_id (1),
     index     (nullptr),
@@ -152,6 +154,7 @@ public:
     libMesh::NonlinearImplicitSystem *sys;
     libMesh::ExplicitSystem          *stress_sys;
     const libMesh::Elem              *elem;
+    uint_t                            elem_idx;
     uint_t                            qp;
     uint_t                            p_side_id;
     mp_indexing_t                    *index;
@@ -184,6 +187,14 @@ struct Traits {
     using element_matrix_t  = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
     using assembled_vector_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
     using assembled_matrix_t = Eigen::SparseMatrix<scalar_t>;
+    // the real-valued systems are factored in single precision with iterative refinement
+    // to double precision. The complex-step systems use the full precision factorization.
+    using linear_solver_t    = typename std::conditional
+    <std::is_same<scalar_t, real_t>::value,
+    MAST::Solvers::EigenWrapper::MixedPrecisionSolver<assembled_matrix_t,
+                                                      Eigen::SparseLU<Eigen::SparseMatrix<float>>,
+                                                      Eigen::SparseLU<assembled_matrix_t>>,
+    Eigen::SparseLU<assembled_matrix_t>>::type;
     using mp_indexing_t      = MAST::Base::MaterialPoint::libMeshWrapper::Indexing;
     using mp_storage_t       = MAST::Base::MaterialPoint::Storage<scalar_t, stress_t::n_strain>;
     using mp_vm_storage_t    = MAST::Base::MaterialPoint::Storage<scalar_t, 1>;
@@ -209,8 +220,6 @@ public:
     nu            (nullptr),
     press         (nullptr),
     area          (nullptr),
-    denom         (0.),
-    s_max         (0.),
     vm_stress_vec (nullptr),
     _fe_data      (nullptr),
     _fe_side_data (nullptr),
@@ -356,7 +365,7 @@ public:
             
             c.qp = i;
             
-            id = index.local_id_for_point_on_elem(c.elem, i);
+            id = index.local_id_for_point_on_elem(c.elem_idx, i);
             typename StorageType::view_t
             stress_qp = storage.data(id);
             
@@ -388,7 +397,7 @@ public:
             
             c.qp = i;
             
-            id = index.local_id_for_point_on_elem(c.elem, i);
+            id = index.local_id_for_point_on_elem(c.elem_idx, i);
             typename StorageType::view_t
             stress_qp = storage.data(id);
             
@@ -429,14 +438,17 @@ public:
         uint_t
         id = 0;
         
-        // we check if \p denom is set to zero, which implies we need to compute
-        // and cache the values for \p denom, which is the
-        // denominator of the discrete aggregate maximum sensitivity, and
-        // \p s_max, which is the maximum vonMises stress out of all material/quadrature
-        // points.
-        if (denom == 0.) {
-            MAST::Optimization::Aggregation::aggregate_maximum_denominator
-            (nullptr, *vm_stress_vec, c.agg_rho, denom, s_max);
+        // the derivative of the discrete aggregate maximum with respect to the
+        // vonMises stress at all material/quadrature points is computed once and
+        // cached in \p vm_agg_grad.
+        if (vm_agg_grad.empty()) {
+            
+            MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>
+            agg(nullptr,
+                MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>::MAXIMUM,
+                c.agg_rho);
+            agg.compute(*vm_stress_vec);
+            agg.gradient(*vm_stress_vec, vm_agg_grad);
         }
 
         
@@ -450,7 +462,7 @@ public:
             
             c.qp = i;
             
-            id = index.local_id_for_point_on_elem(c.elem, i);
+            id = index.local_id_for_point_on_elem(c.elem_idx, i);
             typename StorageType::view_t
             stress_qp = storage.data(id);
             
@@ -464,10 +476,7 @@ public:
             
             // Finally, this is used to compute the derivative of the discrete maximum
             // approximation with respect to the state vector.
-            // Note: We use the cached values of denom and s_max here.
-            dq += val *
-            MAST::Optimization::Aggregation::aggregate_maximum_sensitivity
-            (*vm_stress_vec, id, c.agg_rho, denom, s_max) ;
+            dq += val * vm_agg_grad[id];
         }
         
         return dq;
@@ -501,14 +510,17 @@ public:
         uint_t
         id = 0;
         
-        // we check if \p denom is set to zero, which implies we need to compute
-        // and cache the values for \p denom, which is the
-        // denominator of the discrete aggregate maximum sensitivity, and
-        // \p s_max, which is the maximum vonMises stress out of all material/quadrature
-        // points.
-        if (denom == 0.) {
-            MAST::Optimization::Aggregation::aggregate_maximum_denominator
-            (nullptr, *vm_stress_vec, c.agg_rho, denom, s_max);
+        // the derivative of the discrete aggregate maximum with respect to the
+        // vonMises stress at all material/quadrature points is computed once and
+        // cached in \p vm_agg_grad.
+        if (vm_agg_grad.empty()) {
+            
+            MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>
+            agg(nullptr,
+                MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>::MAXIMUM,
+                c.agg_rho);
+            agg.compute(*vm_stress_vec);
+            agg.gradient(*vm_stress_vec, vm_agg_grad);
         }
 
         // the quantity-of-interest is the discrete approximation to the maximum
@@ -521,7 +533,7 @@ public:
             
             c.qp = i;
             
-            id = index.local_id_for_point_on_elem(c.elem, i);
+            id = index.local_id_for_point_on_elem(c.elem_idx, i);
             typename StorageType::view_t
             stress_qp = storage.data(id);
             
@@ -536,10 +548,7 @@ public:
             
             // Finally, this is used to compute the derivative of the discrete maximum
             // approximation with respect to the state vector.
-            // Note: We use the cached values of denom and s_max here.
-            dqdX += dvm_dX_qp *
-            MAST::Optimization::Aggregation::aggregate_maximum_sensitivity
-            (*vm_stress_vec, id, c.agg_rho, denom, s_max);
+            dqdX += dvm_dX_qp * vm_agg_grad[id];
         }
     }
 
@@ -549,8 +558,7 @@ public:
     typename TraitsType::nu_t         *nu;
     typename TraitsType::press_t      *press;
     typename TraitsType::area_t       *area;
-    scalar_t                           denom;
-    scalar_t                           s_max;
+    std::vector<scalar_t>              vm_agg_grad;
     std::vector<scalar_t>             *vm_stress_vec;
 
 private:
@@ -640,7 +648,11 @@ compute_sol(Context                                  &c,
     
     assembly.assemble(c, sol, &res, &jac);
     
-    sol = Eigen::SparseLU<typename TraitsType::assembled_matrix_t>(jac).solve(-res);
+    typename TraitsType::linear_solver_t
+    solver;
+    
+    solver.compute(jac);
+    sol = solver.solve(-res);
 }
 
 
@@ -679,7 +691,14 @@ compute_adjoint_sol(Context                                        &c,
         assembly.assemble(c, sol, index, stress, dqdX);
     }
     
-    adj = Eigen::SparseLU<typename TraitsType::assembled_matrix_t>(jac.transpose()).solve(-dqdX);
+    // the solver references the matrix, so the transpose is stored
+    typename TraitsType::assembled_matrix_t
+    jac_t = jac.transpose();
+    typename TraitsType::linear_solver_t
+    solver;
+    
+    solver.compute(jac_t);
+    adj = solver.solve(-dqdX);
 }
 
 
@@ -721,7 +740,11 @@ compute_sol_sensitivity(Context                                        &c,
         sens_assembly.assemble(c, f, sol, &dres, djac);
     }
     
-    dsol = Eigen::SparseLU<typename TraitsType::assembled_matrix_t>(jac).solve(-dres);
+    typename TraitsType::linear_solver_t
+    solver;
+    
+    solver.compute(jac);
+    dsol = solver.solve(-dres);
 }
 
 
@@ -741,20 +764,15 @@ compute_vonMises_stress(libMesh::System           &sys,
     
     stress_vm.zero();
     
-    libMesh::MeshBase::const_element_iterator
-    it  = sys.get_mesh().active_local_elements_begin(),
-    end = sys.get_mesh().active_local_elements_end();
-    
-    for ( ; it != end; it++) {
+    // the material points are indexed in the order of the active local elements
+    for (uint_t elem_idx=0; elem_idx<index.n_local_elems(); elem_idx++) {
         
-        const libMesh::Elem *e = *it;
-
         uint_t
         id = 0;
         
         for (uint_t i=0; i<n_qp; i++) {
          
-            id = index.local_id_for_point_on_elem(e, i);
+            id = index.local_id_for_point_on_elem(elem_idx, i);
             
             const typename StressStorageType::view_t
             stress_e = stress.data(id);
@@ -788,20 +806,15 @@ compute_vonMises_stress_sensitivity(libMesh::System           &sys,
     
     dstress_vm.zero();
     
-    libMesh::MeshBase::const_element_iterator
-    it  = sys.get_mesh().active_local_elements_begin(),
-    end = sys.get_mesh().active_local_elements_end();
-    
-    for ( ; it != end; it++) {
+    // the material points are indexed in the order of the active local elements
+    for (uint_t elem_idx=0; elem_idx<index.n_local_elems(); elem_idx++) {
         
-        const libMesh::Elem *e = *it;
-
         uint_t
         id = 0;
         
         for (uint_t i=0; i<n_qp; i++) {
          
-            id = index.local_id_for_point_on_elem(e, i);
+            id = index.local_id_for_point_on_elem(elem_idx, i);
             
             const typename StressStorageType::view_t
             stress_e  = stress.data(id),
@@ -886,7 +899,10 @@ copy_stress_to_system(libMesh::System                  &sys,
     it  = sys.get_mesh().active_local_elements_begin(),
     end = sys.get_mesh().active_local_elements_end();
     
-    for ( ; it != end; it++) {
+    uint_t
+    elem_idx = 0;
+    
+    for ( ; it != end; it++, elem_idx++) {
         
         const libMesh::Elem *e = *it;
 
@@ -900,7 +916,7 @@ copy_stress_to_system(libMesh::System                  &sys,
         
         for (uint_t i=0; i<n_qp; i++) {
          
-            id = index.local_id_for_point_on_elem(e, i);
+            id = index.local_id_for_point_on_elem(elem_idx, i);
             
             const typename StressStorageType::view_t
             stress_e = stress.data(id);
@@ -972,9 +988,13 @@ inline void analysis(ContextType                      &c,
     vals(vm_stress.data(), vm_stress.data()+vm_stress.size());
     
     // since this is a serial example, we pass a \p nullptr for
-    // the communicator (first argument) of the \p aggregate_maximum function.
-    vm_max_agg = MAST::Optimization::Aggregation::aggregate_maximum
-    (nullptr, vals, c.agg_rho);
+    // the communicator of the aggregator.
+    MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>
+    agg(nullptr,
+        MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>::MAXIMUM,
+        c.agg_rho);
+    agg.compute(vals);
+    vm_max_agg = agg.value();
 }
 
 
@@ -1023,9 +1043,13 @@ inline void sensitivity(ContextType                      &c,
     dvals(dvm_stress.data(), dvm_stress.data()+dvm_stress.size());
     
     // since this is a serial example, we pass a \p nullptr for
-    // the communicator (first argument) of the \p aggregate_maximum function.
-    dvm_max_agg = MAST::Optimization::Aggregation::aggregate_maximum_sensitivity
-    (nullptr, vals, dvals, c.agg_rho);
+    // the communicator of the aggregator.
+    MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>
+    agg(nullptr,
+        MAST::Optimization::Aggregation::DiscreteAggregator<scalar_t>::MAXIMUM,
+        c.agg_rho);
+    agg.compute(vals);
+    dvm_max_agg = agg.sensitivity(vals, dvals);
     
     // compute the sensitivity using adjoint solution
     MAST::Base::Assembly::libMeshWrapper::MaterialPointOutputSensitivity
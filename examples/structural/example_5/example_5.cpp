@@ -27,15 +27,16 @@
 #include <mast/fe/scalar_field_wrapper.hpp>
 #include <mast/physics/elasticity/isotropic_stiffness.hpp>
 #include <mast/base/scalar_constant.hpp>
-#include <mast/physics/elasticity/linear_strain_energy.hpp>
 #include <mast/physics/elasticity/pressure_load.hpp>
 #include <mast/physics/elasticity/linear_thermoelastic_load.hpp>
+#include <mast/physics/elasticity/linear_thermoelastic_strain_energy.hpp>
 #include <mast/optimization/topology/simp/penalized_density.hpp>
 #include <mast/optimization/topology/simp/heaviside_filter.hpp>
 #include <mast/optimization/topology/simp/penalized_scalar.hpp>
 #include <mast/optimization/topology/simp/libmesh/residual_and_jacobian.hpp>
 #include <mast/optimization/topology/simp/libmesh/assemble_output_sensitivity.hpp>
 #include <mast/optimization/topology/simp/libmesh/volume.hpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
 #include <mast/numerics/libmesh/sparse_matrix_initialization.hpp>
 #include <mast/util/getpot_wrapper.hpp>
 #include <mast/mesh/libmesh/geometric_filter.hpp>
@@ -224,7 +225,7 @@ struct Traits {
     using temp_t            = typename MAST::Optimization::Topology::SIMP::PenalizedScalar<SolScalarType, density_t>;
     using area_t            = typename MAST::Base::ScalarConstant<SolScalarType>;
     using prop_t            = typename MAST::Physics::Elasticity::IsotropicMaterialStiffness<SolScalarType, dim, modulus_t, nu_t, context_t>;
-    using energy_t          = typename MAST::Physics::Elasticity::LinearContinuum::StrainEnergy<fe_var_t, prop_t, dim, context_t>;
+    using energy_t          = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticStrainEnergy<fe_var_t, temp_t, alpha_t, prop_t, dim, context_t>;
     using press_load_t      = typename MAST::Physics::Elasticity::SurfacePressureLoad<fe_var_t, press_t, area_t, dim, context_t>;
     using temp_load_t       = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticLoad<fe_var_t, temp_t, alpha_t, prop_t, dim, context_t>;
     using element_vector_t  = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
@@ -327,6 +328,8 @@ public:
         _prop->set_modulus_and_nu(*E, *nu);
         _energy   = new typename TraitsType::energy_t;
         _energy->set_section_property(*_prop);
+        _energy->set_coeff_thermal_expansion(*alpha);
+        _energy->set_temperature(*dt);
         _p_load   = new typename TraitsType::press_load_t;
         _p_load->set_section_area(*area);
         _p_load->set_pressure(*press);
@@ -384,7 +387,6 @@ public:
         _density_fe_var->init(c, density_v);
 
         _energy->compute(c, res, jac);
-        _temp_load->compute(c, res, jac);
 
         for (uint_t s=0; s<c.elem->n_sides(); s++)
             if (c.if_compute_pressure_load_on_side(s)) {
@@ -417,7 +419,6 @@ public:
         _density_sens_fe_var->init(c, density_sens);
 
         _energy->derivative(c, f, res, jac);
-        _temp_load->derivative(c, f, res, jac);
     }
 
     
@@ -492,15 +493,22 @@ public:
     _e_ops        (e_ops),
     _c            (c),
     _dvs          (new MAST::Optimization::DesignParameterVector<scalar_t>(c.rho_sys->comm())),
+    _dv_map       (nullptr),
     _volume       (_c.ex_init.model->reference_volume(_c.ex_init)),
     _vf           (_c.ex_init.input("volume_fraction",
                                     "upper limit for the volume fraction", 0.2)) {
         
         // initialize the design variable vector
         _c.ex_init.model->init_simp_dvs(_c.ex_init, *_dvs);
+        
+        // map from the design variables to the density dofs. The optimizer provides
+        // design variables and sensitivities replicated on all ranks.
+        _dv_map = new MAST::Optimization::Utility::DesignParameterMap<scalar_t>
+        (*_dvs, MAST::Optimization::Utility::DesignParameterMap<scalar_t>::REPLICATED);
     }
     
     virtual ~FunctionEvaluation() {
+        delete _dv_map;
         delete _dvs;
     }
     
@@ -565,9 +573,7 @@ public:
 
         const uint_t
         n_dofs          = str_sys.n_dofs(),
-        n_rho_vals      = rho_sys.n_dofs(),
-        first_local_rho = rho_sys.get_dof_map().first_dof(rho_sys.comm().rank()),
-        last_local_rho  = rho_sys.get_dof_map().end_dof(rho_sys.comm().rank());
+        n_rho_vals      = rho_sys.n_dofs();
         
         
         typename TraitsType::assembled_vector_t
@@ -579,13 +585,8 @@ public:
         typename TraitsType::assembled_matrix_t
         jac;
         
-        for (uint_t i=0; i<_dvs->size(); i++) {
-            
-            uint_t dof_id = _dvs->template get_parameter_for_dv<int>(i, "dof_id");
-            
-            if (dof_id >= first_local_rho && dof_id <  last_local_rho)
-                rho_base(dof_id) = x[i];
-        }
+        // copy the design variables to their density dofs
+        _dv_map->scatter(x, rho_base);
 
         _c.ex_init.filter->template compute_filtered_values
         <typename TraitsType::assembled_vector_t,
@@ -653,6 +654,8 @@ public:
         MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<scalar_t>
         volume;
         
+        volume.set_design_parameter_map(*_dv_map);
+        
         vol = volume.compute(_c, rho_filtered, *_e_ops.heaviside);
         
         // evaluate the output based on specified problem type
@@ -670,6 +673,7 @@ public:
             compliance_sens;
             
             compliance_sens.set_elem_ops(_e_ops, _e_ops);
+            compliance_sens.set_design_parameter_map(*_dv_map);
 
             // the adjoint solution for compliance is the negative of displacement. We copy the
             // negative of solution in vector \p res.
@@ -708,7 +712,6 @@ public:
                               rho_filtered,
                               *_e_ops.heaviside,
                               *_c.ex_init.filter,
-                              *_dvs,
                               grads);
             for (uint_t i=0; i<grads.size(); i++)
                 grads[i] /= _volume;
@@ -727,6 +730,7 @@ private:
     ElemOps<TraitsType>                                 &_e_ops;
     context_t                                           &_c;
     MAST::Optimization::DesignParameterVector<scalar_t> *_dvs;
+    MAST::Optimization::Utility::DesignParameterMap<scalar_t> *_dv_map;
     real_t                                               _volume;
     real_t                                               _vf;
 };
@@ -26,9 +26,9 @@
 #include <mast/fe/fe_var_data.hpp>
 #include <mast/fe/scalar_field_wrapper.hpp>
 #include <mast/physics/elasticity/isotropic_stiffness.hpp>
-#include <mast/physics/elasticity/linear_strain_energy.hpp>
 #include <mast/physics/elasticity/pressure_load.hpp>
 #include <mast/physics/elasticity/linear_thermoelastic_load.hpp>
+#include <mast/physics/elasticity/linear_thermoelastic_strain_energy.hpp>
 #include <mast/physics/elasticity/libmesh/mat_null_space.hpp>
 #include <mast/optimization/topology/simp/heaviside_filter.hpp>
 #include <mast/optimization/topology/simp/penalized_density.hpp>
@@ -36,6 +36,8 @@
 #include <mast/optimization/topology/simp/libmesh/residual_and_jacobian.hpp>
 #include <mast/optimization/topology/simp/libmesh/assemble_output_sensitivity.hpp>
 #include <mast/optimization/topology/simp/libmesh/volume.hpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
+#include <mast/optimization/topology/simp/libmesh/projected_density.hpp>
 #include <mast/optimization/design_parameter.hpp>
 #include <mast/optimization/solvers/gcmma_interface.hpp>
 #include <mast/optimization/utility/design_history.hpp>
@@ -91,6 +93,7 @@ public:
     sys           (&eq_sys->add_system<libMesh::NonlinearImplicitSystem>("structural")),
     rho_sys       (&eq_sys->add_system<libMesh::ExplicitSystem>("density")),
     filter        (nullptr),
+    null_sp       (nullptr),
     p_side_id     (-1),
     penalty       (0.),
     beta          (0.),
@@ -127,12 +130,13 @@ public:
         filter = new MAST::Mesh::libMeshWrapper::GeometricFilter(*rho_sys, filter_r);
         eq_sys->reinit();
 
-        // create and attach the null space to the matrix
-        MAST::Physics::Elasticity::libMeshWrapper::NullSpace
-        null_sp(*sys, ModelType::dim, true);
+        // create and attach the null space to the matrix. This is also provided to
+        // the linear solver as the near-nullspace for algebraic multigrid.
+        null_sp = new MAST::Physics::Elasticity::libMeshWrapper::NullSpace
+        (*sys, ModelType::dim, true);
         
         Mat m = dynamic_cast<libMesh::PetscMatrix<real_t>*>(sys->matrix)->mat();
-        null_sp.attach_to_matrix(m);
+        null_sp->attach_to_matrix(m);
         
         eta      = input("heaviside_eta",
                          "Smoothed heaviside eta parameter", 0.5);
@@ -140,6 +144,8 @@ public:
     
     virtual ~InitExample() {
         
+        // the null space uses the communicator of the system
+        delete null_sp;
         delete eq_sys;
         delete mesh;
         delete model;
@@ -160,6 +166,7 @@ public:
     libMesh::NonlinearImplicitSystem            *sys;
     libMesh::ExplicitSystem                     *rho_sys;
     MAST::Mesh::libMeshWrapper::GeometricFilter *filter;
+    MAST::Physics::Elasticity::libMeshWrapper::NullSpace *null_sp;
     uint_t                                       p_side_id;
     real_t                                       penalty;
     real_t                                       beta;
@@ -242,7 +249,7 @@ struct Traits {
     using temp_t            = typename MAST::Optimization::Topology::SIMP::PenalizedScalar<SolScalarType, density_t>;
     using area_t            = typename MAST::Base::ScalarConstant<SolScalarType>;
     using prop_t            = typename MAST::Physics::Elasticity::IsotropicMaterialStiffness<SolScalarType, dim, modulus_t, nu_t, context_t>;
-    using energy_t          = typename MAST::Physics::Elasticity::LinearContinuum::StrainEnergy<fe_var_t, prop_t, dim, context_t>;
+    using energy_t          = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticStrainEnergy<fe_var_t, temp_t, alpha_t, prop_t, dim, context_t>;
     using press_load_t      = typename MAST::Physics::Elasticity::SurfacePressureLoad<fe_var_t, press_t, area_t, dim, context_t>;
     using temp_load_t       = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticLoad<fe_var_t, temp_t, alpha_t, prop_t, dim, context_t>;
     using element_vector_t  = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
@@ -354,6 +361,8 @@ public:
         _prop->set_modulus_and_nu(*E, *nu);
         _energy   = new typename TraitsType::energy_t;
         _energy->set_section_property(*_prop);
+        _energy->set_coeff_thermal_expansion(*alpha);
+        _energy->set_temperature(*dt);
         _p_load   = new typename TraitsType::press_load_t;
         _p_load->set_section_area(*area);
         _p_load->set_pressure(*press); 
@@ -415,7 +424,6 @@ public:
         _density_fe_var->init(c, density_v);
 
         _energy->compute(c, res, jac);
-        _temp_load->compute(c, res, jac);
         
         for (uint_t s=0; s<c.elem->n_sides(); s++)
             if (c.if_compute_pressure_load_on_side(s)) {
@@ -450,7 +458,6 @@ public:
         _density_sens_fe_var->init(c, density_sens);
 
         _energy->derivative(c, f, res, jac);
-        _temp_load->derivative(c, f, res, jac);
     }
 
     
@@ -486,6 +493,28 @@ public:
     }
 
     
+    // this method computes the thermoelastic load for an element. The strain operators
+    // are cached by the strain energy kernel, and the penalized stiffness and temperature
+    // are evaluated for the current density at each call.
+    template <typename ContextType,
+              typename Accessor1Type,
+              typename Accessor2Type>
+    inline void thermal_load(ContextType                           &c,
+                             const Accessor1Type                   &sol_v,
+                             const Accessor2Type                   &density_v,
+                             typename TraitsType::element_vector_t &res) {
+        
+        c.fe = &_sol_fe_data->fe_derivative();
+        _sol_fe_data->reinit(c);
+        _sol_fe_var->init(c, sol_v);
+        _density_fe_basis->reinit(*c.elem, _sol_fe_data->quadrature());
+        _density_fe_deriv->reinit(c);
+        _density_fe_var->init(c, density_v);
+        
+        _energy->temperature_load(c, *dt, res);
+    }
+    
+    
     // parameters
     typename TraitsType::heaviside_t  *heaviside;
     typename TraitsType::density_t    *density;
@@ -518,6 +547,38 @@ private:
 
 
 
+// element operations that only compute the thermoelastic load, so that the load can be
+// assembled without the stiffness matrix.
+template <typename TraitsType>
+class ThermalLoadElemOps {
+    
+public:
+    
+    using scalar_t  = typename TraitsType::scalar_t;
+    using vector_t  = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    using matrix_t  = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
+    
+    ThermalLoadElemOps(ElemOps<TraitsType> &e_ops): _e_ops(e_ops) { }
+    
+    template <typename ContextType,
+              typename Accessor1Type,
+              typename Accessor2Type>
+    inline void compute(ContextType                           &c,
+                        const Accessor1Type                   &sol_v,
+                        const Accessor2Type                   &density_v,
+                        typename TraitsType::element_vector_t &res,
+                        typename TraitsType::element_matrix_t *) {
+        
+        _e_ops.thermal_load(c, sol_v, density_v, res);
+    }
+    
+private:
+    
+    ElemOps<TraitsType> &_e_ops;
+};
+
+
+
 template <typename TraitsType>
 class FunctionEvaluation {
     
@@ -531,13 +592,36 @@ public:
     _e_ops        (e_ops),
     _c            (c),
     _dvs          (new MAST::Optimization::DesignParameterVector<scalar_t>(c.rho_sys->comm())),
+    _dv_map       (nullptr),
     _volume       (_c.ex_init.model->reference_volume(_c.ex_init)),
     _vf           (_c.ex_init.input("volume_fraction",
-                                    "upper limit for the volume fraction", 0.2)) {
+                                    "upper limit for the volume fraction", 0.2)),
+    _subspace     (_c.ex_init.input("recycled_subspace_size",
+                                    "number of previous solutions used for initial guess of linear solves", 10)),
+    _linear_solver(c.eq_sys->comm().get()),
+    _projected_density(*e_ops.heaviside),
+    _report_thermal   (_c.ex_init.input("temperature",
+                                        "temperature over domain", 0.) != 0.) {
+        
+        // optionally, the initial guess of each Krylov solve is computed from the
+        // previous solutions. This is not used with direct solvers.
+        if (_c.ex_init.input("recycled_subspace",
+                             "use previous solutions for initial guess of linear solves", false))
+            _linear_solver.set_recycled_subspace(&_subspace);
+        
+        // rigid-body modes used by smoothed aggregation multigrid, for example with
+        // -structural_pc_type gamg
+        _linear_solver.set_near_null_space(_c.ex_init.null_sp->get());
         
         // initialize the design variable vector
         _c.ex_init.model->init_simp_dvs(_c.ex_init, *_dvs);
         
+        // map from the design variables to the density dofs. The optimizer provides
+        // design variables and sensitivities replicated on all ranks.
+        _dv_map = new MAST::Optimization::Utility::DesignParameterMap<scalar_t>
+        (*_dvs, MAST::Optimization::Utility::DesignParameterMap<scalar_t>::REPLICATED);
+        _volume_calc.set_design_parameter_map(*_dv_map);
+        
         // open the file where the history will be stored
         _history.open("optim_history.txt", std::ostream::out);
     }
@@ -545,6 +629,7 @@ public:
     virtual ~FunctionEvaluation() {
         
         _history.close();
+        delete _dv_map;
         delete _dvs;
     }
     
@@ -601,45 +686,9 @@ public:
                           std::vector<bool>           &eval_grads,
                           std::vector<scalar_t>       &grads) {
 
-        std::cout << "New Evaluation" << std::endl;
-        
-        Assert2(x.size() == _dvs->size(),
-                x.size(), _dvs->size(),
-                "Incompatible design variable vector size.");
-
-        libMesh::ExplicitSystem
-        &str_sys = *_c.ex_init.sys,
-        &rho_sys = *_c.ex_init.rho_sys;
-
-        const uint_t
-        n_dofs          = str_sys.n_dofs(),
-        n_rho_vals      = rho_sys.n_dofs(),
-        first_local_rho = rho_sys.get_dof_map().first_dof(rho_sys.comm().rank()),
-        last_local_rho  = rho_sys.get_dof_map().end_dof(rho_sys.comm().rank());
-        
-        
-        std::unique_ptr<typename TraitsType::assembled_vector_t>
-        rho_base(_c.rho_sys->current_local_solution->clone().release()),
-        res(_c.sys->solution->clone().release());
-
-        // set a unit value for density. Values provided by design parameters
-        // will be overwritten in \p rho_base.
-        *rho_base = 1.;
-        
-
-        for (uint_t i=_dvs->local_begin(); i<_dvs->local_end(); i++)
-            rho_base->set(_dvs->get_data_for_parameter((*_dvs)[i]).template get<int>("dof_id"),
-                          x[i]);
-        rho_base->close();
-        
-        _c.ex_init.filter->compute_filtered_values
-        (dynamic_cast<libMesh::PetscVector<scalar_t>*>(rho_base.get())->vec(),
-         dynamic_cast<libMesh::PetscVector<scalar_t>*>(_c.rho_sys->solution.get())->vec());
-        _c.rho_sys->solution->close();
+        // the forward solve is reused if the last evaluation was at the same design
+        _forward_solve(x, obj, fvals);
         
-        // this will copy the solution to libMesh::System::current_local_soluiton
-        _c.rho_sys->update();
-
         //////////////////////////////////////////////////////////////////////
         // check to see if the sensitivity of constraint is requested
         //////////////////////////////////////////////////////////////////////
@@ -652,67 +701,9 @@ public:
         // subproblem solution                                                *
         //*********************************************************************
         
-        std::cout << "Static Solve" << std::endl;
-
-        MAST::Optimization::Topology::SIMP::libMeshWrapper::ResidualAndJacobian<scalar_t, ElemOps<TraitsType>>
-        assembly;
-        
-        assembly.set_elem_ops(_e_ops);
-        _c.sys->solution->zero();
-        
-        // this will copy the solution to libMesh::System::current_local_soluiton
-        _c.sys->update();
-        
-        // the residual is assembled as \f$ R(x) = K x - f \f$. Since \f$ x= 0 \f$ we have
-        // \f$ R(x) = - f \f$.
-        assembly.assemble(_c,
-                          *_c.sys->current_local_solution,
-                          *_c.rho_sys->current_local_solution,
-                          res.get(),
-                          _c.sys->matrix);
-        // We multiply with -1 before solving for \f$ x \f$.
-        res->scale(-1);
-        // This solves for \f$ x\f$ from the system of equations \f$ K x = f \f$.
-        Mat
-        m   = dynamic_cast<libMesh::PetscMatrix<real_t>*>(_c.sys->matrix)->mat();
-        Vec
-        b   = dynamic_cast<libMesh::PetscVector<real_t>*>(res.get())->vec(),
-        sol = dynamic_cast<libMesh::PetscVector<real_t>*>(_c.sys->solution.get())->vec();
-        
-        MAST::Solvers::PETScWrapper::LinearSolver
-        linear_solver(_c.eq_sys->comm().get());
-        linear_solver.init(m, &_c.sys->name());
-        linear_solver.solve(sol, b);
-
-        _c.sys->get_dof_map().enforce_constraints_exactly(*_c.sys, _c.sys->solution.get());
-
-        _c.sys->update();
-
-        // compliance is defined using the external work done \f$ c = x^T f \f$
-        scalar_t
-        vol    = 0.,
-        comp   = _c.sys->solution->dot(*res);
-        
-        //////////////////////////////////////////////////////////////////////
-        // evaluate the functions
-        //////////////////////////////////////////////////////////////////////
-        
-        // evaluate the volume for used in the problem setup
-        MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<scalar_t>
-        volume;
-        
-        vol = volume.compute(_c, *_c.rho_sys->current_local_solution,
-                             *_e_ops.heaviside);
-        std::cout << "volume: " << vol << std::endl;
-        
-        // evaluate the output based on specified problem type
-        //nonlinear_assembly.calculate_output(*_sys->current_local_solution, false, compliance);
-        //comp      = compliance.output_total();
-        obj       = comp;
-        fvals[0]  = vol/_volume - _vf; // vol/vol0 - a <=
-        std::cout << "compliance: " << comp << std::endl;
+        std::unique_ptr<typename TraitsType::assembled_vector_t>
+        res;
         
-
         //////////////////////////////////////////////////////////////////////
         // evaluate the objective sensitivities, if requested
         //////////////////////////////////////////////////////////////////////
@@ -723,6 +714,7 @@ public:
             compliance_sens;
             
             compliance_sens.set_elem_ops(_e_ops, _e_ops);
+            compliance_sens.set_design_parameter_map(*_dv_map);
 
             // the adjoint solution for compliance is the negative of displacement. We copy the
             // negative of solution in vector \p res.
@@ -758,17 +750,39 @@ public:
             // grad_k = dfi/dxj  ,  where k = j*NFunc + i
             //////////////////////////////////////////////////////////////////
 
-            volume.derivative(_c,
-                              *_c.rho_sys->current_local_solution,
-                              *_e_ops.heaviside,
-                              *_c.ex_init.filter,
-                              *_dvs,
-                              grads);
+            _volume_calc.derivative(_c,
+                                    _projected_density,
+                                    *_c.ex_init.filter,
+                                    grads);
             for (uint_t i=0; i<grads.size(); i++)
                 grads[i] /= _volume;
         }
     }
     
+    
+    /*!
+     * evaluates the objective and constraint functions only, without the adjoint solutions
+     * and sensitivity assembly. This is used for the trial points in the inner iterations
+     * of GCMMA. The forward solution is retained so that a subsequent call to
+     * \p evaluate() at the same design only computes the sensitivities.
+     */
+    inline void evaluate_values(const std::vector<scalar_t> &x,
+                                scalar_t                    &obj,
+                                std::vector<scalar_t>       &fvals) {
+        
+        _forward_solve(x, obj, fvals);
+    }
+    
+    
+    /*!
+     * clears the cached forward solution. This must be called if the analysis is changed
+     * without a change in design variables, for example, during continuation.
+     */
+    inline void clear_cache() {
+        
+        _x_cache.clear();
+    }
+    
     inline void output(const uint_t                iter,
                        const std::vector<real_t>  &dvars,
                        real_t                     &o,
@@ -779,16 +793,17 @@ public:
 
         if (iter%write_freq == 0) {
             
-            // pass all desntity values through the heaviside filter for plotting.
+            // the density values projected through the heaviside filter are
+            // written for plotting.
             for (uint_t i=_c.rho_sys->solution->first_local_index();
-                 i<_c.rho_sys->solution->last_local_index(); i++) {
-                
-                real_t v = _c.rho_sys->solution->el(i);
-                _c.rho_sys->solution->set(i, _e_ops.heaviside->filter(v));
-            }
+                 i<_c.rho_sys->solution->last_local_index(); i++)
+                _c.rho_sys->solution->set(i, _projected_density.values().el(i));
             _c.rho_sys->solution->close();
             _c.rho_sys->update();
             
+            // the density vector no longer corresponds to the cached forward solve
+            clear_cache();
+            
             std::ostringstream oss;
             oss << "output_optim.e-s." << std::setfill('0') << std::setw(5) << iter ;
             
@@ -810,12 +825,172 @@ public:
     
 private:
     
+    /*!
+     * computes the filtered density, the forward solution and the functions at \p x.
+     * These are not recomputed if \p x is the design of the last forward solve.
+     */
+    inline void _forward_solve(const std::vector<scalar_t> &x,
+                               scalar_t                    &obj,
+                               std::vector<scalar_t>       &fvals) {
+        
+        if (!_x_cache.empty() && x == _x_cache) {
+            
+            obj   = _obj_cache;
+            fvals = _fvals_cache;
+            return;
+        }
+        
+        std::cout << "New Evaluation" << std::endl;
+        
+        Assert2(x.size() == _dvs->size(),
+                x.size(), _dvs->size(),
+                "Incompatible design variable vector size.");
+
+        libMesh::ExplicitSystem
+        &str_sys = *_c.ex_init.sys,
+        &rho_sys = *_c.ex_init.rho_sys;
+
+        const uint_t
+        n_dofs          = str_sys.n_dofs(),
+        n_rho_vals      = rho_sys.n_dofs(),
+        first_local_rho = rho_sys.get_dof_map().first_dof(rho_sys.comm().rank()),
+        last_local_rho  = rho_sys.get_dof_map().end_dof(rho_sys.comm().rank());
+        
+        
+        std::unique_ptr<typename TraitsType::assembled_vector_t>
+        rho_base(_c.rho_sys->current_local_solution->clone().release()),
+        res(_c.sys->solution->clone().release());
+
+        // set a unit value for density. Values provided by design parameters
+        // will be overwritten in \p rho_base.
+        *rho_base = 1.;
+        
+        // copy the design variables to their density dofs
+        _dv_map->scatter(x, *rho_base);
+        
+        _c.ex_init.filter->compute_filtered_values
+        (dynamic_cast<libMesh::PetscVector<scalar_t>*>(rho_base.get())->vec(),
+         dynamic_cast<libMesh::PetscVector<scalar_t>*>(_c.rho_sys->solution.get())->vec());
+        _c.rho_sys->solution->close();
+        
+        // this will copy the solution to libMesh::System::current_local_soluiton
+        _c.rho_sys->update();
+        
+        // the projected density is computed once for this design and reused for the
+        // volume and its sensitivity
+        _projected_density.update(*_c.rho_sys->current_local_solution);
+
+        std::cout << "Static Solve" << std::endl;
+
+        MAST::Optimization::Topology::SIMP::libMeshWrapper::ResidualAndJacobian<scalar_t, ElemOps<TraitsType>>
+        assembly;
+        
+        assembly.set_elem_ops(_e_ops);
+        _c.sys->solution->zero();
+        
+        // this will copy the solution to libMesh::System::current_local_soluiton
+        _c.sys->update();
+        
+        // the residual is assembled as \f$ R(x) = K x - f \f$. Since \f$ x= 0 \f$ we have
+        // \f$ R(x) = - f \f$.
+        assembly.assemble(_c,
+                          *_c.sys->current_local_solution,
+                          *_c.rho_sys->current_local_solution,
+                          res.get(),
+                          _c.sys->matrix);
+        // We multiply with -1 before solving for \f$ x \f$.
+        res->scale(-1);
+        // This solves for \f$ x\f$ from the system of equations \f$ K x = f \f$.
+        Mat
+        m   = dynamic_cast<libMesh::PetscMatrix<real_t>*>(_c.sys->matrix)->mat();
+        Vec
+        b   = dynamic_cast<libMesh::PetscVector<real_t>*>(res.get())->vec(),
+        sol = dynamic_cast<libMesh::PetscVector<real_t>*>(_c.sys->solution.get())->vec();
+        
+        // the solver is retained across evaluations, and is setup again only if the
+        // matrix has changed. The same preconditioner is used for the adjoint solves.
+        _linear_solver.update_operators(m, &_c.sys->name());
+        _linear_solver.solve(sol, b);
+
+        _c.sys->get_dof_map().enforce_constraints_exactly(*_c.sys, _c.sys->solution.get());
+
+        _c.sys->update();
+
+        // compliance is defined using the external work done \f$ c = x^T f \f$
+        scalar_t
+        vol    = 0.,
+        comp   = _c.sys->solution->dot(*res);
+        
+        //////////////////////////////////////////////////////////////////////
+        // evaluate the functions
+        //////////////////////////////////////////////////////////////////////
+        
+        // evaluate the volume for used in the problem setup
+        vol = _volume_calc.compute(_c, _projected_density);
+        std::cout << "volume: " << vol << std::endl;
+        
+        // evaluate the output based on specified problem type
+        //nonlinear_assembly.calculate_output(*_sys->current_local_solution, false, compliance);
+        //comp      = compliance.output_total();
+        obj       = comp;
+        fvals[0]  = vol/_volume - _vf; // vol/vol0 - a <=
+        std::cout << "compliance: " << comp << std::endl;
+        
+        if (_report_thermal)
+            std::cout << "thermal compliance: " << _thermal_compliance() << std::endl;
+        
+        _x_cache     = x;
+        _obj_cache   = obj;
+        _fvals_cache = fvals;
+    }
+    
+    /*!
+     * @returns the contribution of the thermoelastic load to the compliance,
+     * \f$ x^T f_T \f$, for the current solution and density.
+     */
+    inline scalar_t _thermal_compliance() {
+        
+        ThermalLoadElemOps<TraitsType>
+        t_ops(_e_ops);
+        
+        MAST::Optimization::Topology::SIMP::libMeshWrapper::ResidualAndJacobian<scalar_t, ThermalLoadElemOps<TraitsType>>
+        assembly;
+        
+        assembly.set_elem_ops(t_ops);
+        
+        std::unique_ptr<typename TraitsType::assembled_vector_t>
+        f_t(_c.sys->solution->clone().release());
+        
+        typename TraitsType::assembled_matrix_t
+        *jac = nullptr;
+        
+        assembly.assemble(_c,
+                          *_c.sys->current_local_solution,
+                          *_c.rho_sys->current_local_solution,
+                          f_t.get(),
+                          jac);
+        
+        // the assembled residual contribution is \f$ -f_T \f$
+        return -_c.sys->solution->dot(*f_t);
+    }
+    
     ElemOps<TraitsType>                                 &_e_ops;
     context_t                                           &_c;
     MAST::Optimization::DesignParameterVector<scalar_t> *_dvs;
+    MAST::Optimization::Utility::DesignParameterMap<scalar_t> *_dv_map;
     real_t                                               _volume;
     real_t                                               _vf;
     std::ofstream                                        _history;
+    MAST::Solvers::PETScWrapper::RecycledSubspace        _subspace;
+    MAST::Solvers::PETScWrapper::LinearSolver            _linear_solver;
+    std::vector<scalar_t>                                _x_cache;
+    scalar_t                                             _obj_cache;
+    std::vector<scalar_t>                                _fvals_cache;
+    MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<scalar_t>
+                                                         _volume_calc;
+    MAST::Optimization::Topology::SIMP::libMeshWrapper::ProjectedDensity
+    <scalar_t, typename TraitsType::heaviside_t>        _projected_density;
+    bool                                                 _report_thermal;
 };
 } // namespace Example6
 } // namespace Structural
@@ -860,6 +1035,7 @@ void run(libMesh::LibMeshInit& init, MAST::Utility::GetPotWrapper& input) {
      
         e_ops.heaviside->set_parameters(c.ex_init.beta, c.ex_init.eta);
         e_ops.density->set_penalty(c.ex_init.penalty);
+        f_eval.clear_cache();
 
         optimizer.optimize();
     }
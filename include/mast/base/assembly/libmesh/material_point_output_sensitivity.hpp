@@ -117,13 +117,18 @@ public:
         el     = c.mesh->active_local_elements_begin(),
         end_el = c.mesh->active_local_elements_end();
         
+        uint_t
+        elem_idx = 0;
+        
         // first compute the sensitivity information assuming unfiltered
         // density variables.
-        for ( ; el != end_el; ++el) {
+        for ( ; el != end_el; ++el, ++elem_idx) {
             
-            // set element in the context, which will be used for
-            // the initialization routines
-            c.elem = *el;
+            // set element and its index in the local element range in the
+            // context, which will be used for the initialization routines and
+            // the material point index.
+            c.elem     = *el;
+            c.elem_idx = elem_idx;
             
             sol_accessor.init  (*c.elem);
             adj_accessor.init  (*c.elem);
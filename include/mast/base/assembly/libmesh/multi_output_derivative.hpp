@@ -0,0 +1,138 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef __mast_libmesh_multi_output_derivative_h__
+#define __mast_libmesh_multi_output_derivative_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+#include <mast/base/assembly/libmesh/utility.hpp>
+#include <mast/base/assembly/libmesh/accessor.hpp>
+#include <mast/numerics/utility.hpp>
+
+// libMesh includes
+#include <libmesh/nonlinear_implicit_system.h>
+#include <libmesh/dof_map.h>
+
+
+namespace MAST {
+namespace Base {
+namespace Assembly {
+namespace libMeshWrapper {
+
+/*!
+ * provides a method for global assembly of derivatives of multiple output functionals with
+ * respect to the solution vector in a single pass over the mesh. This is used to assemble
+ * the right-hand sides of multiple adjoint problems, for example for multiple load cases
+ * or stress aggregation regions, which can then be solved together with the same operator.
+ * The element operations provide
+ * \code
+ * derivativeX(c, sol_accessor, dqdX_e)
+ * \endcode
+ * where \p dqdX_e is a vector of element vectors, one for each output.
+ */
+template <typename ScalarType,
+          typename ElemOpsType>
+class MultiOutputDerivative {
+
+public:
+    
+    static_assert(std::is_same<ScalarType, typename ElemOpsType::scalar_t>::value,
+                  "Scalar type of assembly and element operations must be same");
+    
+    MultiOutputDerivative():
+    _e_ops        (nullptr)
+    { }
+    
+    virtual ~MultiOutputDerivative() { }
+        
+    inline void set_elem_ops(ElemOpsType& e_ops) { _e_ops = &e_ops; }
+
+    template <typename VecType, typename ContextType>
+    inline void assemble(ContextType            &c,
+                         const VecType          &X,
+                         std::vector<VecType*>  &dqdX) {
+        
+        Assert0(_e_ops, "Elem Operations not provided");
+        
+        for (uint_t i=0; i<dqdX.size(); i++)
+            MAST::Numerics::Utility::setZero(*dqdX[i]);
+        
+        // iterate over each element, initialize it and get the relevant
+        // analysis quantities
+        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
+        sol_accessor(*c.sys, X);
+
+        using elem_vector_t = typename ElemOpsType::vector_t;
+        
+        std::vector<elem_vector_t>
+        dqdX_e(dqdX.size());
+        
+        std::vector<libMesh::dof_id_type>
+        dof_indices;
+        
+        libMesh::MeshBase::const_element_iterator
+        el     = c.mesh->active_local_elements_begin(),
+        end_el = c.mesh->active_local_elements_end();
+        
+        for ( ; el != end_el; ++el) {
+            
+            // set element in the context, which will be used for the initialization routines
+            c.elem = *el;
+            
+            sol_accessor.init(*c.elem);
+            
+            for (uint_t i=0; i<dqdX_e.size(); i++)
+                dqdX_e[i].setZero(sol_accessor.n_dofs());
+            
+            // perform the element level calculations for all outputs
+            _e_ops->derivativeX(c, sol_accessor, dqdX_e);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc. The constraints may modify the
+            // dof indices, so a copy is used for each output.
+            for (uint_t i=0; i<dqdX_e.size(); i++) {
+                
+                dof_indices = sol_accessor.dof_indices();
+                
+                MAST::Base::Assembly::libMeshWrapper::constrain_and_add_vector
+                <ScalarType, VecType, elem_vector_t>
+                (*dqdX[i], c.sys->get_dof_map(), dof_indices, dqdX_e[i]);
+            }
+        }
+
+        // parallel matrix/vector require finalization of communication
+        for (uint_t i=0; i<dqdX.size(); i++)
+            MAST::Numerics::Utility::finalize(*dqdX[i]);
+    }
+    
+private:
+
+    ElemOpsType  *_e_ops;
+};
+
+} // namespace libMeshWrapper
+} // namespace Assembly
+} // namespace Base
+} // namespace MAST
+
+#endif // __mast_libmesh_multi_output_derivative_h__
@@ -42,8 +42,13 @@ class ResidualAndJacobian {
 
 public:
     
-    static_assert(std::is_same<ScalarType, typename ElemOpsType::scalar_t>::value,
-                  "Scalar type of assembly and element operations must be same");
+    using elem_scalar_t = typename ElemOpsType::scalar_t;
+    
+    // element operations may use a lower precision than the assembled quantities, in which
+    // case the element vector and matrix are cast to ScalarType before constraint and
+    // accumulation.
+    static_assert(MAST::IsAccumulableScalarType<elem_scalar_t, ScalarType>::value,
+                  "Scalar type of element operations must be accumulable in scalar type of assembly");
     
     ResidualAndJacobian():
     _finalize_jac (true),
@@ -55,7 +60,7 @@ public:
     inline void set_finalize_jac(bool f) { _finalize_jac = f;}
     
     inline void set_elem_ops(ElemOpsType& e_ops) { _e_ops = &e_ops; }
-
+    
     template <typename VecType, typename MatType, typename ContextType>
     inline void assemble(ContextType   &c,
                          const VecType &X,
@@ -68,10 +73,11 @@ public:
         if (J) MAST::Numerics::Utility::setZero(*J);
         
         // iterate over each element, initialize it and get the relevant
-        // analysis quantities
-        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
+        // analysis quantities. The solution is provided to the element operations in
+        // their own precision.
+        typename MAST::Base::Assembly::libMeshWrapper::Accessor<elem_scalar_t, VecType>
         sol_accessor(*c.sys, X);
-
+        
         using elem_vector_t = typename ElemOpsType::vector_t;
         using elem_matrix_t = typename ElemOpsType::matrix_t;
         
@@ -95,23 +101,12 @@ public:
             
             // perform the element level calculations
             _e_ops->compute(c, sol_accessor, res_e, J?&jac_e:nullptr);
-                        
-            // constrain the quantities to account for hanging dofs,
-            // Dirichlet constraints, etc.
-            if (R && J)
-                MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix_and_vector
-                <ScalarType, VecType, MatType, elem_vector_t, elem_matrix_t>
-                (*R, *J, c.sys->get_dof_map(), sol_accessor.dof_indices(), res_e, jac_e);
-            else if (R)
-                MAST::Base::Assembly::libMeshWrapper::constrain_and_add_vector
-                <ScalarType, VecType, elem_vector_t>
-                (*R, c.sys->get_dof_map(), sol_accessor.dof_indices(), res_e);
-            else
-                MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix
-                <ScalarType, MatType, elem_matrix_t>
-                (*J, c.sys->get_dof_map(), sol_accessor.dof_indices(), jac_e);
+            
+            _constrain_and_add(c.sys->get_dof_map(), sol_accessor.dof_indices(),
+                               R, J, res_e, jac_e,
+                               std::is_same<elem_scalar_t, ScalarType>());
         }
-
+        
         // parallel matrix/vector require finalization of communication
         if (R) MAST::Numerics::Utility::finalize(*R);
         if (J && _finalize_jac) MAST::Numerics::Utility::finalize(*J);
@@ -119,6 +114,59 @@ public:
     
 private:
 
+    /*!
+     * constrains the element quantities to account for hanging dofs, Dirichlet
+     * constraints, etc., and adds them to the assembled quantities.
+     */
+    template <typename VecType, typename MatType, typename SubVecType, typename SubMatType>
+    inline void _constrain_and_add(const libMesh::DofMap             &dof_map,
+                                   std::vector<libMesh::dof_id_type> &dof_indices,
+                                   VecType                           *R,
+                                   MatType                           *J,
+                                   SubVecType                        &res_e,
+                                   SubMatType                        &jac_e,
+                                   std::true_type) {
+        
+        if (R && J)
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix_and_vector
+            <ScalarType, VecType, MatType, SubVecType, SubMatType>
+            (*R, *J, dof_map, dof_indices, res_e, jac_e);
+        else if (R)
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_vector
+            <ScalarType, VecType, SubVecType>
+            (*R, dof_map, dof_indices, res_e);
+        else
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix
+            <ScalarType, MatType, SubMatType>
+            (*J, dof_map, dof_indices, jac_e);
+    }
+    
+    
+    /*!
+     * element quantities computed in a lower precision are explicitly cast to
+     * \p ScalarType, so that the constraints are applied and the global vector and
+     * matrix are accumulated in the precision of the assembly.
+     */
+    template <typename VecType, typename MatType, typename SubVecType, typename SubMatType>
+    inline void _constrain_and_add(const libMesh::DofMap             &dof_map,
+                                   std::vector<libMesh::dof_id_type> &dof_indices,
+                                   VecType                           *R,
+                                   MatType                           *J,
+                                   SubVecType                        &res_e,
+                                   SubMatType                        &jac_e,
+                                   std::false_type) {
+        
+        Eigen::Matrix<ScalarType, Eigen::Dynamic, 1>
+        res = res_e.template cast<ScalarType>();
+        
+        Eigen::Matrix<ScalarType, Eigen::Dynamic, Eigen::Dynamic>
+        jac;
+        
+        if (J) jac = jac_e.template cast<ScalarType>();
+        
+        _constrain_and_add(dof_map, dof_indices, R, J, res, jac, std::true_type());
+    }
+    
     bool         _finalize_jac;
     ElemOpsType  *_e_ops;
 };
@@ -71,10 +71,15 @@ public:
         el     = c.mesh->active_local_elements_begin(),
         end_el = c.mesh->active_local_elements_end();
         
-        for ( ; el != end_el; ++el) {
+        uint_t
+        elem_idx = 0;
+        
+        for ( ; el != end_el; ++el, ++elem_idx) {
             
-            // set element in the context, which will be used for the initialization routines
-            c.elem = *el;
+            // set element and its index in the local element range in the context, which
+            // will be used for the initialization routines and the material point index
+            c.elem     = *el;
+            c.elem_idx = elem_idx;
             
             sol_accessor.init(*c.elem);
                         
@@ -106,10 +111,15 @@ public:
         el     = c.mesh->active_local_elements_begin(),
         end_el = c.mesh->active_local_elements_end();
         
-        for ( ; el != end_el; ++el) {
+        uint_t
+        elem_idx = 0;
+        
+        for ( ; el != end_el; ++el, ++elem_idx) {
             
-            // set element in the context, which will be used for the initialization routines
-            c.elem = *el;
+            // set element and its index in the local element range in the context, which
+            // will be used for the initialization routines and the material point index
+            c.elem     = *el;
+            c.elem_idx = elem_idx;
             
             sol_accessor.init(*c.elem);
             dsol_accessor.init(*c.elem);
@@ -294,6 +294,197 @@ constrain_and_add_matrix(MatType                           &m,
 }
 
 
+template <typename ScalarType,
+          typename VecType,
+          typename MatType,
+          typename SubVecType,
+          typename SubMatType>
+inline
+typename std::enable_if<MAST::IsDual<ScalarType>::value, void>::type
+constrain_and_add_matrix_and_vector(VecType                           &v,
+                                    MatType                           &m,
+                                    const libMesh::DofMap             &dof_map,
+                                    std::vector<libMesh::dof_id_type> &dof_indices,
+                                    SubVecType                        &v_sub,
+                                    SubMatType                        &m_sub) {
+
+    Assert2(v_sub.size() == dof_indices.size(),
+            v_sub.size(), dof_indices.size(),
+            "Incompatible vector size");
+    Assert2(m_sub.rows() == dof_indices.size(),
+            m_sub.rows(), dof_indices.size(),
+            "Incompatible matrix rows");
+    Assert2(m_sub.cols() == dof_indices.size(),
+            m_sub.cols(), dof_indices.size(),
+            "Incompatible matrix columns");
+
+    const uint_t
+    n   = v_sub.size(),
+    n_d = ScalarType::n_derivatives();
+    
+    // the value and each derivative direction are independently constrained. Each
+    // uses its own copy of the dof indices, since the constraint may expand the
+    // indices and the element vector and matrix to include the constraining dofs.
+    libMesh::DenseVector<real_t>
+    v_val(n);
+    libMesh::DenseMatrix<real_t>
+    m_val(n, n);
+    std::vector<libMesh::DenseVector<real_t>>
+    v_d(n_d, libMesh::DenseVector<real_t>(n));
+    std::vector<libMesh::DenseMatrix<real_t>>
+    m_d(n_d, libMesh::DenseMatrix<real_t>(n, n));
+    std::vector<std::vector<libMesh::dof_id_type>>
+    dof_indices_d(n_d, dof_indices);
+
+    for (uint_t i=0; i<n; i++) {
+        
+        v_val(i) = v_sub(i).value();
+        for (uint_t k=0; k<n_d; k++) v_d[k](i) = v_sub(i).derivative(k);
+        
+        for (uint_t j=0; j<n; j++) {
+            
+            m_val(i, j) = m_sub(i, j).value();
+            for (uint_t k=0; k<n_d; k++) m_d[k](i, j) = m_sub(i, j).derivative(k);
+        }
+    }
+    
+    dof_map.constrain_element_matrix_and_vector(m_val, v_val, dof_indices);
+    for (uint_t k=0; k<n_d; k++) {
+        
+        dof_map.constrain_element_matrix_and_vector(m_d[k], v_d[k], dof_indices_d[k]);
+        Assert2(dof_indices_d[k].size() == dof_indices.size(),
+                dof_indices_d[k].size(), dof_indices.size(),
+                "Incompatible constrained dof indices");
+    }
+    
+    ScalarType
+    s;
+    
+    for (uint_t i=0; i<dof_indices.size(); i++) {
+        
+        s.value() = v_val(i);
+        for (uint_t k=0; k<n_d; k++) s.derivative(k) = v_d[k](i);
+        add_to_vector(v, dof_indices[i], s);
+
+        for (uint_t j=0; j<dof_indices.size(); j++) {
+            
+            s.value() = m_val(i, j);
+            for (uint_t k=0; k<n_d; k++) s.derivative(k) = m_d[k](i, j);
+            add_to_matrix(m, dof_indices[i], dof_indices[j], s);
+        }
+    }
+}
+
+
+template <typename ScalarType, typename VecType, typename SubVecType>
+inline
+typename std::enable_if<MAST::IsDual<ScalarType>::value, void>::type
+constrain_and_add_vector(VecType                           &v,
+                         const libMesh::DofMap             &dof_map,
+                         std::vector<libMesh::dof_id_type> &dof_indices,
+                         SubVecType                        &v_sub) {
+    
+    Assert2(v_sub.size() == dof_indices.size(),
+            v_sub.size(), dof_indices.size(),
+            "Incompatible vector size");
+
+    const uint_t
+    n   = v_sub.size(),
+    n_d = ScalarType::n_derivatives();
+    
+    // the value and each derivative direction are independently constrained, each
+    // with its own copy of the dof indices
+    libMesh::DenseVector<real_t>
+    v_val(n);
+    std::vector<libMesh::DenseVector<real_t>>
+    v_d(n_d, libMesh::DenseVector<real_t>(n));
+    std::vector<std::vector<libMesh::dof_id_type>>
+    dof_indices_d(n_d, dof_indices);
+    
+    for (uint_t i=0; i<n; i++) {
+        
+        v_val(i) = v_sub(i).value();
+        for (uint_t k=0; k<n_d; k++) v_d[k](i) = v_sub(i).derivative(k);
+    }
+    
+    dof_map.constrain_element_vector(v_val, dof_indices);
+    for (uint_t k=0; k<n_d; k++) {
+        
+        dof_map.constrain_element_vector(v_d[k], dof_indices_d[k]);
+        Assert2(dof_indices_d[k].size() == dof_indices.size(),
+                dof_indices_d[k].size(), dof_indices.size(),
+                "Incompatible constrained dof indices");
+    }
+    
+    ScalarType
+    s;
+    
+    for (uint_t i=0; i<dof_indices.size(); i++) {
+        
+        s.value() = v_val(i);
+        for (uint_t k=0; k<n_d; k++) s.derivative(k) = v_d[k](i);
+        add_to_vector(v, dof_indices[i], s);
+    }
+}
+
+
+template <typename ScalarType, typename MatType, typename SubMatType>
+inline
+typename std::enable_if<MAST::IsDual<ScalarType>::value, void>::type
+constrain_and_add_matrix(MatType                           &m,
+                         const libMesh::DofMap             &dof_map,
+                         std::vector<libMesh::dof_id_type> &dof_indices,
+                         SubMatType                        &m_sub) {
+    
+    Assert2(m_sub.rows() == dof_indices.size(),
+            m_sub.rows(), dof_indices.size(),
+            "Incompatible matrix rows");
+    Assert2(m_sub.cols() == dof_indices.size(),
+            m_sub.cols(), dof_indices.size(),
+            "Incompatible matrix columns");
+
+    const uint_t
+    n   = m_sub.rows(),
+    n_d = ScalarType::n_derivatives();
+    
+    // the value and each derivative direction are independently constrained, each
+    // with its own copy of the dof indices
+    libMesh::DenseMatrix<real_t>
+    m_val(n, n);
+    std::vector<libMesh::DenseMatrix<real_t>>
+    m_d(n_d, libMesh::DenseMatrix<real_t>(n, n));
+    std::vector<std::vector<libMesh::dof_id_type>>
+    dof_indices_d(n_d, dof_indices);
+    
+    for (uint_t i=0; i<n; i++)
+        for (uint_t j=0; j<n; j++) {
+            
+            m_val(i, j) = m_sub(i, j).value();
+            for (uint_t k=0; k<n_d; k++) m_d[k](i, j) = m_sub(i, j).derivative(k);
+        }
+    
+    dof_map.constrain_element_matrix(m_val, dof_indices);
+    for (uint_t k=0; k<n_d; k++) {
+        
+        dof_map.constrain_element_matrix(m_d[k], dof_indices_d[k]);
+        Assert2(dof_indices_d[k].size() == dof_indices.size(),
+                dof_indices_d[k].size(), dof_indices.size(),
+                "Incompatible constrained dof indices");
+    }
+    
+    ScalarType
+    s;
+    
+    for (uint_t i=0; i<dof_indices.size(); i++)
+        for (uint_t j=0; j<dof_indices.size(); j++) {
+            
+            s.value() = m_val(i, j);
+            for (uint_t k=0; k<n_d; k++) s.derivative(k) = m_d[k](i, j);
+            add_to_matrix(m, dof_indices[i], dof_indices[j], s);
+        }
+}
+
+
 inline void
 constrain_and_add_matrix_and_vector(libMesh::NumericVector<real_t>    &v,
                                     libMesh::SparseMatrix<real_t>     &m,
@@ -0,0 +1,360 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __mast_dual_h__
+#define __mast_dual_h__
+
+// C++ includes
+#include <array>
+#include <cmath>
+#include <ostream>
+#include <type_traits>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+
+
+namespace MAST {
+
+/*!
+ * Forward-mode dual number with \p N derivative directions. The value and each of
+ * the \p N directional derivatives are propagated through all arithmetic operations,
+ * so that a single evaluation of a templated kernel with \p Dual<N> as the scalar type
+ * provides sensitivities with respect to up to \p N parameters. Unlike the
+ * complex-step method, the derivatives are exact and do not require a perturbation
+ * step size.
+ *
+ * All operators and math functions are defined as friends of the class so that they
+ * are found only through argument-dependent lookup and do not hide the standard
+ * overloads for \p real_t within the \p MAST namespace.
+ */
+template <uint_t N>
+class Dual {
+
+public:
+
+    static_assert(N > 0, "Dual number must have at least one derivative direction");
+
+    using deriv_t = std::array<real_t, N>;
+
+    Dual(real_t v = 0.):
+    _v  (v) {
+
+        _d.fill(0.);
+    }
+
+    Dual(real_t v, const deriv_t& d):
+    _v  (v),
+    _d  (d)
+    { }
+
+    /*!
+     * @returns a dual number with value \p v and unit derivative in direction \p i .
+     * This is used to seed the independent variables of the computation.
+     */
+    static inline Dual variable(real_t v, uint_t i) {
+
+        Dual d(v);
+        d._d[i] = 1.;
+        return d;
+    }
+
+    static constexpr uint_t n_derivatives() { return N;}
+
+    inline real_t  value() const { return _v;}
+    inline real_t& value()       { return _v;}
+
+    inline real_t  derivative(uint_t i) const { return _d[i];}
+    inline real_t& derivative(uint_t i)       { return _d[i];}
+
+    inline const deriv_t& derivatives() const { return _d;}
+    inline deriv_t&       derivatives()       { return _d;}
+
+    /*!
+     * sets the derivative in direction \p i to unity and all other directions to zero
+     */
+    inline void seed(uint_t i) {
+
+        _d.fill(0.);
+        _d[i] = 1.;
+    }
+
+    inline Dual& operator+= (const Dual& b) {
+
+        _v += b._v;
+        for (uint_t i=0; i<N; i++) _d[i] += b._d[i];
+        return *this;
+    }
+
+    inline Dual& operator-= (const Dual& b) {
+
+        _v -= b._v;
+        for (uint_t i=0; i<N; i++) _d[i] -= b._d[i];
+        return *this;
+    }
+
+    inline Dual& operator*= (const Dual& b) {
+
+        for (uint_t i=0; i<N; i++) _d[i] = _d[i] * b._v + _v * b._d[i];
+        _v *= b._v;
+        return *this;
+    }
+
+    inline Dual& operator/= (const Dual& b) {
+
+        const real_t
+        inv = 1./b._v;
+
+        _v *= inv;
+        for (uint_t i=0; i<N; i++) _d[i] = (_d[i] - _v * b._d[i]) * inv;
+        return *this;
+    }
+
+    inline Dual& operator+= (real_t b) { _v += b; return *this;}
+    inline Dual& operator-= (real_t b) { _v -= b; return *this;}
+
+    inline Dual& operator*= (real_t b) {
+
+        _v *= b;
+        for (uint_t i=0; i<N; i++) _d[i] *= b;
+        return *this;
+    }
+
+    inline Dual& operator/= (real_t b) { return (*this) *= (1./b);}
+
+    //
+    // arithmetic operators
+    //
+    friend inline Dual operator+ (const Dual& a) { return a;}
+
+    friend inline Dual operator- (const Dual& a) {
+
+        Dual r(-a._v);
+        for (uint_t i=0; i<N; i++) r._d[i] = -a._d[i];
+        return r;
+    }
+
+    friend inline Dual operator+ (Dual a, const Dual& b) { return a += b;}
+    friend inline Dual operator+ (Dual a, real_t b)      { return a += b;}
+    friend inline Dual operator+ (real_t a, Dual b)      { return b += a;}
+
+    friend inline Dual operator- (Dual a, const Dual& b) { return a -= b;}
+    friend inline Dual operator- (Dual a, real_t b)      { return a -= b;}
+    friend inline Dual operator- (real_t a, const Dual& b) { return (-b) += a;}
+
+    friend inline Dual operator* (Dual a, const Dual& b) { return a *= b;}
+    friend inline Dual operator* (Dual a, real_t b)      { return a *= b;}
+    friend inline Dual operator* (real_t a, Dual b)      { return b *= a;}
+
+    friend inline Dual operator/ (Dual a, const Dual& b) { return a /= b;}
+    friend inline Dual operator/ (Dual a, real_t b)      { return a /= b;}
+    friend inline Dual operator/ (real_t a, const Dual& b) { return Dual(a) /= b;}
+
+    //
+    // comparison operators. These are based on the value of the numbers only.
+    //
+    friend inline bool operator== (const Dual& a, const Dual& b) { return a._v == b._v;}
+    friend inline bool operator!= (const Dual& a, const Dual& b) { return a._v != b._v;}
+    friend inline bool operator<  (const Dual& a, const Dual& b) { return a._v <  b._v;}
+    friend inline bool operator<= (const Dual& a, const Dual& b) { return a._v <= b._v;}
+    friend inline bool operator>  (const Dual& a, const Dual& b) { return a._v >  b._v;}
+    friend inline bool operator>= (const Dual& a, const Dual& b) { return a._v >= b._v;}
+
+    friend inline bool operator== (const Dual& a, real_t b) { return a._v == b;}
+    friend inline bool operator!= (const Dual& a, real_t b) { return a._v != b;}
+    friend inline bool operator<  (const Dual& a, real_t b) { return a._v <  b;}
+    friend inline bool operator<= (const Dual& a, real_t b) { return a._v <= b;}
+    friend inline bool operator>  (const Dual& a, real_t b) { return a._v >  b;}
+    friend inline bool operator>= (const Dual& a, real_t b) { return a._v >= b;}
+
+    friend inline bool operator== (real_t a, const Dual& b) { return a == b._v;}
+    friend inline bool operator!= (real_t a, const Dual& b) { return a != b._v;}
+    friend inline bool operator<  (real_t a, const Dual& b) { return a <  b._v;}
+    friend inline bool operator<= (real_t a, const Dual& b) { return a <= b._v;}
+    friend inline bool operator>  (real_t a, const Dual& b) { return a >  b._v;}
+    friend inline bool operator>= (real_t a, const Dual& b) { return a >= b._v;}
+
+    //
+    // math functions
+    //
+    friend inline Dual sqrt(const Dual& a) {
+
+        const real_t v = std::sqrt(a._v);
+        return _chain(a, v, (v != 0.)? 0.5/v : 0.);
+    }
+
+    friend inline Dual pow(const Dual& a, real_t b) {
+
+        if (b == 0.) return Dual(1.);
+
+        const real_t v = std::pow(a._v, b-1.);
+        return _chain(a, v * a._v, b * v);
+    }
+
+    friend inline Dual pow(real_t a, const Dual& b) {
+
+        const real_t v = std::pow(a, b._v);
+        return _chain(b, v, (a > 0.)? v * std::log(a) : 0.);
+    }
+
+    friend inline Dual pow(const Dual& a, const Dual& b) {
+
+        return exp(b * log(a));
+    }
+
+    friend inline Dual exp(const Dual& a) {
+
+        const real_t v = std::exp(a._v);
+        return _chain(a, v, v);
+    }
+
+    friend inline Dual log(const Dual& a) {
+
+        return _chain(a, std::log(a._v), 1./a._v);
+    }
+
+    friend inline Dual sin(const Dual& a) {
+
+        return _chain(a, std::sin(a._v), std::cos(a._v));
+    }
+
+    friend inline Dual cos(const Dual& a) {
+
+        return _chain(a, std::cos(a._v), -std::sin(a._v));
+    }
+
+    friend inline Dual tan(const Dual& a) {
+
+        const real_t v = std::tan(a._v);
+        return _chain(a, v, 1. + v * v);
+    }
+
+    friend inline Dual atan(const Dual& a) {
+
+        return _chain(a, std::atan(a._v), 1./(1. + a._v * a._v));
+    }
+
+    friend inline Dual sinh(const Dual& a) {
+
+        return _chain(a, std::sinh(a._v), std::cosh(a._v));
+    }
+
+    friend inline Dual cosh(const Dual& a) {
+
+        return _chain(a, std::cosh(a._v), std::sinh(a._v));
+    }
+
+    friend inline Dual tanh(const Dual& a) {
+
+        const real_t v = std::tanh(a._v);
+        return _chain(a, v, 1. - v * v);
+    }
+
+    friend inline Dual fabs(const Dual& a) { return (a._v < 0.)? -a : a;}
+    friend inline Dual abs (const Dual& a) { return (a._v < 0.)? -a : a;}
+    friend inline Dual abs2(const Dual& a) { return a * a;}
+
+    friend inline Dual max(const Dual& a, const Dual& b) { return (a._v < b._v)? b : a;}
+    friend inline Dual min(const Dual& a, const Dual& b) { return (b._v < a._v)? b : a;}
+
+    friend inline bool isfinite(const Dual& a) { return std::isfinite(a._v);}
+    friend inline bool isnan   (const Dual& a) { return std::isnan(a._v);}
+    friend inline bool isinf   (const Dual& a) { return std::isinf(a._v);}
+
+    friend inline std::ostream& operator<< (std::ostream& o, const Dual& a) {
+
+        o << a._v << " [";
+        for (uint_t i=0; i<N; i++) o << " " << a._d[i];
+        o << " ]";
+        return o;
+    }
+
+private:
+
+    /*!
+     * @returns dual number with value \p v and derivatives of \p a scaled by \p df .
+     */
+    static inline Dual _chain(const Dual& a, real_t v, real_t df) {
+
+        Dual r(v);
+        for (uint_t i=0; i<N; i++) r._d[i] = df * a._d[i];
+        return r;
+    }
+
+    real_t   _v;
+    deriv_t  _d;
+};
+
+
+template <typename ScalarType>
+struct IsDual: public std::false_type { };
+
+template <uint_t N>
+struct IsDual<MAST::Dual<N>>: public std::true_type { };
+
+
+template <uint_t N>
+struct DeducedScalarType<MAST::Dual<N>, real_t> { using type = MAST::Dual<N>;};
+
+template <uint_t N>
+struct DeducedScalarType<real_t, MAST::Dual<N>> { using type = MAST::Dual<N>;};
+
+template <uint_t N>
+struct DeducedScalarType<MAST::Dual<N>, MAST::Dual<N>> { using type = MAST::Dual<N>;};
+
+} // namespace MAST
+
+
+namespace Eigen {
+
+template <uint_t N>
+struct NumTraits<MAST::Dual<N>>: GenericNumTraits<MAST::Dual<N>> {
+
+    typedef MAST::Dual<N> Real;
+    typedef MAST::Dual<N> NonInteger;
+    typedef MAST::Dual<N> Nested;
+    typedef real_t        Literal;
+
+    enum {
+        IsComplex             = 0,
+        IsInteger             = 0,
+        IsSigned              = 1,
+        RequireInitialization = 1,
+        ReadCost              = N+1,
+        AddCost               = N+1,
+        MulCost               = 2*N+1
+    };
+
+    static inline Real epsilon()         { return NumTraits<real_t>::epsilon();}
+    static inline Real dummy_precision() { return NumTraits<real_t>::dummy_precision();}
+    static inline Real highest()         { return NumTraits<real_t>::highest();}
+    static inline Real lowest()          { return NumTraits<real_t>::lowest();}
+    static inline int  digits10()        { return NumTraits<real_t>::digits10();}
+};
+
+
+template <uint_t N, typename BinaryOp>
+struct ScalarBinaryOpTraits<MAST::Dual<N>, real_t, BinaryOp> { typedef MAST::Dual<N> ReturnType;};
+
+template <uint_t N, typename BinaryOp>
+struct ScalarBinaryOpTraits<real_t, MAST::Dual<N>, BinaryOp> { typedef MAST::Dual<N> ReturnType;};
+
+} // namespace Eigen
+
+#endif // __mast_dual_h__
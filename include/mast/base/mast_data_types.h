@@ -53,6 +53,15 @@ struct DeducedScalarType { };
 template <>
 struct DeducedScalarType<real_t, real_t> { using type = real_t;};
 
+template <>
+struct DeducedScalarType<float, float> { using type = float;};
+
+template <>
+struct DeducedScalarType<float, real_t> { using type = real_t;};
+
+template <>
+struct DeducedScalarType<real_t, float> { using type = real_t;};
+
 template <>
 struct DeducedScalarType<std::complex<real_t>, real_t> { using type = std::complex<real_t>;};
 
@@ -72,6 +81,22 @@ struct DeducedScalarType<real_t, adouble_tl_t> { using type = adouble_tl_t;};
 template <>
 struct DeducedScalarType<adouble_tl_t, adouble_tl_t> { using type = adouble_tl_t;};
 #endif
+
+
+/*!
+ * identifies if element quantities computed with \p ElemScalarType can be accumulated
+ * into global quantities of \p GlobalScalarType. This allows the basis tables, geometry
+ * and element matrices to be computed and stored in single precision while the assembled
+ * vectors and matrices, residual norms and sensitivities are kept in double precision.
+ */
+template <typename ElemScalarType, typename GlobalScalarType>
+struct IsAccumulableScalarType: public std::is_same<ElemScalarType, GlobalScalarType> { };
+
+template <>
+struct IsAccumulableScalarType<float, real_t>: public std::true_type { };
 }
 
+// forward-mode dual numbers
+#include <mast/base/dual.hpp>
+
 #endif // __mast__data_types__
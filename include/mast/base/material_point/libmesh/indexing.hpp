@@ -20,12 +20,16 @@
 #ifndef __mast_material_point_libmesh_indexing_h__
 #define __mast_material_point_libmesh_indexing_h__
 
+// C++ includes
+#include <unordered_map>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
 
 // libMesh includes
 #include <libmesh/mesh_base.h>
+#include <libmesh/elem.h>
 
 namespace MAST {
 namespace Base {
@@ -37,6 +41,13 @@ namespace libMeshWrapper {
  * IDs are numbered contiguously across processors. The IDs on rank 0 will be in range
  *  [0, num_local_elements_on_rank_0 * num_quadrature_pts_per_elem], and on rank 0 will be in range
  *  num_local_elements_on_rank_0 * num_quadrature_pts_per_elem + [0, num_local_elements_on_rank_1 * num_quadrature_pts_per_elem].
+ *
+ * Each local element is assigned an index in the order of the active local element range of the mesh, and
+ * offsets of the material points are stored as prefix-sums of the number of points per element. If all elements
+ * have the same number of points, the offset is computed as \p elem_local_index * \p n_points without touching
+ * the offset array. Loops over the active local elements should track the element index and use the
+ * index-based methods. The element-to-index map is a hash map over the local elements, so that its size
+ * does not depend on the range of element IDs, and is only used by the methods that take an element pointer.
  */
 class Indexing {
     
@@ -44,6 +55,7 @@ public:
       
     Indexing():
     _initialized    (false),
+    _if_uniform     (false),
     _mesh           (nullptr),
     _n_points       (0),
     _begin_local_id (0),
@@ -58,25 +70,152 @@ public:
         Assert0(_initialized, "Object must be initialized");
         return _end_local_id - _begin_local_id;
     }
-    
+
+    /*!
+     * @returns the number of active local elements indexed by this object
+     */
+    inline uint_t n_local_elems() const {
+        
+        Assert0(_initialized, "Object must be initialized");
+        return _elem_offset.size() - 1;
+    }
+
+    /*!
+     * initializes the index with \p n_points_per_elem quadrature points on all elements.
+     */
     inline void init(const libMesh::MeshBase &mesh, uint_t n_points_per_elem) {
         
         Assert0(!_initialized, "Object already initialized");
         
-        _mesh     = &mesh;
-        _n_points = n_points_per_elem;
+        _if_uniform = true;
+        _n_points   = n_points_per_elem;
+        
+        this->_init_elem_index(mesh, [n_points_per_elem](const libMesh::Elem&) { return n_points_per_elem; });
+    }
+
+    /*!
+     * initializes the index with number of points on each element provided by \p n_points, which should
+     * be a callable object with signature \p uint_t(const libMesh::Elem&).
+     */
+    template <typename NPointsFunc>
+    inline void init_with_points_per_elem(const libMesh::MeshBase &mesh, const NPointsFunc& n_points) {
+        
+        Assert0(!_initialized, "Object already initialized");
+        
+        this->_init_elem_index(mesh, n_points);
+        
+        // if all elements have the same number of points then the offsets can be computed without the
+        // offset array
+        const uint_t n_elems = this->n_local_elems();
+        
+        _if_uniform = true;
+        _n_points   = n_elems ? _elem_offset[1] : 0;
+        
+        for (uint_t i=0; i<n_elems && _if_uniform; i++)
+            _if_uniform = (_elem_offset[i+1] - _elem_offset[i] == _n_points);
+    }
+
+    /*!
+     * @returns the index of element \p e in the active local element range of the mesh.
+     */
+    inline uint_t elem_local_index(const libMesh::Elem *e) const {
+        
+        Assert0(_initialized, "Object must be initialized");
+        
+        std::unordered_map<libMesh::dof_id_type, uint_t>::const_iterator
+        it = _elem_index.find(e->id());
+        
+        Assert1(it != _elem_index.end(), e->id(), "Element not in index");
+        
+        return it->second;
+    }
+
+    /*!
+     * @returns the number of points on element with local index \p elem_idx
+     */
+    inline uint_t n_points_on_elem(uint_t elem_idx) const {
+        
+        Assert0(_initialized, "Object must be initialized");
+        Assert2(elem_idx < this->n_local_elems(), elem_idx, this->n_local_elems(),
+                "Invalid element index");
+
+        return _if_uniform ? _n_points : _elem_offset[elem_idx+1] - _elem_offset[elem_idx];
+    }
+
+    inline uint_t n_points_on_elem(const libMesh::Elem *e) const {
+        
+        return this->n_points_on_elem(this->elem_local_index(e));
+    }
+
+    /*!
+     * @returns the local ID of point \p i on element with local index \p elem_idx. This is
+     * useful for loops that iterate over the active local elements in the same order as
+     * the mesh and can track the element index without a lookup.
+     */
+    inline uint_t
+    local_id_for_point_on_elem(uint_t elem_idx,
+                               uint_t i) const {
+        
+        Assert0(_initialized, "Object must be initialized");
+        Assert2(i < this->n_points_on_elem(elem_idx), i, this->n_points_on_elem(elem_idx),
+                "Index must be less than points per element");
+        
+        return (_if_uniform ? elem_idx * _n_points : _elem_offset[elem_idx]) + i;
+    }
+
+    inline uint_t
+    local_id_for_point_on_elem(const libMesh::Elem *e,
+                               uint_t               i) const {
+        
+        return this->local_id_for_point_on_elem(this->elem_local_index(e), i);
+    }
+
+
+    inline uint_t
+    global_id_for_point_on_elem(uint_t elem_idx,
+                                uint_t i) const {
+        
+        return _begin_local_id + this->local_id_for_point_on_elem(elem_idx, i);
+    }
+
+    inline uint_t
+    global_id_for_point_on_elem(const libMesh::Elem *e,
+                                uint_t               i) const {
+        
+        return _begin_local_id + this->local_id_for_point_on_elem(e, i);
+    }
+
+private:
+
+    template <typename NPointsFunc>
+    inline void _init_elem_index(const libMesh::MeshBase &mesh, const NPointsFunc& n_points) {
+        
+        _mesh = &mesh;
         
         libMesh::MeshBase::const_element_iterator
         it   = mesh.active_local_elements_begin(),
         end  = mesh.active_local_elements_end();
         
+        uint_t
+        n_elems = mesh.n_active_local_elem();
+        
+        _elem_index.clear();
+        _elem_index.reserve(n_elems);
+        _elem_offset.resize(n_elems + 1);
+        _elem_offset[0] = 0;
+        
+        n_elems = 0;
+        
         for ( ; it != end; it++) {
             
             const libMesh::Elem* e = *it;
-            _elem_id_map[e] = _end_local_id;
-            _end_local_id  += n_points_per_elem;
+            _elem_index[e->id()]    = n_elems;
+            _elem_offset[n_elems+1] = _elem_offset[n_elems] + n_points(*e);
+            n_elems++;
         }
         
+        _end_local_id = _elem_offset[n_elems];
+        
         uint_t
         comm_rank = mesh.comm().rank(),
         comm_size = mesh.comm().size();
@@ -99,39 +238,21 @@ public:
         
         _initialized = true;
     }
-
-    inline uint_t
-    local_id_for_point_on_elem(const libMesh::Elem *e,
-                               uint_t               i) const {
-        
-        Assert0(_initialized, "Object must be initialized");
-        Assert2(i < _n_points, i, _n_points,
-                "Index must be less than points per element");
-        
-        std::map<const libMesh::Elem*, uint_t>::const_iterator
-        it  = _elem_id_map.find(e);
-        
-        Assert0( it != _elem_id_map.end(), "Element not in map");
-        
-        return it->second + i;
-    }
-
-
-    inline uint_t
-    global_id_for_point_on_elem(const libMesh::Elem *e,
-                                uint_t               i) const {
-        
-        return _begin_local_id + this->local_id_for_point_on_elem(e, i);
-    }
-
-private:
     
     bool                                    _initialized;
+    bool                                    _if_uniform;
     const libMesh::MeshBase                *_mesh;
     uint_t                                  _n_points;
     uint_t                                  _begin_local_id;
     uint_t                                  _end_local_id;
-    std::map<const libMesh::Elem*, uint_t>  _elem_id_map;
+    /*!
+     * local index of element, keyed on \p elem->id()
+     */
+    std::unordered_map<libMesh::dof_id_type, uint_t> _elem_index;
+    /*!
+     * prefix-sum of number of points on local elements, with \p n_local_elems+1 entries
+     */
+    std::vector<uint_t>                     _elem_offset;
 };
 
 }  // namespace libMeshWrapper
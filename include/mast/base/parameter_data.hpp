@@ -53,6 +53,23 @@ public:
         return _get_from_map<T>(nm, _get_map(T()));
     }
     
+    
+    template <typename T>
+    inline bool has(const std::string& nm) const {
+        
+        return _get_map(T()).count(nm);
+    }
+    
+    
+    /*!
+     * @returns the map of names to values of type \p T
+     */
+    template <typename T>
+    inline const std::map<const std::string, T>& data() const {
+        
+        return _get_map(T());
+    }
+    
 
 private:
 
@@ -20,6 +20,10 @@
 #ifndef __mast__libmesh_fe_h__
 #define __mast__libmesh_fe_h__
 
+// C++ includes
+#include <map>
+#include <utility>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
@@ -27,6 +31,7 @@
 
 // libMesh includes
 #include <libmesh/fe_base.h>
+#include <libmesh/elem.h>
 
 namespace MAST {
 
@@ -40,14 +45,18 @@ public:
 
     using scalar_t              = ScalarType;
     using fe_t                  = libMesh::FEBase;
-    using quadrature_t          = typename MAST::Quadrature::libMeshWrapper::Quadrature<ScalarType, Dim>;
-    using side_quadrature_t     = typename MAST::Quadrature::libMeshWrapper::Quadrature<ScalarType, Dim-1>;
+    // libMesh quadrature is implemented for real variables only, and the basis
+    // values are converted to ScalarType when copied from libMesh.
+    using quadrature_t          = typename MAST::Quadrature::libMeshWrapper::Quadrature<real_t, Dim>;
+    using side_quadrature_t     = typename MAST::Quadrature::libMeshWrapper::Quadrature<real_t, Dim-1>;
     using elem_t                = libMesh::Elem;
     using phi_vec_t             = typename Eigen::Map<const typename Eigen::Matrix<ScalarType, Eigen::Dynamic, 1>>;
     using dphi_dxi_vec_t        = typename Eigen::Map<const typename Eigen::Matrix<ScalarType, Eigen::Dynamic, 1>>;
+    using basis_matrix_t        = typename Eigen::Matrix<ScalarType, Eigen::Dynamic, Eigen::Dynamic>;
     static const uint_t dim     = Dim;
-    static_assert (std::is_same<scalar_t, double>::value,
-                   "Class only implemented for scalar type = double.");
+    static_assert (std::is_same<scalar_t, double>::value ||
+                   std::is_same<scalar_t, float>::value,
+                   "Class only implemented for scalar type = double or float.");
     
     FEBasis(fe_t& fe):
     _fe               (&fe),
@@ -56,7 +65,10 @@ public:
     _q                (nullptr),
     _q_side           (nullptr),
     _elem             (nullptr),
-    _side             (-1) {
+    _side             (-1),
+    _n_basis          (0),
+    _cache_q          (nullptr),
+    _ref_key          (libMesh::INVALID_ELEM, 0) {
         
         _fe->get_phi();
     }
@@ -68,7 +80,10 @@ public:
     _q                (nullptr),
     _q_side           (nullptr),
     _elem             (nullptr),
-    _side             (-1) {
+    _side             (-1),
+    _n_basis          (0),
+    _cache_q          (nullptr),
+    _ref_key          (libMesh::INVALID_ELEM, 0) {
         
         _fe->get_phi();
     }
@@ -85,6 +100,22 @@ public:
         
         _compute_dphi_dxi = f;
         _fe->get_JxW();
+
+        // cached values may not include the derivatives
+        _ref_values.clear();
+        _elem = nullptr;
+    }
+
+    /*!
+     * @returns true if the shape functions and their derivatives in the reference
+     * coordinate system depend only on the element type and p-level. This is the case
+     * for Lagrange basis, and the values are then computed once per element type,
+     * p-level and quadrature rule and reused for subsequent elements with the same
+     * type and p-level.
+     */
+    inline bool if_reference_values_cached() const {
+        
+        return _fe->get_fe_type().family == libMesh::LAGRANGE;
     }
 
     virtual inline uint_t n_q_points() const {
@@ -99,12 +130,56 @@ public:
         // reinitialize only if needed
         if (&e != _elem || &q != _q) {
             
+            if (this->if_reference_values_cached()) {
+                
+                // values cached for a different quadrature rule are not valid
+                if (&q != _cache_q) {
+                    
+                    _ref_values.clear();
+                    _cache_q = &q;
+                }
+                
+                const ref_values_key_t
+                key(e.type(), e.p_level());
+                
+                // the current values were computed for an element of same type and
+                // p-level with this quadrature rule and are reused without any computation.
+                // Since libMesh FE::reinit is skipped, the quadrature rule is initialized
+                // for the element type so that the number of points and weights correspond
+                // to this element. This is a no-op if the rule is already initialized for
+                // this element type and p-level.
+                if (&q == _q && _elem && _ref_key == key) {
+                    
+                    q.quadrature_object().init(e.type(), e.p_level());
+                    _elem = &e;
+                    return;
+                }
+                
+                typename std::map<ref_values_key_t, ReferenceValues>::const_iterator
+                it = _ref_values.find(key);
+                
+                if (it != _ref_values.end()) {
+                    
+                    q.quadrature_object().init(e.type(), e.p_level());
+                    _ref_key  = key;
+                    _q        = &q;
+                    _elem     = &e;
+                    _side     = -1;
+                    _q_side   = nullptr;
+                    _n_basis  = it->second.n_basis;
+                    _phi      = it->second.phi;
+                    _dphi_dxi = it->second.dphi_dxi;
+                    return;
+                }
+            }
+            
             _fe->attach_quadrature_rule(&q.quadrature_object());
             _fe->reinit(&e);
-            _q      = &q;
-            _elem   = &e;
-            _side   = -1;
-            _q_side = nullptr;
+            _q       = &q;
+            _elem    = &e;
+            _side    = -1;
+            _q_side  = nullptr;
+            _n_basis = _fe->n_shape_functions();
 
             _phi.setZero(this->n_basis(), this->n_q_points());
             
@@ -134,6 +209,17 @@ public:
             }
             else
                 _dphi_dxi.setZero();
+            
+            if (this->if_reference_values_cached()) {
+                
+                _ref_key = ref_values_key_t(e.type(), e.p_level());
+                
+                ReferenceValues
+                &v   = _ref_values[_ref_key];
+                v.n_basis  = _n_basis;
+                v.phi      = _phi;
+                v.dphi_dxi = _dphi_dxi;
+            }
         }
     }
 
@@ -149,10 +235,11 @@ public:
             _fe->attach_quadrature_rule(&q.quadrature_object());
             _fe->reinit(&e, s);
             
-            _q      = nullptr;
-            _elem   = &e;
-            _side   = s;
-            _q_side = &q;
+            _q       = nullptr;
+            _elem    = &e;
+            _side    = s;
+            _q_side  = &q;
+            _n_basis = _fe->n_shape_functions();
             
             _phi.setZero(this->n_basis(), this->n_q_points());
             
@@ -185,7 +272,7 @@ public:
         }
     }
 
-    inline uint_t n_basis() const { return _fe->n_shape_functions();}
+    inline uint_t n_basis() const { return _n_basis;}
     
     inline scalar_t qp_weight(uint_t qp) const {
 
@@ -232,6 +319,22 @@ public:
 
 private:
     
+    /*!
+     * element type and p-level for which the reference values are computed
+     */
+    using ref_values_key_t = std::pair<libMesh::ElemType, uint_t>;
+    
+    /*!
+     * shape function values and derivatives in reference coordinates for an element type
+     * and p-level
+     */
+    struct ReferenceValues {
+        
+        uint_t          n_basis;
+        basis_matrix_t  phi;
+        basis_matrix_t  dphi_dxi;
+    };
+    
     fe_t                                                      *_fe;
     bool                                                       _own_pointer;
     bool                                                       _compute_dphi_dxi;
@@ -241,6 +344,10 @@ private:
     uint_t                                                     _side;
     Eigen::Matrix<ScalarType, Eigen::Dynamic, Eigen::Dynamic>  _phi;
     Eigen::Matrix<ScalarType, Eigen::Dynamic, Eigen::Dynamic>  _dphi_dxi;
+    uint_t                                                     _n_basis;
+    const quadrature_t                                        *_cache_q;
+    ref_values_key_t                                           _ref_key;
+    std::map<ref_values_key_t, ReferenceValues>                _ref_values;
 };
 
 }  // namespace libMeshWrapper
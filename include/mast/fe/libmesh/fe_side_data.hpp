@@ -41,12 +41,14 @@ public:
     using fe_basis_t         = FEBasisType;
     using fe_shape_deriv_t   = FEDerivativeType;
     using scalar_t           = typename FEDerivativeType::scalar_t;
-    static_assert(std::is_same<FEBasisType, MAST::FEBasis::libMeshWrapper::FEBasis<real_t, Dim>>::value,
+    static_assert(std::is_same<FEBasisType,
+                  MAST::FEBasis::libMeshWrapper::FEBasis<typename FEBasisType::scalar_t, Dim>>::value,
                   "FEBasisType should be libMeshWrapper::FEBasis.");
     static_assert(std::is_same<FEBasisType, typename FEDerivativeType::fe_basis_t>::value,
                   "Different FEBasisType than that used for instantiation of FEDerivativeType.");
-    static_assert(std::is_same<typename FEDerivativeType::basis_scalar_t, real_t>::value,
-                  "basis_scalar_t for provided FEDerivativeType must be real_t.");
+    static_assert(std::is_same<typename FEDerivativeType::basis_scalar_t, real_t>::value ||
+                  std::is_same<typename FEDerivativeType::basis_scalar_t, float>::value,
+                  "basis_scalar_t for provided FEDerivativeType must be real_t or float.");
 
     FESideData():
     _initialized (false),
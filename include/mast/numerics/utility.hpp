@@ -74,6 +74,14 @@ real_norm(const VecType& v) {
 }
 
 
+template <typename VecType>
+inline typename
+std::enable_if<MAST::IsDual<typename Eigen::internal::traits<VecType>::Scalar>::value, real_t>::type
+real_norm(const VecType& v) {
+    return v.norm().value();
+}
+
+
 #if MAST_ENABLE_ADOLC == 1
 template <typename VecType>
 inline typename
@@ -113,6 +121,17 @@ real_minimum(const std::vector<complex_t> &vec) {
 }
 
 
+/*!
+ * computes minimum based on value of dual numbers
+ */
+template <uint_t N>
+inline MAST::Dual<N>
+real_minimum(const std::vector<MAST::Dual<N>> &vec) {
+    
+    return *std::min_element(vec.begin(), vec.end());
+}
+
+
 #if MAST_ENABLE_ADOLC == 1
 /*!
  * computes minimum based on value of variables
@@ -162,6 +181,17 @@ real_maximum(const std::vector<complex_t> &vec) {
 }
 
 
+/*!
+ * computes maximum based on value of dual numbers
+ */
+template <uint_t N>
+inline MAST::Dual<N>
+real_maximum(const std::vector<MAST::Dual<N>> &vec) {
+    
+    return *std::max_element(vec.begin(), vec.end());
+}
+
+
 #if MAST_ENABLE_ADOLC == 1
 /*!
  * computes maximum based on value of variables
@@ -456,6 +486,134 @@ comm_max(const libMesh::Parallel::Communicator &comm,
 }
 
 
+/*!
+ * sums the value and all derivatives of the dual number \p v in a single reduction
+ */
+template <uint_t N>
+inline void
+comm_sum(const libMesh::Parallel::Communicator& comm,
+         MAST::Dual<N>& v) {
+    
+    std::vector<real_t>
+    buf(N+1);
+    
+    buf[0] = v.value();
+    for (uint_t j=0; j<N; j++) buf[j+1] = v.derivative(j);
+    
+    comm.sum(buf);
+
+    v.value() = buf[0];
+    for (uint_t j=0; j<N; j++) v.derivative(j) = buf[j+1];
+}
+
+
+/*!
+ * sums the values and all derivatives of the dual numbers in \p v in a single reduction
+ */
+template <uint_t N>
+inline void
+comm_sum(const libMesh::Parallel::Communicator& comm,
+         std::vector<MAST::Dual<N>>& v) {
+    
+    std::vector<real_t>
+    buf(v.size()*(N+1));
+    
+    for (uint_t i=0; i<v.size(); i++) {
+        
+        buf[i*(N+1)] = v[i].value();
+        for (uint_t j=0; j<N; j++) buf[i*(N+1)+j+1] = v[i].derivative(j);
+    }
+    
+    comm.sum(buf);
+    
+    for (uint_t i=0; i<v.size(); i++) {
+        
+        v[i].value() = buf[i*(N+1)];
+        for (uint_t j=0; j<N; j++) v[i].derivative(j) = buf[i*(N+1)+j+1];
+    }
+}
+
+
+/*!
+ * broadcasts the value and derivatives of \p v from \p rank to all ranks.
+ */
+template <uint_t N>
+inline void
+comm_broadcast(const libMesh::Parallel::Communicator& comm,
+               MAST::Dual<N>&                         v,
+               uint_t                                 rank) {
+    
+    std::vector<real_t>
+    buf(N+1);
+    
+    buf[0] = v.value();
+    for (uint_t j=0; j<N; j++) buf[j+1] = v.derivative(j);
+    
+    comm.broadcast(buf, rank);
+
+    v.value() = buf[0];
+    for (uint_t j=0; j<N; j++) v.derivative(j) = buf[j+1];
+}
+
+
+/*!
+ * @returns the dual number with minimum value across all ranks, along with its derivatives
+ */
+template <uint_t N>
+inline MAST::Dual<N>
+comm_min(const libMesh::Parallel::Communicator &comm,
+         MAST::Dual<N>                          v) {
+    
+    real_t
+    v_min = v.value();
+    unsigned int
+    rank  = 0;
+    
+    comm.minloc(v_min, rank);
+    comm_broadcast(comm, v, rank);
+    
+    return v;
+}
+
+
+template <uint_t N>
+inline MAST::Dual<N>
+comm_min(const libMesh::Parallel::Communicator& comm,
+         const std::vector<MAST::Dual<N>>&      v) {
+    
+    return comm_min(comm, real_minimum(v));
+}
+
+
+/*!
+ * @returns the dual number with maximum value across all ranks, along with its derivatives
+ */
+template <uint_t N>
+inline MAST::Dual<N>
+comm_max(const libMesh::Parallel::Communicator &comm,
+         MAST::Dual<N>                          v) {
+    
+    real_t
+    v_max = v.value();
+    unsigned int
+    rank  = 0;
+    
+    comm.maxloc(v_max, rank);
+    comm_broadcast(comm, v, rank);
+    
+    return v;
+}
+
+
+template <uint_t N>
+inline MAST::Dual<N>
+comm_max(const libMesh::Parallel::Communicator& comm,
+         const std::vector<MAST::Dual<N>>&      v) {
+    
+    return comm_max(comm, real_maximum(v));
+}
+
+
 #if MAST_ENABLE_ADOLC == 1
 inline void
 comm_sum(const libMesh::Parallel::Communicator& comm,
@@ -0,0 +1,332 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __mast_optimization_discrete_aggregator_h__
+#define __mast_optimization_discrete_aggregator_h__
+
+// C++ includes
+#include <vector>
+#include <limits>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+
+// libMesh includes
+#include <libmesh/parallel.h>
+
+namespace MAST {
+namespace Optimization {
+namespace Aggregation {
+
+/*!
+ * Computes aggregated maximum, minimum or p-norm of the values in a vector, with the
+ * values optionally partitioned into independent regions that are aggregated together.
+ * The aggregation expressions for each region are
+ * \f[ v_{max} = M + \frac{1}{p} \log \left( \sum_i \exp (p (v_i - M))  \right) \f],
+ * \f[ v_{min} = M - \frac{1}{p} \log \left( \sum_i \exp (-p (v_i - M))  \right) \f],
+ * \f[ v_{p} = M \left( \sum_i \left( \frac{v_i}{M} \right)^p  \right)^{1/p} \f],
+ * where \f$ M \f$ is the maximum (or minimum for \p MINIMUM) value in the region. The
+ * p-norm assumes non-negative values. The aggregate of a region without values, and
+ * the p-norm of a region with only zero values, is zero.
+ *
+ * In \p compute() the shifts of all regions are combined across ranks with a maximum
+ * reduction, after which each rank computes the shifted sums of its local values and
+ * these are combined with a sum reduction. So, each rank communicates data only of the
+ * size of the number of regions. The shift and the sum are cached, so that the gradient
+ * with respect to all values and the sensitivity with respect to a parameter are
+ * obtained with a single pass over the values.
+ */
+template <typename ScalarType>
+class DiscreteAggregator {
+
+public:
+
+    enum Type { MAXIMUM, MINIMUM, P_NORM };
+
+    /*!
+     * \p comm is used to combine the values across ranks. If \p comm is a
+     * \p nullptr then all values are assumed to be local.
+     */
+    DiscreteAggregator(const libMesh::Parallel::Communicator *comm,
+                       Type                                   type,
+                       real_t                                 p):
+    _comm       (comm),
+    _type       (type),
+    _p          (p),
+    _n_regions  (1),
+    _computed   (false) {
+
+        Assert0(_p > 0., "Aggregation constant must be positive");
+    }
+
+    virtual ~DiscreteAggregator() { }
+
+    /*!
+     * partitions the values into \p n_regions independent regions. \p region_ids
+     * provides the region of each value passed to \p compute().
+     */
+    inline void set_regions(uint_t                     n_regions,
+                            const std::vector<uint_t> &region_ids) {
+
+        Assert0(n_regions > 0, "Number of regions must be positive");
+
+        _n_regions  = n_regions;
+        _region_ids = region_ids;
+        _computed   = false;
+    }
+
+    inline uint_t n_regions() const { return _n_regions;}
+
+    /*!
+     * computes and caches the aggregated value of \p vec for all regions.
+     */
+    inline void compute(const std::vector<ScalarType> &vec) {
+
+        Assert2(_region_ids.empty() || _region_ids.size() == vec.size(),
+                _region_ids.size(), vec.size(),
+                "Region ID must be provided for each value");
+
+        const real_t
+        sgn = (_type == MINIMUM)? -1. : 1.;
+
+        _shift.assign(_n_regions, std::numeric_limits<real_t>::lowest());
+        _denom.assign(_n_regions, ScalarType(0.));
+        _value.assign(_n_regions, ScalarType(0.));
+
+        // local shift for each region
+        for (uint_t i=0; i<vec.size(); i++) {
+
+            const uint_t r = _region(i);
+            _shift[r] = std::max(_shift[r], sgn * _real(vec[i]));
+        }
+
+        // the sums on all ranks use the shift of the region across all ranks
+        if (_comm && _comm->size() > 1) _comm->max(_shift);
+
+        // shifted sum for each region
+        for (uint_t i=0; i<vec.size(); i++)
+            _denom[_region(i)] += _term(vec[i], _shift[_region(i)], _p);
+
+        if (_comm && _comm->size() > 1) _sum(_denom);
+
+        for (uint_t r=0; r<_n_regions; r++) {
+
+            // empty regions, and p-norm of regions with only zero values
+            if (_real(_denom[r]) == 0.) continue;
+
+            switch (_type) {
+
+                case MAXIMUM:
+                case MINIMUM:
+                    _value[r] = sgn * (_shift[r] + log(_denom[r]) / _p);
+                    break;
+
+                case P_NORM:
+                    _value[r] = _shift[r] * pow(_denom[r], 1./_p);
+                    break;
+            }
+        }
+
+        _computed = true;
+    }
+
+    /*!
+     * @returns the aggregated value of region \p r from the last call to \p compute().
+     */
+    inline ScalarType value(uint_t r = 0) const {
+
+        Assert0(_computed, "Aggregated value must be computed first");
+        Assert2(r < _n_regions, r, _n_regions, "Invalid region");
+
+        return _value[r];
+    }
+
+    inline const std::vector<ScalarType>& values() const {
+
+        Assert0(_computed, "Aggregated value must be computed first");
+
+        return _value;
+    }
+
+    /*!
+     * computes the derivative of the aggregated value of each region with respect to
+     * the values in \p vec in \p grad, so that \p grad[i] is the derivative of the
+     * aggregate of the region of \p vec[i]. \p vec must be the same vector
+     * used in the last call to \p compute(). No communication is needed.
+     */
+    inline void gradient(const std::vector<ScalarType> &vec,
+                         std::vector<ScalarType>       &grad) const {
+
+        Assert0(_computed, "Aggregated value must be computed first");
+
+        grad.resize(vec.size());
+
+        for (uint_t i=0; i<vec.size(); i++)
+            grad[i] = _weight(vec[i], _region(i));
+    }
+
+    /*!
+     * computes the sensitivity of the aggregated value of all regions with respect to a
+     * parameter in \p dv, where \p dvec is the sensitivity of \p vec with respect to
+     * the parameter. The sums for all regions are combined in a single collective.
+     */
+    inline void sensitivity(const std::vector<ScalarType> &vec,
+                            const std::vector<ScalarType> &dvec,
+                            std::vector<ScalarType>       &dv) const {
+
+        Assert0(_computed, "Aggregated value must be computed first");
+        Assert2(vec.size() == dvec.size(), vec.size(), dvec.size(),
+                "Value and sensitivity vectors must have same size");
+
+        dv.assign(_n_regions, ScalarType(0.));
+
+        for (uint_t i=0; i<vec.size(); i++)
+            dv[_region(i)] += _weight(vec[i], _region(i)) * dvec[i];
+
+        if (_comm && _comm->size() > 1) _sum(dv);
+    }
+
+    /*!
+     * @returns the sensitivity of the aggregated value of the single region.
+     */
+    inline ScalarType sensitivity(const std::vector<ScalarType> &vec,
+                                  const std::vector<ScalarType> &dvec) const {
+
+        Assert1(_n_regions == 1, _n_regions, "Method valid only for a single region");
+
+        std::vector<ScalarType>
+        dv;
+
+        this->sensitivity(vec, dvec, dv);
+
+        return dv[0];
+    }
+
+private:
+
+    inline uint_t _region(uint_t i) const {
+
+        return _region_ids.empty()? 0 : _region_ids[i];
+    }
+
+    /*!
+     * @returns the contribution of value \p v to the shifted sum of a region with
+     * shift \p shift.
+     */
+    inline ScalarType _term(const ScalarType &v, real_t shift, real_t p) const {
+
+        switch (_type) {
+
+            case MAXIMUM:
+                return exp(p * (v - shift));
+
+            case MINIMUM:
+                return exp(-p * (v + shift));
+
+            case P_NORM:
+                // the shift is zero only if all values in the region are zero
+                if (shift <= 0.) return ScalarType(0.);
+                return pow(v / shift, p);
+        }
+
+        return ScalarType(0.);
+    }
+
+    /*!
+     * @returns the derivative of the aggregate of region \p r with respect to \p v.
+     */
+    inline ScalarType _weight(const ScalarType &v, uint_t r) const {
+
+        if (_real(_denom[r]) == 0.) return ScalarType(0.);
+
+        switch (_type) {
+
+            case MAXIMUM:
+            case MINIMUM:
+                return _term(v, _shift[r], _p) / _denom[r];
+
+            case P_NORM:
+                return _term(v, _shift[r], _p-1.) * pow(_denom[r], 1./_p - 1.);
+        }
+
+        return ScalarType(0.);
+    }
+
+    /*!
+     * sums \p v across all ranks, with the components of each value packed in a single
+     * buffer so that all regions are combined in one collective.
+     */
+    inline void _sum(std::vector<ScalarType> &v) const {
+
+        const uint_t
+        nc = _n_components(ScalarType());
+
+        std::vector<real_t>
+        buf(v.size() * nc, 0.);
+
+        for (uint_t r=0; r<v.size(); r++) _pack(&buf[r*nc], v[r]);
+        _comm->sum(buf);
+        for (uint_t r=0; r<v.size(); r++) _unpack(&buf[r*nc], v[r]);
+    }
+
+    static inline real_t _real(const real_t &v) { return v;}
+    static inline real_t _real(const complex_t &v) { return v.real();}
+    template <uint_t N>
+    static inline real_t _real(const MAST::Dual<N> &v) { return v.value();}
+
+    static inline uint_t _n_components(const real_t &) { return 1;}
+    static inline uint_t _n_components(const complex_t &) { return 2;}
+    template <uint_t N>
+    static inline uint_t _n_components(const MAST::Dual<N> &) { return N+1;}
+
+    static inline void _pack(real_t *b, const real_t &v) { b[0] = v;}
+    static inline void _pack(real_t *b, const complex_t &v) { b[0] = v.real(); b[1] = v.imag();}
+    template <uint_t N>
+    static inline void _pack(real_t *b, const MAST::Dual<N> &v) {
+
+        b[0] = v.value();
+        for (uint_t i=0; i<N; i++) b[i+1] = v.derivative(i);
+    }
+
+    static inline void _unpack(const real_t *b, real_t &v) { v = b[0];}
+    static inline void _unpack(const real_t *b, complex_t &v) { v = complex_t(b[0], b[1]);}
+    template <uint_t N>
+    static inline void _unpack(const real_t *b, MAST::Dual<N> &v) {
+
+        v.value() = b[0];
+        for (uint_t i=0; i<N; i++) v.derivative(i) = b[i+1];
+    }
+
+    const libMesh::Parallel::Communicator *_comm;
+    Type                                   _type;
+    real_t                                 _p;
+    uint_t                                 _n_regions;
+    bool                                   _computed;
+    std::vector<uint_t>                    _region_ids;
+    std::vector<real_t>                    _shift;
+    std::vector<ScalarType>                _denom;
+    std::vector<ScalarType>                _value;
+};
+
+} // Aggregation
+} // Optimization
+} // MAST
+
+#endif // __mast_optimization_discrete_aggregator_h__
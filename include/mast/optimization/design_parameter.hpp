@@ -35,13 +35,51 @@ public:
     
     DesignParameter(ScalarType v = 0.):
     MAST::Base::ScalarConstant<ScalarType>  (v),
-    _id    (-1) {
+    _id    (-1),
+    _v     (&MAST::Base::ScalarConstant<ScalarType>::operator()()) {
 
         _point.setZero();
     }
     
+    DesignParameter(const DesignParameter<ScalarType>&) = delete;
+    
+    DesignParameter<ScalarType>& operator= (const DesignParameter<ScalarType>&) = delete;
+    
     virtual ~DesignParameter() { }
 
+    inline ScalarType& operator= (const ScalarType& v) {
+        *_v = v;
+        return *_v;
+    }
+
+    inline ScalarType& operator() () {
+        return *_v;
+    }
+
+    inline ScalarType operator() () const {
+        return *_v;
+    }
+
+    template <typename ContextType>
+    inline ScalarType value(ContextType& /*c*/) const {
+        return *_v;
+    }
+
+    template <typename ContextType>
+    inline void value(ContextType& /*c*/, ScalarType& v) const {
+        v = *_v;
+    }
+
+    /*!
+     * copies the current value to \p v, which is then used to store the value of this
+     * parameter. This allows a \p DesignParameterVector to keep the values of its
+     * parameters in a contiguous array. \p v must outlive this parameter.
+     */
+    inline void set_storage(ScalarType& v) {
+        v  = *_v;
+        _v = &v;
+    }
+
     inline void set_id(uint_t i) { _id = i;}
 
     inline uint_t id() const { return _id;}
@@ -62,6 +100,9 @@ private:
     // ID of the design parameter
     uint_t                        _id;
     
+    /// storage of the value, which is in the base class unless set by \p set_storage()
+    ScalarType                   *_v;
+    
     /// point to which this parameter is attached
     Eigen::Matrix<real_t, 3, 1>  _point;
 };
@@ -20,6 +20,12 @@
 #ifndef __mast_optimization_design_parameter_vector_h__
 #define __mast_optimization_design_parameter_vector_h__
 
+// C++ includes
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
@@ -34,6 +40,15 @@ namespace MAST {
 namespace Optimization {
 
 
+/*!
+ * Stores the design parameters that are local to this rank, along with the ghosted
+ * parameters that are needed by this rank. After \p synchronize() the parameters are
+ * also stored in a flat layout: the local parameters in the order of their IDs followed
+ * by the ghosted parameters in the order of their IDs. The values, global IDs, dof IDs
+ * and the \p ParameterData fields of the parameters are stored in arrays with the same
+ * layout, so that loops over the parameters do not require any map or string lookups.
+ * The parameter objects use the array of values as storage for their values.
+ */
 template <typename ScalarType>
 class DesignParameterVector {
     
@@ -43,7 +58,8 @@ public:
     
 
     DesignParameterVector(const libMesh::Parallel::Communicator  &comm):
-    _comm    (comm)
+    _comm              (comm),
+    _first_local_dof   (0)
     { }
     
     
@@ -70,6 +86,9 @@ public:
     }
     
     
+    inline const libMesh::Parallel::Communicator& comm() const { return _comm;}
+    
+    
     inline uint_t size() const {
         
         Assert0(_rank_begin_index.size(),
@@ -100,12 +119,7 @@ public:
     inline MAST::Optimization::DesignParameter<ScalarType>&
     operator[](uint_t i) {
         
-        typename std::map<uint_t, MAST::Optimization::DesignParameter<ScalarType>*>::iterator
-        it   = _parameters.find(i);
-        
-        Assert0(it != _parameters.end(), "Invalid parameter index for rank");
-
-        return *it->second;
+        return *_flat_params[_flat_index(i)];
     }
 
     
@@ -113,12 +127,84 @@ public:
     inline const MAST::Optimization::DesignParameter<ScalarType>&
     operator[](uint_t i) const {
 
-        typename std::map<uint_t, MAST::Optimization::DesignParameter<ScalarType>*>::const_iterator
-        it   = _parameters.find(i);
+        return *_flat_params[_flat_index(i)];
+    }
+    
+    
+    /*!
+     * @returns the number of ghosted parameters on this rank
+     */
+    inline uint_t n_ghosted() const {
         
-        Assert0(it != _parameters.end(), "Invalid parameter index for rank");
-
-        return *it->second;
+        return _flat_ids.size() - (local_end() - local_begin());
+    }
+    
+    
+    /*!
+     * @returns the values of the parameters in the flat layout, with the local parameters
+     * followed by the ghosted parameters.
+     */
+    inline const std::vector<ScalarType>& flat_values() const {
+        
+        return _flat_values;
+    }
+    
+    
+    /*!
+     * @returns the values of the parameters in the flat layout. The size of the vector
+     * must not be changed, since the parameters store their values in it.
+     */
+    inline std::vector<ScalarType>& flat_values() {
+        
+        return _flat_values;
+    }
+    
+    
+    /*!
+     * @returns the global IDs of the parameters in the flat layout.
+     */
+    inline const std::vector<uint_t>& flat_ids() const {
+        
+        return _flat_ids;
+    }
+    
+    
+    /*!
+     * @returns the dof IDs of the parameters in the flat layout. The ID is
+     * \p invalid_dof_id for parameters that were not added as topology parameters.
+     */
+    inline const std::vector<uint_t>& flat_dof_ids() const {
+        
+        return _flat_dof_ids;
+    }
+    
+    
+    /*!
+     * @returns the dof ID of the topology parameter with ID \p i
+     */
+    inline uint_t dof_id(uint_t i) const {
+        
+        return _flat_dof_ids[_flat_index(i)];
+    }
+    
+    
+    /*!
+     * copies the field \p nm of the parameter data of all local parameters into \p v,
+     * in the order of the parameter IDs. Only fields defined for all parameters when
+     * the vector was synchronized are available.
+     */
+    template <typename T>
+    inline void get_local_field(const std::string& nm, std::vector<T>& v) const {
+        
+        const std::map<std::string, std::vector<T>>
+        &fields = _get_fields(T());
+        
+        typename std::map<std::string, std::vector<T>>::const_iterator
+        it   = fields.find(nm);
+        
+        Assert0(it != fields.end(), "Field not defined for all parameters: " + nm);
+        
+        v.assign(it->second.begin(), it->second.begin() + (local_end() - local_begin()));
     }
 
     
@@ -130,13 +216,12 @@ public:
 
     inline uint_t get_dv_id_for_topology_dof(const uint_t id) const {
     
-        std::map<uint_t, uint_t>::const_iterator
-        it  = _dof_id_to_dv_id_map.find(id);
+        const int_t
+        k = _flat_index_for_dof(id);
         
-        Assert1(it != _dof_id_to_dv_id_map.end(),
-                id, "dof ID not in this vector");
+        Assert1(k >= 0, id, "dof ID not in this vector");
         
-        return it->second;
+        return _flat_ids[k];
     }
     
     
@@ -144,14 +229,14 @@ public:
     inline bool
     is_design_parameter_dof_id(const uint_t i) const {
         
-        return _dof_id_to_dv_id_map.count(i);
+        return _flat_index_for_dof(i) >= 0;
     }
 
 
     inline bool
     is_design_parameter_index(const uint_t i) const {
         
-        return _dv_index.count(i);
+        return _flat_index_for_dof(i) >= 0;
     }
     
 
@@ -202,7 +287,6 @@ public:
         _data[&p] = d;
 
         d->add<int>("dof_id") = id;
-        _dv_index.insert(id);
 
         return *d;
     }
@@ -225,7 +309,6 @@ public:
         _data[&p] = d;
 
         d->add<int>("dof_id") = id;
-        _dv_index.insert(id);
         
         return *d;
     }
@@ -294,12 +377,21 @@ public:
         std::map<uint_t, MAST::Optimization::DesignParameter<ScalarType>*>
         dof_to_ghost_param_map;
         
+        std::vector<uint_t>
+        local_dof_ids(_local_parameters.size());
+        
         for (uint_t i=0; i<_local_parameters.size(); i++) {
             
             dof_id = this->get_data_for_parameter(*_local_parameters[i]).template get<int>("dof_id");
             _local_parameters[i]->set_id(_rank_begin_index[_comm.rank()]+i);
-            _dof_id_to_dv_id_map[dof_id] = _local_parameters[i]->id();
+            local_dof_ids[i] = dof_id;
         }
+        
+        // the local parameters are placed first in the flat layout in the order of
+        // their IDs. So, the dof index of the local parameters identifies the IDs of the
+        // parameters requested by other ranks. This is recreated for all parameters by
+        // _init_flat_storage().
+        _init_dof_index(dof_map, local_dof_ids);
             
         
         // ghosted dofs indices needed from each rank
@@ -318,22 +410,21 @@ public:
             ghosted_indices_on_rank_send[owner].push_back(dof_id);
         }
         
+        // the number of indices requested by each rank from this rank is obtained
+        // so that messages are exchanged only between ranks that share parameters.
+        std::vector<uint_t>
+        n_requested(_comm.size(), 0);
+        
+        for (uint_t i=0; i<_comm.size(); i++)
+            n_requested[i] = ghosted_indices_on_rank_send[i].size();
+        
+        _comm.alltoall(n_requested);
+        
+        for (uint_t i=0; i<_comm.size(); i++)
+            ghosted_indices_on_rank_recv[i].resize(n_requested[i]);
+        
         // now ask respective processors for the indices
-        for (uint_t i=0; i<_comm.size(); i++) {
-            
-            for (uint_t j=0; j<_comm.size(); j++) {
-                
-                if ( i != j) {
-                    
-                    // send to the j^th processor if it is my turn,
-                    // else, receive from the ith processor
-                    if (i == _comm.rank())
-                        _comm.send(j, ghosted_indices_on_rank_send[j]);
-                    else if (j == _comm.rank())
-                        _comm.receive(i, ghosted_indices_on_rank_recv[i]);
-                }
-            }
-        }
+        _exchange(ghosted_indices_on_rank_send, ghosted_indices_on_rank_recv);
         
         // now that we have received all the dof indices, we are going to send
         // back to the respective processor the DV id that corresponds to the
@@ -357,53 +448,32 @@ public:
                         "Requested dof does not belong to this processor");
                 
                 // now identify the DV Id number for these dofs
-                std::map<uint_t, uint_t>::const_iterator
-                it  = _dof_id_to_dv_id_map.find(ghosted_indices_on_rank_recv[i][k]);
+                const int_t
+                idx = _flat_index_for_dof(ghosted_indices_on_rank_recv[i][k]);
                 
-                Assert0(it != _dof_id_to_dv_id_map.end(),
+                Assert1(idx >= 0, ghosted_indices_on_rank_recv[i][k],
                         "No DV Id found for this dof id");
                 
-                ghosted_indices_on_rank_recv[i][k] = it->second;
+                ghosted_indices_on_rank_recv[i][k] = _rank_begin_index[_comm.rank()] + idx;
             }
         }
         
         // now we communicate this information back to the processors
+        for (uint_t i=0; i<_comm.size(); i++)
+            ghosted_dv_id_on_rank_recv[i].resize(ghosted_indices_on_rank_send[i].size());
+        
+        _exchange(ghosted_indices_on_rank_recv, ghosted_dv_id_on_rank_recv);
+        
         for (uint_t i=0; i<_comm.size(); i++) {
             
-            for (uint_t j=0; j<_comm.size(); j++) {
+            uint_t
+            dv_id  = 0;
+            
+            for (uint_t k=0; k<ghosted_dv_id_on_rank_recv[i].size(); k++) {
                 
-                if (( i == _comm.rank() && ghosted_indices_on_rank_recv[j].size()) ||
-                    ( j == _comm.rank() && ghosted_indices_on_rank_send[i].size())) {
-                    
-                    // send to the i^th processor if it is my turn,
-                    // else, receive from the j^th processor
-                    if (i == _comm.rank())
-                        _comm.send(j, ghosted_indices_on_rank_recv[j]);
-                    else if (j == _comm.rank()) {
-                        
-                        _comm.receive(i, ghosted_dv_id_on_rank_recv[i]);
-
-                        Assert2(ghosted_indices_on_rank_send[i].size() ==
-                                ghosted_dv_id_on_rank_recv[i].size(),
-                                ghosted_indices_on_rank_send[i].size(),
-                                ghosted_dv_id_on_rank_recv[i].size(),
-                                "Dof and DV ID map sizes must be same");
-                        
-                        uint_t
-                        dof_id = 0,
-                        dv_id  = 0;
-                        
-                        for (uint_t k=0; k<ghosted_dv_id_on_rank_recv[i].size(); k++) {
-
-                            dof_id = ghosted_indices_on_rank_send[i][k];
-                            dv_id  = ghosted_dv_id_on_rank_recv[i][k];
-                            dof_to_ghost_param_map[dof_id]->set_id(dv_id);
-                            
-                            // also store this information in the map
-                            _dof_id_to_dv_id_map[dof_id] = dv_id;
-                        }
-                    }
-                }
+                dof_id = ghosted_indices_on_rank_send[i][k];
+                dv_id  = ghosted_dv_id_on_rank_recv[i][k];
+                dof_to_ghost_param_map[dof_id]->set_id(dv_id);
             }
         }
         
@@ -414,24 +484,399 @@ public:
         for (uint_t i=0; i<_ghosted_parameters.size(); i++)
             _parameters[_ghosted_parameters[i]->id()] = _ghosted_parameters[i];
 
+        _init_flat_storage(dof_map);
+        _init_ghost_communication(ghosted_indices_on_rank_recv, ghosted_dv_id_on_rank_recv);
         
         // we don't need these any more, so we clear them.
         _local_parameters.clear();
         _ghosted_parameters.clear();
     }
     
+    /*!
+     * updates the values of ghosted parameters from the values of the parameters on
+     * their owning ranks. Messages are exchanged only with ranks that share parameters
+     * with this rank, and the buffers are reused for all updates.
+     */
+    inline void synchronize_ghost_values() {
+        
+        synchronize_ghost_values_begin();
+        synchronize_ghost_values_end();
+    }
+    
+    
+    /*!
+     * starts the update of ghosted parameter values with nonblocking receives and sends.
+     * The values of the local parameters are copied to the send buffers before this
+     * returns, so local work that does not read the ghosted values can be done before
+     * the matching call to \p synchronize_ghost_values_end().
+     */
+    inline void synchronize_ghost_values_begin() {
+        
+        Assert0(_rank_begin_index.size(),
+                "Data must be synchronized before update of ghost values");
+        Assert0(_ghost_requests.empty(), "Ghost value update already in progress");
+        
+        for (uint_t i=0; i<_ghost_recv_ranks.size(); i++) {
+            
+            _ghost_requests.push_back(libMesh::Parallel::Request());
+            _comm.receive(_ghost_recv_ranks[i],
+                          _ghost_recv_buffers[i],
+                          _ghost_requests.back(),
+                          _ghost_tag);
+        }
+        
+        for (uint_t i=0; i<_ghost_send_ranks.size(); i++) {
+            
+            const std::vector<uint_t>
+            &idx = _ghost_send_indices[i];
+            std::vector<ScalarType>
+            &buf = _ghost_send_buffers[i];
+            
+            for (uint_t k=0; k<idx.size(); k++)
+                buf[k] = _flat_values[idx[k]];
+            
+            _ghost_requests.push_back(libMesh::Parallel::Request());
+            _comm.send(_ghost_send_ranks[i],
+                       buf,
+                       _ghost_requests.back(),
+                       _ghost_tag);
+        }
+    }
+    
+    
+    /*!
+     * completes the receives started by \p synchronize_ghost_values_begin() and copies
+     * the received values to the ghosted parameters.
+     */
+    inline void synchronize_ghost_values_end() {
+        
+        libMesh::Parallel::wait(_ghost_requests);
+        _ghost_requests.clear();
+        
+        for (uint_t i=0; i<_ghost_recv_ranks.size(); i++) {
+            
+            const std::vector<uint_t>
+            &idx = _ghost_recv_indices[i];
+            const std::vector<ScalarType>
+            &buf = _ghost_recv_buffers[i];
+            
+            for (uint_t k=0; k<idx.size(); k++)
+                _flat_values[idx[k]] = buf[k];
+        }
+    }
+    
+    
+    /*!
+     * dof ID stored in \p flat_dof_ids() for parameters without a dof ID
+     */
+    static const uint_t invalid_dof_id = static_cast<uint_t>(-1);
+    
 private:
     
+    /*!
+     * initializes the flat storage from the parameter map. Since the map is sorted by
+     * the parameter IDs, the local parameters, which have contiguous IDs, are placed first
+     * in the order of their IDs, and the ghosted parameters are placed after these. The
+     * parameters then store their values in \p _flat_values.
+     */
+    inline void _init_flat_storage(const libMesh::DofMap &dof_map) {
+        
+        const uint_t
+        n_local = local_end() - local_begin(),
+        n_total = _parameters.size();
+        
+        _flat_params.clear();
+        _flat_ids.clear();
+        _flat_dof_ids.clear();
+        _flat_params.reserve(n_total);
+        _flat_ids.reserve(n_total);
+        _flat_dof_ids.reserve(n_total);
+        
+        for (uint_t pass=0; pass<2; pass++) {
+            
+            typename dv_id_param_map_t::const_iterator
+            it   = _parameters.begin(),
+            end  = _parameters.end();
+            
+            for ( ; it != end; it++) {
+                
+                const bool
+                is_local = (it->first >= local_begin() && it->first < local_end());
+                
+                if (is_local != (pass == 0)) continue;
+                
+                const MAST::Base::ParameterData
+                &d = this->get_data_for_parameter(*it->second);
+                
+                _flat_params.push_back(it->second);
+                _flat_ids.push_back(it->first);
+                _flat_dof_ids.push_back(d.template has<int>("dof_id")?
+                                        d.template get<int>("dof_id"):invalid_dof_id);
+            }
+        }
+        
+        Assert2(_flat_params.size() >= n_local, _flat_params.size(), n_local,
+                "Local parameters missing from vector");
+        
+        _flat_values.resize(_flat_params.size());
+        
+        for (uint_t i=0; i<_flat_params.size(); i++)
+            _flat_params[i]->set_storage(_flat_values[i]);
+        
+        _init_fields(_int_fields);
+        _init_fields(_real_fields);
+        _init_dof_index(dof_map, _flat_dof_ids);
+    }
+    
+    
+    /*!
+     * copies the \p ParameterData fields of type \p T that are defined for all parameters
+     * to \p fields, with an array in the flat layout for each field.
+     */
+    template <typename T>
+    inline void _init_fields(std::map<std::string, std::vector<T>> &fields) const {
+        
+        fields.clear();
+        
+        {
+            const std::map<const std::string, T>
+            &d = this->get_data_for_parameter(*_flat_params[0]).template data<T>();
+            
+            typename std::map<const std::string, T>::const_iterator
+            it   = d.begin(),
+            end  = d.end();
+            
+            for ( ; it != end; it++)
+                fields[it->first].resize(_flat_params.size());
+        }
+        
+        for (uint_t i=0; i<_flat_params.size(); i++) {
+            
+            const std::map<const std::string, T>
+            &d = this->get_data_for_parameter(*_flat_params[i]).template data<T>();
+            
+            typename std::map<std::string, std::vector<T>>::iterator
+            it   = fields.begin();
+            
+            while (it != fields.end()) {
+                
+                typename std::map<const std::string, T>::const_iterator
+                d_it = d.find(it->first);
+                
+                if (d_it == d.end())
+                    fields.erase(it++);
+                else {
+                    
+                    it->second[i] = d_it->second;
+                    it++;
+                }
+            }
+        }
+    }
+    
+    
+    inline const std::map<std::string, std::vector<int_t>>&
+    _get_fields(int_t) const {
+        
+        return _int_fields;
+    }
+    
+    
+    inline const std::map<std::string, std::vector<real_t>>&
+    _get_fields(real_t) const {
+        
+        return _real_fields;
+    }
+    
+    
+    /*!
+     * initializes the map from dof IDs to the flat index, where \p dof_ids[i] is the dof
+     * ID of the parameter at flat index \p i. Dof IDs owned by this rank are mapped
+     * through a dense table, and all others through a vector sorted by dof ID.
+     */
+    inline void _init_dof_index(const libMesh::DofMap     &dof_map,
+                                const std::vector<uint_t> &dof_ids) {
+        
+        _first_local_dof = dof_map.first_dof(_comm.rank());
+        _local_dof_to_flat_index.assign(dof_map.end_dof(_comm.rank()) - _first_local_dof, -1);
+        _nonlocal_dof_to_flat_index.clear();
+        
+        for (uint_t i=0; i<dof_ids.size(); i++) {
+            
+            const uint_t
+            d = dof_ids[i];
+            
+            if (d == invalid_dof_id)
+                continue;
+            else if (d >= _first_local_dof &&
+                     d - _first_local_dof < _local_dof_to_flat_index.size())
+                _local_dof_to_flat_index[d - _first_local_dof] = i;
+            else
+                _nonlocal_dof_to_flat_index.push_back(std::make_pair(d, i));
+        }
+        
+        std::sort(_nonlocal_dof_to_flat_index.begin(), _nonlocal_dof_to_flat_index.end());
+    }
+    
+    
+    /*!
+     * sends \p send[i] to rank \p i and receives \p recv[i] from rank \p i using
+     * nonblocking communication. Only nonempty vectors are communicated, and \p recv
+     * must be sized to the expected message lengths.
+     */
+    inline void _exchange(const std::vector<std::vector<uint_t>> &send,
+                          std::vector<std::vector<uint_t>>       &recv) const {
+        
+        const libMesh::Parallel::MessageTag
+        tag = _comm.get_unique_tag(_sync_tag_value);
+        
+        std::vector<libMesh::Parallel::Request>
+        requests;
+        requests.reserve(2*_comm.size());
+        
+        for (uint_t i=0; i<_comm.size(); i++) {
+            
+            if (i == _comm.rank() || recv[i].empty()) continue;
+            
+            requests.push_back(libMesh::Parallel::Request());
+            _comm.receive(i, recv[i], requests.back(), tag);
+        }
+        
+        for (uint_t i=0; i<_comm.size(); i++) {
+            
+            if (i == _comm.rank() || send[i].empty()) continue;
+            
+            requests.push_back(libMesh::Parallel::Request());
+            _comm.send(i, send[i], requests.back(), tag);
+        }
+        
+        libMesh::Parallel::wait(requests);
+    }
+    
+    
+    /*!
+     * stores the ranks and flat indices of parameters for the update of ghosted values.
+     * \p dv_ids_requested[i] are the IDs of local parameters ghosted on rank \p i, and
+     * \p dv_ids_ghosted[i] are the IDs of ghosted parameters owned by rank \p i.
+     */
+    inline void
+    _init_ghost_communication(const std::vector<std::vector<uint_t>> &dv_ids_requested,
+                              const std::vector<std::vector<uint_t>> &dv_ids_ghosted) {
+        
+        _ghost_send_ranks.clear();
+        _ghost_send_indices.clear();
+        _ghost_send_buffers.clear();
+        _ghost_recv_ranks.clear();
+        _ghost_recv_indices.clear();
+        _ghost_recv_buffers.clear();
+        
+        for (uint_t i=0; i<_comm.size(); i++) {
+            
+            if (i == _comm.rank()) continue;
+            
+            if (dv_ids_requested[i].size()) {
+                
+                _ghost_send_ranks.push_back(i);
+                _ghost_send_indices.push_back(std::vector<uint_t>(dv_ids_requested[i].size()));
+                _ghost_send_buffers.push_back(std::vector<ScalarType>(dv_ids_requested[i].size()));
+                
+                for (uint_t k=0; k<dv_ids_requested[i].size(); k++)
+                    _ghost_send_indices.back()[k] = _flat_index(dv_ids_requested[i][k]);
+            }
+            
+            if (dv_ids_ghosted[i].size()) {
+                
+                _ghost_recv_ranks.push_back(i);
+                _ghost_recv_indices.push_back(std::vector<uint_t>(dv_ids_ghosted[i].size()));
+                _ghost_recv_buffers.push_back(std::vector<ScalarType>(dv_ids_ghosted[i].size()));
+                
+                for (uint_t k=0; k<dv_ids_ghosted[i].size(); k++)
+                    _ghost_recv_indices.back()[k] = _flat_index(dv_ids_ghosted[i][k]);
+            }
+        }
+        
+        _ghost_requests.reserve(_ghost_send_ranks.size() + _ghost_recv_ranks.size());
+        _ghost_tag = _comm.get_unique_tag(_ghost_tag_value);
+    }
+    
+    
+    /*!
+     * @returns the index in the flat storage of the parameter with ID \p i
+     */
+    inline uint_t _flat_index(uint_t i) const {
+        
+        Assert0(_rank_begin_index.size(),
+                "Data must be synchronized before access to parameters");
+        
+        const uint_t
+        n_local = local_end() - local_begin();
+        
+        if (i >= local_begin() && i < local_end())
+            return i - local_begin();
+        
+        // ghosted parameters are sorted by their IDs
+        std::vector<uint_t>::const_iterator
+        it   = std::lower_bound(_flat_ids.begin() + n_local, _flat_ids.end(), i);
+        
+        Assert1(it != _flat_ids.end() && *it == i, i, "Invalid parameter index for rank");
+        
+        return it - _flat_ids.begin();
+    }
+    
+    
+    /*!
+     * @returns the index in the flat storage of the parameter with dof ID \p d, or -1
+     * if no parameter is associated with the dof.
+     */
+    inline int_t _flat_index_for_dof(uint_t d) const {
+        
+        if (d >= _first_local_dof &&
+            d - _first_local_dof < _local_dof_to_flat_index.size())
+            return _local_dof_to_flat_index[d - _first_local_dof];
+        
+        std::vector<std::pair<uint_t, int_t>>::const_iterator
+        it   = std::lower_bound(_nonlocal_dof_to_flat_index.begin(),
+                                _nonlocal_dof_to_flat_index.end(),
+                                std::make_pair(d, std::numeric_limits<int_t>::min()));
+        
+        if (it != _nonlocal_dof_to_flat_index.end() && it->first == d)
+            return it->second;
+        else
+            return -1;
+    }
+    
     const libMesh::Parallel::Communicator&                             _comm;
     std::map<uint_t, MAST::Optimization::DesignParameter<ScalarType>*> _parameters;
     std::vector<MAST::Optimization::DesignParameter<ScalarType>*>      _local_parameters;
     std::vector<MAST::Optimization::DesignParameter<ScalarType>*>      _ghosted_parameters;
     std::map<const MAST::Optimization::DesignParameter<ScalarType>*,
              MAST::Base::ParameterData*> _data;
-    std::set<uint_t>                     _dv_index;
-    std::map<uint_t, uint_t>             _dof_id_to_dv_id_map;
     std::vector<uint_t>                  _rank_begin_index;
     std::vector<uint_t>                  _rank_end_index;
+    // the parameter objects are only used for the lookup of a parameter by its ID. The
+    // values, IDs and fields are streamed from the arrays below in loops over parameters.
+    std::vector<MAST::Optimization::DesignParameter<ScalarType>*> _flat_params;
+    std::vector<ScalarType>              _flat_values;
+    std::vector<uint_t>                  _flat_ids;
+    std::vector<uint_t>                  _flat_dof_ids;
+    uint_t                               _first_local_dof;
+    std::vector<int_t>                   _local_dof_to_flat_index;
+    std::vector<std::pair<uint_t, int_t>> _nonlocal_dof_to_flat_index;
+    std::map<std::string, std::vector<int_t>>  _int_fields;
+    std::map<std::string, std::vector<real_t>> _real_fields;
+    
+    // neighbor ranks, flat indices and persistent buffers for ghost value updates
+    std::vector<uint_t>                  _ghost_send_ranks;
+    std::vector<std::vector<uint_t>>     _ghost_send_indices;
+    std::vector<std::vector<ScalarType>> _ghost_send_buffers;
+    std::vector<uint_t>                  _ghost_recv_ranks;
+    std::vector<std::vector<uint_t>>     _ghost_recv_indices;
+    std::vector<std::vector<ScalarType>> _ghost_recv_buffers;
+    std::vector<libMesh::Parallel::Request> _ghost_requests;
+    libMesh::Parallel::MessageTag        _ghost_tag;
+    
+    static const int                     _sync_tag_value  = 4701;
+    static const int                     _ghost_tag_value = 4702;
 };
 
 } // namespace Optimization
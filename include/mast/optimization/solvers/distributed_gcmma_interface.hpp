@@ -0,0 +1,284 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_distributed_gcmma_optimization_interface_h__
+#define __mast_distributed_gcmma_optimization_interface_h__
+
+// C++ includes
+#include <iostream>
+#include <vector>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+#include <mast/optimization/solvers/gcmma_subproblem.hpp>
+#include <mast/optimization/utility/function_values.hpp>
+
+// libMesh includes
+#include <libmesh/parallel.h>
+
+
+namespace MAST {
+namespace Optimization {
+namespace Solvers {
+
+/*!
+ * GCMMA optimizer for design variables that are partitioned across the ranks of
+ * the communicator. Unlike \p GCMMAInterface, which replicates the design vector
+ * and its gradients on all ranks, each rank stores only its local design variables.
+ * The function evaluation object is expected to provide
+ *  - \p n_vars(), \p n_eq() and \p n_ineq() for the global problem,
+ *  - \p n_local_vars() for the number of design variables on this rank, and
+ *  - \p init_dvar(), \p evaluate() and \p output(), and optionally
+ *    \p evaluate_values(), with the same signatures as
+ *    used by \p GCMMAInterface, where all vectors of design variables and their
+ *    gradients contain only the local entries. The constraint gradients are
+ *    stored with index \f$ k = j m + i \f$ for local variable \f$ j \f$ and constraint
+ *    \f$ i \f$. The objective and constraint values returned by \p evaluate() must be
+ *    the global values, identical on all ranks.
+ */
+template <typename FunctionEvaluationType>
+class DistributedGCMMAInterface {
+    
+public:
+    
+    DistributedGCMMAInterface(const libMesh::Parallel::Communicator &comm):
+    constr_penalty                (5.e1),
+    initial_rel_step              (1.e-2),
+    asymptote_reduction           (0.7),
+    asymptote_expansion           (1.2),
+    rel_change_tol                (1.e-8),
+    max_inner_iters               (15),
+    max_iters                     (1000),
+    n_rel_change_iters            (5),
+    total_iter                    (0),
+    _comm                         (comm),
+    _feval                        (nullptr),
+    _sub                          (&comm)
+    { }
+    
+    
+    virtual ~DistributedGCMMAInterface()
+    { }
+    
+    real_t           constr_penalty;
+    real_t           initial_rel_step;
+    real_t           asymptote_reduction;
+    real_t           asymptote_expansion;
+    real_t           rel_change_tol;
+    uint_t           max_inner_iters;
+    uint_t           max_iters;
+    uint_t           n_rel_change_iters;
+    uint_t           total_iter;
+    
+    inline void set_function_evaluation(FunctionEvaluationType& feval) {
+        
+        Assert0(!_feval, "Function evaluation object already set");
+        
+        _feval = &feval;
+    }
+    
+    
+    /*!
+     * initializes the local design variable vector from the function object.
+     */
+    inline void init() {
+        
+        Assert0(_feval, "Function evaluation object not set");
+        
+        std::size_t
+        n_global = _feval->n_local_vars();
+        _comm.sum(n_global);
+        
+        Assert2(n_global == _feval->n_vars(), n_global, _feval->n_vars(),
+                "Sum of local design variables must equal the number of design variables");
+        
+        const std::size_t
+        N = _feval->n_local_vars();
+        
+        _XVAL.resize(N, 0.);
+        _sub.init(N, _feval->n_eq() + _feval->n_ineq(), 0.);
+        
+        _feval->init_dvar(_XVAL, _sub.xmin, _sub.xmax);
+    }
+    
+    
+    inline void optimize() {
+        
+        Assert0(_feval, "Function evaluation object not set");
+        
+        const std::size_t
+        N = _feval->n_local_vars();
+        const uint_t
+        M = _feval->n_eq() + _feval->n_ineq();
+        
+        Assert1(_feval->n_vars() > 0, _feval->n_vars(), "Design variables must be greater than 0");
+        Assert2(_XVAL.size() == N, _XVAL.size(), N, "Design variables must be initialized");
+        
+        std::vector<real_t>
+        XOLD1(_XVAL), XOLD2(_XVAL), XMMA(N, 0.), DF0DX(N, 0.),
+        FVAL(M, 0.), FNEW(M, 0.), DFDX(M*N, 0.),
+        f0_iters(n_rel_change_iters);
+        
+        std::vector<bool> eval_grads(M, false);
+        
+        real_t
+        F0VAL   = 0.,
+        F0NEW   = 0.,
+        max_x   = 0.;
+        
+        for (std::size_t i=0; i<N; i++)
+            max_x = std::max(max_x, std::fabs(_XVAL[i]));
+        _comm.max(max_x);
+        
+        _sub.asymptote_init      = initial_rel_step;
+        _sub.asymptote_reduction = asymptote_reduction;
+        _sub.asymptote_expansion = asymptote_expansion;
+        std::fill(_sub.c.begin(), _sub.c.end(), std::max(max_x, constr_penalty));
+        
+        uint_t
+        ITER  = 0,
+        INNER = 0;
+        
+        bool terminate = false, inner_terminate = false;
+        while (!terminate) {
+            
+            total_iter++;
+            ITER++;
+            
+            // function values and gradients at the current design
+            std::fill(eval_grads.begin(), eval_grads.end(), true);
+            _evaluate_wrapper(_XVAL, F0VAL, true, DF0DX, FVAL, eval_grads, DFDX);
+            
+            if (ITER == 1)
+                // output the very first iteration
+                _feval->output(total_iter, _XVAL, F0VAL, FVAL);
+            
+            _sub.update_asymptotes(ITER, _XVAL, XOLD1, XOLD2, DF0DX, DFDX);
+            
+            INNER = 0;
+            inner_terminate = false;
+            while (!inner_terminate) {
+                
+                _sub.solve(_XVAL, F0VAL, DF0DX, FVAL, DFDX, XMMA);
+                
+                // function values at the subproblem solution
+                MAST::Optimization::Utility::evaluate_values(*_feval, XMMA, F0NEW, DF0DX, FNEW, DFDX);
+                Assert0(_comm.verify(F0NEW) && _comm.verify(FNEW),
+                        "Function values have different values on ranks");
+                
+                // since all quantities used for this decision are replicated, all
+                // ranks reach the same decision without communication
+                if (INNER >= max_inner_iters) {
+                    
+                    std::cout
+                    << "** Max Inner Iter Reached: Terminating! Inner Iter = "
+                    << INNER << std::endl;
+                    inner_terminate = true;
+                }
+                else if (_sub.is_conservative(F0NEW, FNEW)) {
+                    
+                    std::cout
+                    << "** Conservative Solution: Terminating! Inner Iter = "
+                    << INNER << std::endl;
+                    inner_terminate = true;
+                }
+                else {
+                    
+                    INNER++;
+                    _sub.update_raa(XMMA, _XVAL, F0NEW, FNEW);
+                }
+            }
+            
+            XOLD2 = XOLD1;
+            XOLD1 = _XVAL;
+            _XVAL = XMMA;
+            F0VAL = F0NEW;
+            FVAL  = FNEW;
+            
+            _feval->output(total_iter, _XVAL, F0VAL, FVAL);
+            f0_iters[(ITER-1)%n_rel_change_iters] = F0VAL;
+            
+            if (ITER == max_iters) {
+                std::cout
+                << "GCMMA: Reached maximum iterations, terminating! "
+                << std::endl;
+                terminate = true;
+            }
+            
+            // relative change in objective
+            bool rel_change_conv = ITER >= n_rel_change_iters;
+            real_t f0_curr = f0_iters[n_rel_change_iters-1];
+            
+            for (uint_t i=0; i<n_rel_change_iters-1; i++) {
+                if (f0_curr > sqrt(rel_change_tol))
+                    rel_change_conv = (rel_change_conv &&
+                                       fabs(f0_iters[i]-f0_curr)/fabs(f0_curr) < rel_change_tol);
+                else
+                    rel_change_conv = (rel_change_conv &&
+                                       fabs(f0_iters[i]-f0_curr) < rel_change_tol);
+            }
+            if (rel_change_conv) {
+                std::cout
+                << "GCMMA: Converged relative change tolerance, terminating! "
+                << std::endl;
+                terminate = true;
+            }
+        }
+    }
+    
+    
+private:
+    
+    inline void
+    _evaluate_wrapper(std::vector<real_t>       &x,
+                      real_t                    &obj,
+                      bool                      eval_obj_grad,
+                      std::vector<real_t>       &obj_grad,
+                      std::vector<real_t>       &fvals,
+                      std::vector<bool>         &eval_grads,
+                      std::vector<real_t>       &grads) {
+        
+        _feval->evaluate(x,
+                         obj,
+                         eval_obj_grad,
+                         obj_grad,
+                         fvals,
+                         eval_grads,
+                         grads);
+        
+        // the function values are used for decisions on all ranks, and must
+        // be consistent across processors. The gradients are local.
+        Assert0(_comm.verify(obj),
+                "Objective function has different values on ranks");
+        Assert0(_comm.verify(fvals),
+                "Constraint functions has different values on ranks");
+    }
+    
+    const libMesh::Parallel::Communicator  &_comm;
+    FunctionEvaluationType                 *_feval;
+    MAST::Optimization::Solvers::GCMMASubproblem _sub;
+    std::vector<real_t>                     _XVAL;
+};
+
+} // namespace Solvers
+} // namespace Optimization
+} // namespace MAST
+
+#endif // __mast_distributed_gcmma_optimization_interface_h__
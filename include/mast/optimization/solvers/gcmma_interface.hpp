@@ -28,53 +28,13 @@
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
 #include <mast/optimization/utility/design_history.hpp>
+#include <mast/optimization/utility/function_values.hpp>
+#include <mast/optimization/solvers/gcmma_subproblem.hpp>
 
 // libMesh includes
 #include <libmesh/parallel.h>
 
 
-extern "C" {
-extern void raasta_(int *M, int *N,
-                    double *RAA0, double *RAA,
-                    double *XMIN, double *XMAX,
-                    double *DF0DX, double *DFDX);
-extern void asympg_(int *ITER, int *M, int *N,
-                    double *ALBEFA, double *GHINIT,
-                    double *GHDECR, double *GHINCR,
-                    double *XVAL, double *XMIN, double *XMAX,
-                    double *XOLD1, double *XOLD2,
-                    double *XLOW, double *XUPP,
-                    double *ALFA, double *BETA);
-extern void mmasug_(int *ITER, int *M, int *N, double *GEPS, int *IYFREE,
-                    double *XVAL, double *XMMA,
-                    double *XMIN, double *XMAX,
-                    double *XLOW, double *XUPP,
-                    double *ALFA, double *BETA,
-                    double *A, double *B, double *C, double *Y, double *Z,
-                    double *RAA0, double *RAA, double *ULAM,
-                    double *F0VAL, double *FVAL,
-                    double *F0APP, double *FAPP,
-                    double *FMAX, double *DF0DX, double *DFDX,
-                    double *P, double *Q, double *P0, double *Q0,
-                    double *UU, double *GRADF, double *DSRCH, double *HESSF);
-extern void conser_(int *M, int *ICONSE,
-                    double *GEPS, double *F0NEW, double *F0APP,
-                    double *FNEW, double *FAPP);
-extern void raaupd_(int *M, int *N, double *GEPS,
-                    double *XMMA, double *XVAL,
-                    double *XMIN, double *XMAX,
-                    double *XLOW, double *XUPP,
-                    double *F0NEW, double *FNEW,
-                    double *F0APP, double *FAPP,
-                    double *RAA0, double *RAA);
-extern void xupdat_(int *N, int *ITER,
-                    double *XMMA, double *XVAL,
-                    double *XOLD1, double *XOLD2);
-extern void fupdat_(int *M, double *F0NEW, double *FNEW,
-                    double *F0VAL, double *FVAL);
-}
-
-
 namespace MAST {
 namespace Optimization {
 namespace Solvers {
@@ -87,7 +47,6 @@ class GCMMAInterface {
 public:
     
     GCMMAInterface(libMesh::Parallel::Communicator &comm):
-    _comm                         (comm),
     constr_penalty                (5.e1),
     initial_rel_step              (1.e-2),
     asymptote_reduction           (0.7),
@@ -98,6 +57,7 @@ public:
     n_rel_change_iters            (5),
     total_iter                    (0),
     write_internal_iteration_data (false),
+    _comm                         (comm),
     _feval                        (nullptr)
     { }
 
@@ -130,160 +90,80 @@ public:
     inline void init() {
         
         Assert0(_feval, "Function evaluation object not set");
-        int
-        N                  = _feval->n_vars(),
-        total_iter = 0;
+        const std::size_t
+        N                  = _feval->n_vars();
         
         _XVAL.resize(N, 0.);
-        _XMIN.resize(N, 0.);
-        _XMAX.resize(N, 0.);
+        _sub.init(N, _feval->n_eq() + _feval->n_ineq(), 0.);
         
-        _feval->init_dvar(_XVAL, _XMIN, _XMAX);
+        _feval->init_dvar(_XVAL, _sub.xmin, _sub.xmax);
     }
     
     
     inline void optimize() {
         
-#if MAST_ENABLE_GCMMA == 1
-        
         Assert0(_feval, "Function evaluation object not set");
                 
-        int
-        N                  = _feval->n_vars(),
+        const std::size_t
+        N                  = _feval->n_vars();
+        const uint_t
         M                  = _feval->n_eq() + _feval->n_ineq();
         
         Assert1(N > 0, N, "Design variables must be greater than 0");
         Assert2(_XVAL.size() == N, _XVAL.size(), N, "Design variables must be initialized");
-        Assert2(_XMIN.size() == N, _XMIN.size(), N, "Design variables must be initialized");
-        Assert2(_XMAX.size() == N, _XMAX.size(), N, "Design variables must be initialized");
+        Assert2(_sub.xmin.size() == N, _sub.xmin.size(), N, "Design variables must be initialized");
+        Assert2(_sub.xmax.size() == N, _sub.xmax.size(), N, "Design variables must be initialized");
 
-        std::vector<real_t>  XOLD1(N, 0.), XOLD2(N, 0.),
-        XMMA(N, 0.), XLOW(N, 0.), XUPP(N, 0.),
-        ALFA(N, 0.), BETA(N, 0.), DF0DX(N, 0.),
-        A(M, 0.), B(M, 0.), C(M, 0.), Y(M, 0.), RAA(M, 0.), ULAM(M, 0.),
-        FVAL(M, 0.), FAPP(M, 0.), FNEW(M, 0.), FMAX(M, 0.),
-        DFDX(M*N, 0.), P(M*N, 0.), Q(M*N, 0.), P0(N, 0.), Q0(N, 0.),
-        UU(M, 0.), GRADF(M, 0.), DSRCH(M, 0.), HESSF(M*(M+1)/2, 0.),
+        /*
+         *  XVAL(j) = Current value of the variable x_j.
+         * XOLD1(j) = Value of the variable x_j one iteration ago.
+         * XOLD2(j) = Value of the variable x_j two iterations ago.
+         *  XMMA(j) = Optimal value of x_j in the MMA subproblem.
+         *   F0VAL  = Value of the objective function f_0(x)
+         *  FVAL(i) = Value of the i:th constraint function f_i(x).
+         * DF0DX(j) = Derivative of f_0(x) with respect to x_j.
+         *  DFDX(k) = Derivative of f_i(x) with respect to x_j,
+         *            where k = j*M + i.
+         *
+         * The asymptotes, subproblem bounds and GCMMA parameters are stored in
+         * the subproblem object.
+         */
+        std::vector<real_t>  XOLD1(_XVAL), XOLD2(_XVAL),
+        XMMA(N, 0.), DF0DX(N, 0.),
+        FVAL(M, 0.), FNEW(M, 0.),
+        DFDX(M*N, 0.),
         f0_iters(n_rel_change_iters);
         
-        std::vector<int> IYFREE(M, 0);
         std::vector<bool> eval_grads(M, false);
         
         real_t
-        ALBEFA  = 0.1,
-        GHINIT  = initial_rel_step,
-        GHDECR  = asymptote_reduction,
-        GHINCR  = asymptote_expansion,
         F0VAL   = 0.,
-        F0NEW   = 0.,
-        F0APP   = 0.,
-        RAA0    = 0.,
-        Z       = 0.,
-        GEPS    = rel_change_tol;
-        
+        F0NEW   = 0.;
         
-        /*C********+*********+*********+*********+*********+*********+*********+
-         C
-         C  The meaning of some of the scalars and vectors in the program:
-         C
-         C     N  = Complex of variables x_j in the problem.
-         C     M  = Complex of constraints in the problem (not including
-         C          the simple upper and lower bounds on the variables).
-         C ALBEFA = Relative spacing between asymptote and mode limit. Lower value
-         C          will cause the move limit (alpha,beta) to move closer to asymptote
-         C          values (l, u).
-         C GHINIT = Initial asymptote setting. For the first two iterations the
-         C          asymptotes (l, u) are defined based on offsets from the design
-         C          point as this fraction of the design variable bounds, ie.
-         C              l_j   =   x_j^k  - GHINIT * (x_j^max - x_j^min)
-         C              u_j   =   x_j^k  + GHINIT * (x_j^max - x_j^min)
-         C GHDECR = Fraction by which the asymptote is reduced for oscillating
-         C          changes in design variables based on three consecutive iterations
-         C GHINCR = Fraction by which the asymptote is increased for non-oscillating
-         C          changes in design variables based on three consecutive iterations
-         C INNMAX = Maximal number of inner iterations within each outer iter.
-         C          A reasonable choice is INNMAX=10.
-         C  ITER  = Current outer iteration number ( =1 the first iteration).
-         C  GEPS  = Tolerance parameter for the constraints.
-         C          (Used in the termination criteria for the subproblem.)
-         C
-         C   XVAL(j) = Current value of the variable x_j.
-         C  XOLD1(j) = Value of the variable x_j one iteration ago.
-         C  XOLD2(j) = Value of the variable x_j two iterations ago.
-         C   XMMA(j) = Optimal value of x_j in the MMA subproblem.
-         C   XMIN(j) = Original lower bound for the variable x_j.
-         C   XMAX(j) = Original upper bound for the variable x_j.
-         C   XLOW(j) = Value of the lower asymptot l_j.
-         C   XUPP(j) = Value of the upper asymptot u_j.
-         C   ALFA(j) = Lower bound for x_j in the MMA subproblem.
-         C   BETA(j) = Upper bound for x_j in the MMA subproblem.
-         C    F0VAL  = Value of the objective function f_0(x)
-         C   FVAL(i) = Value of the i:th constraint function f_i(x).
-         C  DF0DX(j) = Derivative of f_0(x) with respect to x_j.
-         C   FMAX(i) = Right hand side of the i:th constraint.
-         C   DFDX(k) = Derivative of f_i(x) with respect to x_j,
-         C             where k = (j-1)*M + i.
-         C      P(k) = Coefficient p_ij in the MMA subproblem, where
-         C             k = (j-1)*M + i.
-         C      Q(k) = Coefficient q_ij in the MMA subproblem, where
-         C             k = (j-1)*M + i.
-         C     P0(j) = Coefficient p_0j in the MMA subproblem.
-         C     Q0(j) = Coefficient q_0j in the MMA subproblem.
-         C      B(i) = Right hand side b_i in the MMA subproblem.
-         C    F0APP  = Value of the approximating objective function
-         C             at the optimal soultion of the MMA subproblem.
-         C   FAPP(i) = Value of the approximating i:th constraint function
-         C             at the optimal soultion of the MMA subproblem.
-         C    RAA0   = Parameter raa_0 in the MMA subproblem.
-         C    RAA(i) = Parameter raa_i in the MMA subproblem.
-         C      Y(i) = Value of the "artificial" variable y_i.
-         C      Z    = Value of the "minimax" variable z.
-         C      A(i) = Coefficient a_i for the variable z.
-         C      C(i) = Coefficient c_i for the variable y_i.
-         C   ULAM(i) = Value of the dual variable lambda_i.
-         C  GRADF(i) = Gradient component of the dual objective function.
-         C  DSRCH(i) = Search direction component in the dual subproblem.
-         C  HESSF(k) = Hessian matrix component of the dual function.
-         C IYFREE(i) = 0 for dual variables which are fixed to zero in
-         C               the current subspace of the dual subproblem,
-         C           = 1 for dual variables which are "free" in
-         C               the current subspace of the dual subproblem.
-         C
-         C********+*********+*********+*********+*********+*********+*********+*/
+        _sub.asymptote_init      = initial_rel_step;
+        _sub.asymptote_reduction = asymptote_reduction;
+        _sub.asymptote_expansion = asymptote_expansion;
+        _sub.epsimin             = rel_change_tol;
         
-        
-        /*
-         *  The USER should now give values to the parameters
-         *  M, N, GEPS, XVAL (starting point),
-         *  XMIN, XMAX, FMAX, A and C.
-         */
-        // _initi(M,N,GEPS,XVAL,XMIN,XMAX,FMAX,A,C);
-        // Assumed:  FMAX == A
-        //_feval->init_dvar(XVAL, XMIN, XMAX);
         // set the value of C[i] to be very large numbers
         real_t max_x = 0.;
-        for (uint_t i=0; i<N; i++)
+        for (std::size_t i=0; i<N; i++)
             if (max_x < fabs(_XVAL[i]))
                 max_x = fabs(_XVAL[i]);
+        std::fill(_sub.c.begin(), _sub.c.end(), std::max(1.e0*max_x, constr_penalty));
         
-        int INNMAX=max_inner_iters, ITER=0, ITE=0, INNER=0, ICONSE=0;
+        uint_t INNMAX=max_inner_iters, ITER=0, ITE=0, INNER=0;
         /*
          *  The outer iterative process starts.
          */
         bool terminate = false, inner_terminate=false;
         while (!terminate) {
             
-            std::fill(C.begin(), C.end(), std::max(1.e0*max_x, constr_penalty));
-            GHINIT  = initial_rel_step,
-            GHDECR  = asymptote_reduction,
-            GHINCR  = asymptote_expansion,
-            
             total_iter++;
             ITER=ITER+1;
             ITE=ITE+1;
             /*
-             *  The USER should now calculate function values and gradients
-             *  at XVAL. The result should be put in F0VAL,DF0DX,FVAL,DFDX.
+             *  Function values and gradients at XVAL.
              */
             std::fill(eval_grads.begin(), eval_grads.end(), true);
             _evaluate_wrapper(_XVAL,
@@ -296,18 +176,16 @@ public:
             /*
              *  RAA0,RAA,XLOW,XUPP,ALFA and BETA are calculated.
              */
-            raasta_(&M, &N, &RAA0, &RAA[0], &_XMIN[0], &_XMAX[0], &DF0DX[0], &DFDX[0]);
-            asympg_(&ITER, &M, &N, &ALBEFA, &GHINIT, &GHDECR, &GHINCR,
-                    &_XVAL[0], &_XMIN[0], &_XMAX[0], &XOLD1[0], &XOLD2[0],
-                    &XLOW[0], &XUPP[0], &ALFA[0], &BETA[0]);
-            /*
-             *  The inner iterative process starts.
-             */
+            _sub.update_asymptotes(ITER, _XVAL, XOLD1, XOLD2, DF0DX, DFDX);
             
             // write the asymptote data for the inneriterations
             if (write_internal_iteration_data)
-                _output_iteration_data(ITER, _XVAL, _XMIN, _XMAX, XLOW, XUPP, ALFA, BETA);
+                _output_iteration_data(ITER, _XVAL, _sub.xmin, _sub.xmax,
+                                       _sub.low, _sub.upp, _sub.alfa, _sub.beta);
             
+            /*
+             *  The inner iterative process starts.
+             */
             INNER=0;
             inner_terminate = false;
             while (!inner_terminate) {
@@ -315,19 +193,12 @@ public:
                 /*
                  *  The subproblem is generated and solved.
                  */
-                mmasug_(&ITER, &M, &N, &GEPS, &IYFREE[0], &_XVAL[0], &XMMA[0],
-                        &_XMIN[0], &_XMAX[0], &XLOW[0], &XUPP[0], &ALFA[0], &BETA[0],
-                        &A[0], &B[0], &C[0], &Y[0], &Z, &RAA0, &RAA[0], &ULAM[0],
-                        &F0VAL, &FVAL[0], &F0APP, &FAPP[0], &FMAX[0], &DF0DX[0], &DFDX[0],
-                        &P[0], &Q[0], &P0[0], &Q0[0], &UU[0], &GRADF[0], &DSRCH[0], &HESSF[0]);
+                _sub.solve(_XVAL, F0VAL, DF0DX, FVAL, DFDX, XMMA);
                 /*
-                 *  The USER should now calculate function values at XMMA.
-                 *  The result should be put in F0NEW and FNEW.
+                 *  Function values at XMMA. The gradients are not needed
+                 *  for the conservativeness check.
                  */
-                std::fill(eval_grads.begin(), eval_grads.end(), false);
-                _evaluate_wrapper(XMMA,
-                                 F0NEW, false, DF0DX,
-                                 FNEW, eval_grads, DFDX);
+                _evaluate_values_wrapper(XMMA, F0NEW, DF0DX, FNEW, DFDX);
                 
                 ///////////////////////////////////////////////////////////////
                 // if the solution is poor, backtrack
@@ -338,15 +209,13 @@ public:
                     << frac
                     << "  constr: " << FNEW[0]
                     << std::endl;
-                    for (uint_t i=0; i<XMMA.size(); i++)
+                    for (std::size_t i=0; i<XMMA.size(); i++)
                         XMMA_new[i] = XOLD1[i] + frac*(XMMA[i]-XOLD1[i]);
                     
-                    _evaluate_wrapper(XMMA_new,
-                                     F0NEW, false, DF0DX,
-                                     FNEW, eval_grads, DFDX);
+                    _evaluate_values_wrapper(XMMA_new, F0NEW, DF0DX, FNEW, DFDX);
                     frac *= frac;
                 }
-                for (uint_t i=0; i<XMMA.size(); i++)
+                for (std::size_t i=0; i<XMMA.size(); i++)
                     XMMA[i] = XMMA_new[i];
                 ///////////////////////////////////////////////////////////////
                 
@@ -360,8 +229,7 @@ public:
                     /*
                      *  It is checked if the approximations were conservative.
                      */
-                    conser_( &M, &ICONSE, &GEPS, &F0NEW, &F0APP, &FNEW[0], &FAPP[0]);
-                    if (ICONSE == 1) {
+                    if (_sub.is_conservative(F0NEW, FNEW)) {
                         std::cout
                         << "** Conservative Solution: Terminating! Inner Iter = "
                         << INNER << std::endl;
@@ -373,9 +241,7 @@ public:
                          *  are updated and one more inner iteration is started.
                          */
                         INNER=INNER+1;
-                        raaupd_( &M, &N, &GEPS, &XMMA[0], &_XVAL[0],
-                                &_XMIN[0], &_XMAX[0], &XLOW[0], &XUPP[0],
-                                &F0NEW, &FNEW[0], &F0APP, &FAPP[0], &RAA0, &RAA[0]);
+                        _sub.update_raa(XMMA, _XVAL, F0NEW, FNEW);
                     }
                 }
             }
@@ -386,8 +252,11 @@ public:
              *  The variables are updated so that XVAL stands for the new
              *  outer iteration point. The fuction values are also updated.
              */
-            xupdat_( &N, &ITER, &XMMA[0], &_XVAL[0], &XOLD1[0], &XOLD2[0]);
-            fupdat_( &M, &F0NEW, &FNEW[0], &F0VAL, &FVAL[0]);
+            XOLD2.swap(XOLD1);
+            XOLD1.swap(_XVAL);
+            _XVAL = XMMA;
+            F0VAL = F0NEW;
+            FVAL  = FNEW;
             /*
              *  The USER may now write the current solution.
              */
@@ -410,12 +279,12 @@ public:
             real_t f0_curr = f0_iters[n_rel_change_iters-1];
             
             for (uint_t i=0; i<n_rel_change_iters-1; i++) {
-                if (f0_curr > sqrt(GEPS))
+                if (f0_curr > sqrt(rel_change_tol))
                     rel_change_conv = (rel_change_conv &&
-                                       fabs(f0_iters[i]-f0_curr)/fabs(f0_curr) < GEPS);
+                                       fabs(f0_iters[i]-f0_curr)/fabs(f0_curr) < rel_change_tol);
                 else
                     rel_change_conv = (rel_change_conv &&
-                                       fabs(f0_iters[i]-f0_curr) < GEPS);
+                                       fabs(f0_iters[i]-f0_curr) < rel_change_tol);
             }
             if (rel_change_conv) {
                 std::cout
@@ -426,8 +295,6 @@ public:
             // tell all processors about the decision here
             _comm.broadcast(terminate, 0);
         }
-        
-#endif //MAST_ENABLE_GCMMA == 1
     }
     
     
@@ -481,7 +348,7 @@ private:
         << std::setw(20) << "XUP"
         << std::setw(20) << "XMAX" << std::endl;
 
-        for (uint_t j=0; j<_feval->n_vars(); j++)
+        for (std::size_t j=0; j<_feval->n_vars(); j++)
             std::cout
             << std::setw(5) << j
             << std::setw(20) << XMIN[j]
@@ -527,8 +394,32 @@ private:
                 "Constraint function gradient has different values on ranks");
     }
     
+    /*!
+     * evaluates only the function values at \p x. Only \p x and the function
+     * values are communicated. \p obj_grad and \p grads are used only if the function
+     * evaluation object does not provide \p evaluate_values().
+     */
+    inline void
+    _evaluate_values_wrapper(std::vector<real_t>       &x,
+                             real_t                    &obj,
+                             std::vector<real_t>       &obj_grad,
+                             std::vector<real_t>       &fvals,
+                             std::vector<real_t>       &grads) {
+        
+        // rank 0 will broadcase the DV values to all ranks
+        _comm.broadcast(x, 0);
+        
+        MAST::Optimization::Utility::evaluate_values(*_feval, x, obj, obj_grad, fvals, grads);
+        
+        Assert0(_comm.verify(obj),
+                "Objective function has different values on ranks");
+        Assert0(_comm.verify(fvals),
+                "Constraint functions has different values on ranks");
+    }
+    
     FunctionEvaluationType *_feval;
-    std::vector<real_t>     _XVAL, _XMIN, _XMAX;
+    MAST::Optimization::Solvers::GCMMASubproblem _sub;
+    std::vector<real_t>     _XVAL;
 };
 
 } // namespace Solvers
@@ -0,0 +1,801 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_gcmma_subproblem_h__
+#define __mast_gcmma_subproblem_h__
+
+// C++ includes
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+
+// libMesh includes
+#include <libmesh/parallel.h>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+
+namespace MAST {
+namespace Optimization {
+namespace Solvers {
+
+/*!
+ * MMA/GCMMA approximation and subproblem solution of K. Svanberg, "MMA and GCMMA -
+ * two methods for nonlinear optimization", 2007. The problem solved is
+ * \f[ \min_{x, y, z} f_0(x) + a_0 z + \sum_i (c_i y_i + \frac{1}{2} d_i y_i^2) \f]
+ * subject to \f$ f_i(x) - a_i z - y_i \leq 0 \f$, \f$ x_{min} \leq x \leq x_{max} \f$,
+ * \f$ y_i \geq 0 \f$ and \f$ z \geq 0 \f$.
+ *
+ * All vectors of length \f$ n \f$ store only the design variables local to this rank,
+ * and vectors of length \f$ m \f$ are replicated on all ranks. The gradients of the
+ * constraints are stored with index \f$ k = j m + i \f$ for \f$ \partial f_i/\partial x_j \f$.
+ * The subproblem is solved with the primal-dual interior point method, where the
+ * Newton system is reduced to the \f$ m+1 \f$ dual unknowns. Therefore, all
+ * communication is limited to global sums of length \f$ m(m+2) \f$ and scalar
+ * reductions. If the communicator is not provided then the vectors are assumed to
+ * include all design variables and no communication is performed. The loops over
+ * design variables are threaded when the library is built with \p ENABLE_OPENMP.
+ */
+class GCMMASubproblem {
+    
+public:
+    
+    GCMMASubproblem(const libMesh::Parallel::Communicator *comm = nullptr):
+    asymptote_init      (0.5),
+    asymptote_reduction (0.7),
+    asymptote_expansion (1.2),
+    albefa              (0.1),
+    move_limit          (1.0),
+    epsimin             (1.e-7),
+    raa0eps             (1.e-6),
+    raaeps              (1.e-6),
+    a0                  (1.),
+    raa0                (0.),
+    f0app               (0.),
+    _comm               (comm),
+    _n                  (0),
+    _m                  (0)
+    { }
+    
+    virtual ~GCMMASubproblem() { }
+    
+    /*!
+     * fraction of \f$ x_{max} - x_{min} \f$ used to initialize the asymptotes in the
+     * first two iterations
+     */
+    real_t asymptote_init;
+    /*!
+     * factor by which the asymptotes are moved closer to the design for oscillating
+     * design variables
+     */
+    real_t asymptote_reduction;
+    /*!
+     * factor by which the asymptotes are moved away from the design for
+     * monotonically changing design variables
+     */
+    real_t asymptote_expansion;
+    /*!
+     * relative distance of the subproblem bounds from the asymptotes
+     */
+    real_t albefa;
+    /*!
+     * move limit as fraction of \f$ x_{max} - x_{min} \f$. The default value of
+     * unity leaves the subproblem bounds to be defined by the asymptotes alone.
+     */
+    real_t move_limit;
+    /*!
+     * tolerance for the interior point solution of the subproblem, which is also used
+     * for the conservativity check
+     */
+    real_t epsimin;
+    /*!
+     * lower bounds on the GCMMA parameters \p raa0 and \p raa
+     */
+    real_t raa0eps;
+    real_t raaeps;
+    /*!
+     * coefficient of \f$ z \f$ in the objective
+     */
+    real_t a0;
+    
+    /*!
+     * design variable bounds, asymptotes and subproblem bounds for local design
+     * variables
+     */
+    std::vector<real_t> xmin, xmax, low, upp, alfa, beta;
+    
+    /*!
+     * coefficients of \f$ z \f$ and \f$ y_i \f$ in the problem statement
+     */
+    std::vector<real_t> a, c, d;
+    
+    /*!
+     * GCMMA parameters for conservative approximations
+     */
+    real_t              raa0;
+    std::vector<real_t> raa;
+    
+    /*!
+     * values of the approximate objective and constraint functions at the
+     * subproblem solution
+     */
+    real_t              f0app;
+    std::vector<real_t> fapp;
+    
+    
+    /*!
+     * initializes the data for \p n local design variables and \p m constraints.
+     * The values of \p c are set to \p c_val and of \p d to unity.
+     */
+    inline void init(std::size_t n, uint_t m, real_t c_val) {
+        
+        _n = n;
+        _m = m;
+        
+        for (auto v: {&xmin, &xmax, &low, &upp, &alfa, &beta})
+            v->assign(n, 0.);
+        
+        a.assign(m, 0.);
+        c.assign(m, c_val);
+        d.assign(m, 1.);
+        raa.assign(m, raaeps);
+        fapp.assign(m, 0.);
+        raa0 = raa0eps;
+        
+        _p0.assign(n, 0.);
+        _q0.assign(n, 0.);
+        _P.assign(n*m, 0.);
+        _Q.assign(n*m, 0.);
+        _b.assign(m, 0.);
+        _r0 = 0.;
+    }
+    
+    
+    /*!
+     * updates the asymptotes, the subproblem bounds and the initial values of the GCMMA
+     * parameters at the outer iteration \p iter, starting at 1, from the current and
+     * previous two designs and the gradients at the current design
+     */
+    inline void update_asymptotes(uint_t                     iter,
+                                  const std::vector<real_t> &xval,
+                                  const std::vector<real_t> &xold1,
+                                  const std::vector<real_t> &xold2,
+                                  const std::vector<real_t> &df0dx,
+                                  const std::vector<real_t> &dfdx) {
+        
+        _check_size(xval, _n);
+        _check_size(dfdx, _n*_m);
+        
+        // the first m entries are used for raa, followed by raa0
+        std::vector<real_t>
+        v(_m+1, 0.);
+        
+        real_t
+        *pv = v.data();
+        
+        const uint_t
+        m   = _m;
+        
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:pv[:m+1])
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            const real_t
+            xmami = _xmami(j);
+            
+            pv[m] += std::fabs(df0dx[j]) * xmami;
+            for (uint_t i=0; i<m; i++)
+                pv[i] += std::fabs(dfdx[j*m+i]) * xmami;
+            
+            if (iter < 3) {
+                
+                low[j] = xval[j] - asymptote_init * xmami;
+                upp[j] = xval[j] + asymptote_init * xmami;
+            }
+            else {
+                
+                real_t
+                xxx    = (xval[j]-xold1[j])*(xold1[j]-xold2[j]),
+                factor = 1.;
+                
+                if      (xxx > 0.) factor = asymptote_expansion;
+                else if (xxx < 0.) factor = asymptote_reduction;
+                
+                low[j] = xval[j] - factor * (xold1[j] - low[j]);
+                upp[j] = xval[j] + factor * (upp[j] - xold1[j]);
+                
+                low[j] = std::min(std::max(low[j], xval[j] - 10.*xmami), xval[j] - 0.01*xmami);
+                upp[j] = std::max(std::min(upp[j], xval[j] + 10.*xmami), xval[j] + 0.01*xmami);
+            }
+            
+            // bounds of the subproblem
+            alfa[j] = std::max(std::max(low[j] + albefa*(xval[j]-low[j]),
+                                        xval[j] - move_limit*(xmax[j]-xmin[j])),
+                               xmin[j]);
+            beta[j] = std::min(std::min(upp[j] - albefa*(upp[j]-xval[j]),
+                                        xval[j] + move_limit*(xmax[j]-xmin[j])),
+                               xmax[j]);
+        }
+        
+        _sum(v);
+        
+        const real_t
+        n_global = _global_size();
+        
+        raa0 = std::max(raa0eps, 0.1/n_global * v[_m]);
+        for (uint_t i=0; i<_m; i++)
+            raa[i] = std::max(raaeps, 0.1/n_global * v[i]);
+    }
+    
+    
+    /*!
+     * computes the approximations at \p xval using the current asymptotes and GCMMA
+     * parameters, and solves the subproblem for \p xmma. The values of the approximations
+     * at \p xmma are stored in \p f0app and \p fapp.
+     */
+    inline void solve(const std::vector<real_t> &xval,
+                      real_t                     f0val,
+                      const std::vector<real_t> &df0dx,
+                      const std::vector<real_t> &fval,
+                      const std::vector<real_t> &dfdx,
+                      std::vector<real_t>       &xmma) {
+        
+        _check_size(xval,  _n);
+        _check_size(df0dx, _n);
+        _check_size(fval,  _m);
+        _check_size(dfdx,  _n*_m);
+        
+        xmma.resize(_n);
+        
+        // the first m entries are used for r, followed by r0
+        std::vector<real_t>
+        r(_m+1, 0.);
+        
+        real_t
+        *pr = r.data();
+        
+        const uint_t
+        m   = _m;
+        
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:pr[:m+1])
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            const real_t
+            xmamiinv = 1./_xmami(j),
+            ux1      = upp[j] - xval[j],
+            xl1      = xval[j] - low[j],
+            ux2      = ux1*ux1,
+            xl2      = xl1*xl1;
+            
+            _approximation_coeffs(df0dx[j], raa0, xmamiinv, ux2, xl2, _p0[j], _q0[j]);
+            pr[m] += _p0[j]/ux1 + _q0[j]/xl1;
+            
+            for (uint_t i=0; i<m; i++) {
+                
+                const std::size_t
+                k = j*m+i;
+                
+                _approximation_coeffs(dfdx[k], raa[i], xmamiinv, ux2, xl2, _P[k], _Q[k]);
+                pr[i] += _P[k]/ux1 + _Q[k]/xl1;
+            }
+        }
+        
+        _sum(r);
+        
+        _r0 = f0val - r[_m];
+        for (uint_t i=0; i<_m; i++)
+            _b[i] = r[i] - fval[i];
+        
+        _subsolve();
+        
+        xmma = _x;
+        
+        // approximations at the solution
+        std::fill(r.begin(), r.end(), 0.);
+        
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:pr[:m+1])
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            const real_t
+            uxinv = 1./(upp[j] - xmma[j]),
+            xlinv = 1./(xmma[j] - low[j]);
+            
+            pr[m] += _p0[j]*uxinv + _q0[j]*xlinv;
+            for (uint_t i=0; i<m; i++)
+                pr[i] += _P[j*m+i]*uxinv + _Q[j*m+i]*xlinv;
+        }
+        
+        _sum(r);
+        
+        f0app = _r0 + r[_m];
+        for (uint_t i=0; i<_m; i++)
+            fapp[i] = r[i] - _b[i];
+    }
+    
+    
+    /*!
+     * @returns \p true if the approximations at the subproblem solution are
+     * conservative, that is, they are not smaller than the function values \p f0new and
+     * \p fnew at the solution.
+     */
+    inline bool is_conservative(real_t                     f0new,
+                                const std::vector<real_t> &fnew) const {
+        
+        bool
+        conserv = (f0app + epsimin >= f0new);
+        
+        for (uint_t i=0; i<_m; i++)
+            conserv = conserv && (fapp[i] + epsimin >= fnew[i]);
+        
+        return conserv;
+    }
+    
+    
+    /*!
+     * updates the GCMMA parameters for functions that were not approximated
+     * conservatively at \p xmma.
+     */
+    inline void update_raa(const std::vector<real_t> &xmma,
+                           const std::vector<real_t> &xval,
+                           real_t                     f0new,
+                           const std::vector<real_t> &fnew) {
+        
+        real_t
+        raacof = 0.;
+        
+#ifdef _OPENMP
+#pragma omp parallel for simd reduction(+:raacof)
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            const real_t
+            xxux = (xmma[j]-xval[j])/(upp[j]-xmma[j]),
+            xxxl = (xmma[j]-xval[j])/(xmma[j]-low[j]);
+            
+            raacof += xxux*xxxl * (upp[j]-low[j])/_xmami(j);
+        }
+        
+        _sum(raacof);
+        raacof = std::max(raacof, 1.e-12);
+        
+        if (f0new > f0app + 0.5*epsimin)
+            raa0 = std::min(1.1*(raa0 + (f0new-f0app)/raacof), 10.*raa0);
+        
+        for (uint_t i=0; i<_m; i++)
+            if (fnew[i] > fapp[i] + 0.5*epsimin)
+                raa[i] = std::min(1.1*(raa[i] + (fnew[i]-fapp[i])/raacof), 10.*raa[i]);
+    }
+    
+    
+private:
+    
+    inline void _check_size(const std::vector<real_t> &v, std::size_t n) const {
+        
+        Assert2(v.size() == n, v.size(), n, "Incompatible vector size");
+    }
+    
+    
+    inline real_t _xmami(std::size_t j) const {
+        
+        return std::max(xmax[j]-xmin[j], 1.e-5);
+    }
+    
+    
+    /*!
+     * coefficients \f$ p \f$ and \f$ q \f$ of the approximation of a function with
+     * derivative \p df with respect to a variable.
+     */
+    static inline void
+    _approximation_coeffs(real_t  df,
+                          real_t  raa,
+                          real_t  xmamiinv,
+                          real_t  ux2,
+                          real_t  xl2,
+                          real_t &p,
+                          real_t &q) {
+        
+        p = std::max( df, 0.);
+        q = std::max(-df, 0.);
+        
+        const real_t
+        pq = 0.001*(p+q) + raa*xmamiinv;
+        
+        p = (p + pq) * ux2;
+        q = (q + pq) * xl2;
+    }
+    
+    
+    inline real_t _global_size() const {
+        
+        real_t
+        n = _n;
+        
+        _sum(n);
+        return n;
+    }
+    
+    
+    inline void _sum(real_t &v) const { if (_comm) _comm->sum(v);}
+    
+    inline void _sum(std::vector<real_t> &v) const { if (_comm) _comm->sum(v);}
+    
+    inline void _max(real_t &v) const { if (_comm) _comm->max(v);}
+    
+    
+    /*!
+     * computes the residual of the perturbed KKT conditions of the subproblem at the
+     * current point for the perturbation \p epsi. The 2-norm and max-norm of the
+     * residual are returned in \p norm and \p norm_max.
+     */
+    inline void _residual(real_t  epsi,
+                          real_t &norm,
+                          real_t &norm_max) const {
+        
+        // the first m entries are used for gvec, followed by the squared norm of
+        // the residual for the local variables
+        std::vector<real_t>
+        gvec(_m+1, 0.);
+        
+        real_t
+        *pg     = gvec.data(),
+        n_max   = 0.;
+        
+        const uint_t
+        m       = _m;
+        
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:pg[:m+1]) reduction(max:n_max)
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            const real_t
+            ux1 = upp[j] - _x[j],
+            xl1 = _x[j] - low[j];
+            
+            real_t
+            plam = _p0[j],
+            qlam = _q0[j];
+            
+            for (uint_t i=0; i<m; i++) {
+                
+                plam  += _P[j*m+i]*_lam[i];
+                qlam  += _Q[j*m+i]*_lam[i];
+                pg[i] += _P[j*m+i]/ux1 + _Q[j*m+i]/xl1;
+            }
+            
+            const real_t
+            rex   = plam/(ux1*ux1) - qlam/(xl1*xl1) - _xsi[j] + _eta[j],
+            rexsi = _xsi[j]*(_x[j]-alfa[j]) - epsi,
+            reeta = _eta[j]*(beta[j]-_x[j]) - epsi;
+            
+            pg[m] += rex*rex + rexsi*rexsi + reeta*reeta;
+            n_max  = std::max(n_max, std::max(std::fabs(rex),
+                                              std::max(std::fabs(rexsi), std::fabs(reeta))));
+        }
+        
+        _sum(gvec);
+        _max(n_max);
+        
+        real_t
+        rez   = a0 - _zet,
+        rezet = _zet*_z - epsi;
+        
+        norm     = gvec[_m];
+        norm_max = n_max;
+        
+        for (uint_t i=0; i<_m; i++) {
+            
+            rez -= a[i]*_lam[i];
+            
+            const real_t
+            rey   = c[i] + d[i]*_y[i] - _mu[i] - _lam[i],
+            relam = gvec[i] - a[i]*_z - _y[i] + _s[i] - _b[i],
+            remu  = _mu[i]*_y[i] - epsi,
+            res   = _lam[i]*_s[i] - epsi;
+            
+            norm    += rey*rey + relam*relam + remu*remu + res*res;
+            norm_max = std::max(norm_max,
+                                std::max(std::max(std::fabs(rey), std::fabs(relam)),
+                                         std::max(std::fabs(remu), std::fabs(res))));
+        }
+        
+        norm    += rez*rez + rezet*rezet;
+        norm_max = std::max(norm_max, std::max(std::fabs(rez), std::fabs(rezet)));
+        norm     = std::sqrt(norm);
+    }
+    
+    
+    /*!
+     * primal-dual interior point solution of the subproblem
+     */
+    inline void _subsolve() {
+        
+        real_t
+        epsi = 1.;
+        
+        _x.resize(_n);
+        _xsi.resize(_n);
+        _eta.resize(_n);
+        _dx.resize(_n);
+        _dxsi.resize(_n);
+        _deta.resize(_n);
+        _GG.resize(_n*_m);
+        
+        const uint_t
+        m = _m;
+        
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+        for (std::size_t j=0; j<_n; j++) {
+            
+            _x[j]   = 0.5*(alfa[j]+beta[j]);
+            _xsi[j] = std::max(1./(_x[j]-alfa[j]), 1.);
+            _eta[j] = std::max(1./(beta[j]-_x[j]), 1.);
+        }
+        
+        _y.assign(_m, 1.);
+        _lam.assign(_m, 1.);
+        _s.assign(_m, 1.);
+        _mu.resize(_m);
+        for (uint_t i=0; i<_m; i++) _mu[i] = std::max(1., 0.5*c[i]);
+        _z   = 1.;
+        _zet = 1.;
+        
+        // unknowns of the reduced Newton system are the m multipliers and z
+        Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>
+        AA(_m+1, _m+1);
+        Eigen::Matrix<real_t, Eigen::Dynamic, 1>
+        bb(_m+1),
+        sol;
+        
+        std::vector<real_t>
+        delx(_n),
+        diagx(_n),
+        red,
+        dy(_m), dlam(_m), dmu(_m), ds(_m),
+        x0, xsi0, eta0, y0, lam0, mu0, s0;
+        
+        real_t
+        norm     = 0.,
+        norm_max = 0.,
+        dz       = 0.,
+        dzet     = 0.;
+        
+        while (epsi > epsimin) {
+            
+            _residual(epsi, norm, norm_max);
+            
+            uint_t
+            iter = 0;
+            
+            while (norm_max > 0.9*epsi && iter < 200) {
+                
+                iter++;
+                
+                // the reduction vector stores gvec, G delx/diagx and G diag(1/diagx) G^T.
+                // The last entry is unused and keeps the reduction well-defined for m = 0.
+                red.assign(_m*(_m+2)+1, 0.);
+                
+                real_t
+                *pred = red.data();
+                
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:pred[:m*(m+2)+1])
+#endif
+                for (std::size_t j=0; j<_n; j++) {
+                    
+                    const real_t
+                    ux1 = upp[j] - _x[j],
+                    xl1 = _x[j] - low[j],
+                    ux2 = ux1*ux1,
+                    xl2 = xl1*xl1;
+                    
+                    real_t
+                    plam = _p0[j],
+                    qlam = _q0[j];
+                    
+                    for (uint_t i=0; i<m; i++) {
+                        
+                        const std::size_t
+                        k = j*m+i;
+                        
+                        plam    += _P[k]*_lam[i];
+                        qlam    += _Q[k]*_lam[i];
+                        pred[i] += _P[k]/ux1 + _Q[k]/xl1;
+                        _GG[k]   = _P[k]/ux2 - _Q[k]/xl2;
+                    }
+                    
+                    delx[j]  =
+                    plam/ux2 - qlam/xl2 - epsi/(_x[j]-alfa[j]) + epsi/(beta[j]-_x[j]);
+                    diagx[j] =
+                    2.*(plam/(ux2*ux1) + qlam/(xl2*xl1)) +
+                    _xsi[j]/(_x[j]-alfa[j]) + _eta[j]/(beta[j]-_x[j]);
+                    
+                    const real_t
+                    *G = &_GG[j*m];
+                    
+                    for (uint_t i=0; i<m; i++) {
+                        
+                        pred[m+i] += G[i] * delx[j]/diagx[j];
+                        for (uint_t l=0; l<m; l++)
+                            pred[2*m+i*m+l] += G[i] * G[l]/diagx[j];
+                    }
+                }
+                
+                _sum(red);
+                
+                real_t
+                delz = a0 - epsi/_z;
+                
+                for (uint_t i=0; i<_m; i++) {
+                    
+                    const real_t
+                    dely      = c[i] + d[i]*_y[i] - _lam[i] - epsi/_y[i],
+                    dellam    = red[i] - a[i]*_z - _y[i] - _b[i] + epsi/_lam[i],
+                    diagy     = d[i] + _mu[i]/_y[i],
+                    diaglamyi = _s[i]/_lam[i] + 1./diagy;
+                    
+                    delz  -= a[i]*_lam[i];
+                    bb(i)  = dellam + dely/diagy - red[_m+i];
+                    
+                    for (uint_t l=0; l<_m; l++)
+                        AA(i, l) = red[2*_m+i*_m+l];
+                    AA(i, i) += diaglamyi;
+                    AA(i, _m) = a[i];
+                    AA(_m, i) = a[i];
+                }
+                
+                AA(_m, _m) = -_zet/_z;
+                bb(_m)     = delz;
+                
+                sol = AA.partialPivLu().solve(bb);
+                
+                dz = sol(_m);
+                
+                // steps for the variables, and the maximum step to stay within bounds
+                real_t
+                stmax = 1.;
+                
+                for (uint_t i=0; i<_m; i++) {
+                    
+                    const real_t
+                    dely  = c[i] + d[i]*_y[i] - _lam[i] - epsi/_y[i],
+                    diagy = d[i] + _mu[i]/_y[i];
+                    
+                    dlam[i] = sol(i);
+                    dy[i]   = -dely/diagy + dlam[i]/diagy;
+                    dmu[i]  = -_mu[i] + epsi/_y[i] - _mu[i]*dy[i]/_y[i];
+                    ds[i]   = -_s[i] + epsi/_lam[i] - _s[i]*dlam[i]/_lam[i];
+                    
+                    stmax = std::max(stmax, -1.01*dy[i]/_y[i]);
+                    stmax = std::max(stmax, -1.01*dlam[i]/_lam[i]);
+                    stmax = std::max(stmax, -1.01*dmu[i]/_mu[i]);
+                    stmax = std::max(stmax, -1.01*ds[i]/_s[i]);
+                }
+                
+                dzet  = -_zet + epsi/_z - _zet*dz/_z;
+                stmax = std::max(stmax, -1.01*dz/_z);
+                stmax = std::max(stmax, -1.01*dzet/_zet);
+                
+                real_t
+                stmax_n = 0.;
+                
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:stmax_n)
+#endif
+                for (std::size_t j=0; j<_n; j++) {
+                    
+                    real_t
+                    v = delx[j];
+                    for (uint_t i=0; i<m; i++)
+                        v += _GG[j*m+i]*dlam[i];
+                    
+                    _dx[j]   = -v/diagx[j];
+                    _dxsi[j] = -_xsi[j] + (epsi - _xsi[j]*_dx[j])/(_x[j]-alfa[j]);
+                    _deta[j] = -_eta[j] + (epsi + _eta[j]*_dx[j])/(beta[j]-_x[j]);
+                    
+                    stmax_n = std::max(stmax_n, -1.01*_dx[j]/(_x[j]-alfa[j]));
+                    stmax_n = std::max(stmax_n,  1.01*_dx[j]/(beta[j]-_x[j]));
+                    stmax_n = std::max(stmax_n, -1.01*_dxsi[j]/_xsi[j]);
+                    stmax_n = std::max(stmax_n, -1.01*_deta[j]/_eta[j]);
+                }
+                
+                _max(stmax_n);
+                
+                real_t
+                step   = 1./std::max(stmax, stmax_n),
+                z0     = _z,
+                zet0   = _zet,
+                norm0  = norm;
+                
+                x0   = _x;   xsi0 = _xsi; eta0 = _eta;
+                y0   = _y;   lam0 = _lam; mu0  = _mu;  s0 = _s;
+                
+                // line search to reduce the residual norm
+                uint_t
+                ls_iter = 0;
+                norm    = 2.*norm0;
+                
+                while (norm > norm0 && ls_iter < 50) {
+                    
+                    ls_iter++;
+                    
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+                    for (std::size_t j=0; j<_n; j++) {
+                        
+                        _x[j]   = x0[j]   + step*_dx[j];
+                        _xsi[j] = xsi0[j] + step*_dxsi[j];
+                        _eta[j] = eta0[j] + step*_deta[j];
+                    }
+                    
+                    for (uint_t i=0; i<_m; i++) {
+                        
+                        _y[i]   = y0[i]   + step*dy[i];
+                        _lam[i] = lam0[i] + step*dlam[i];
+                        _mu[i]  = mu0[i]  + step*dmu[i];
+                        _s[i]   = s0[i]   + step*ds[i];
+                    }
+                    
+                    _z   = z0   + step*dz;
+                    _zet = zet0 + step*dzet;
+                    
+                    _residual(epsi, norm, norm_max);
+                    
+                    step /= 2.;
+                }
+            }
+            
+            epsi *= 0.1;
+        }
+    }
+    
+    
+    const libMesh::Parallel::Communicator *_comm;
+    
+    std::size_t           _n;
+    uint_t                _m;
+    
+    // coefficients of the approximations
+    real_t                _r0;
+    std::vector<real_t>   _p0, _q0, _P, _Q, _b;
+    
+    // variables of the subproblem and their Newton steps
+    real_t                _z, _zet;
+    std::vector<real_t>   _x, _xsi, _eta, _y, _lam, _mu, _s;
+    std::vector<real_t>   _dx, _dxsi, _deta, _GG;
+};
+
+} // namespace Solvers
+} // namespace Optimization
+} // namespace MAST
+
+#endif // __mast_gcmma_subproblem_h__
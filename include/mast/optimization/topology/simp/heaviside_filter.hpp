@@ -20,6 +20,9 @@
 #ifndef __mast_simp_heaviside_filter_h__
 #define __mast_simp_heaviside_filter_h__
 
+// C++ includes
+#include <vector>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
@@ -32,6 +35,8 @@ namespace SIMP {
 /*!
  * This class implements the Heaviside filter defined as
  * \f[ \tilde{v} =  \frac{\tanh(\beta \eta) + \tanh(\beta(v-\eta)) }{\tanh (\beta \eta) + \tanh (\beta(1-\eta)) } \f]
+ * The terms that depend only on \f$ \beta \f$ and \f$ \eta \f$ are computed in
+ * \p set_parameters(), so that each evaluation requires a single \f$ \tanh \f$.
  */
 template <typename ScalarType, typename FieldType>
 class HeavisideFilter {
@@ -39,9 +44,11 @@ class HeavisideFilter {
 public:
     
     HeavisideFilter():
-    _beta   (0.),
-    _eta    (0.),
-    _v    (nullptr)
+    _beta      (0.),
+    _eta       (0.),
+    _tanh_eta  (0.),
+    _inv_denom (0.),
+    _v         (nullptr)
     { }
     
     virtual ~HeavisideFilter() {}
@@ -50,8 +57,10 @@ public:
     
     inline void set_parameters(const real_t beta, const real_t eta) {
         
-        _beta = beta;
-        _eta  = eta;
+        _beta      = beta;
+        _eta       = eta;
+        _tanh_eta  = tanh(_beta*_eta);
+        _inv_denom = 1./(_tanh_eta+tanh(_beta*(1.-_eta)));
     }
     
     /*!
@@ -59,8 +68,7 @@ public:
      */
     inline ScalarType filter(ScalarType s) const {
         
-        return ((tanh(_beta*_eta)+tanh(_beta*(s-_eta))) /
-                (tanh(_beta*_eta)+tanh(_beta*(1.-_eta))));
+        return (_tanh_eta+tanh(_beta*(s-_eta))) * _inv_denom;
     }
 
     
@@ -70,8 +78,51 @@ public:
     inline ScalarType filter_derivative(ScalarType s,
                                         ScalarType ds) const {
         
-        return ((1.-pow(tanh(_beta*(s-_eta)),2))* _beta * ds /
-                (tanh(_beta*_eta)+tanh(_beta*(1.-_eta))));
+        const ScalarType
+        t = tanh(_beta*(s-_eta));
+        
+        return (1.-t*t) * _beta * _inv_denom * ds;
+    }
+
+    /*!
+     * computes the filtered values \p v_f and the derivatives of the filtered values
+     * \p dv_f with respect to the values in \p v. This is used to project all nodal
+     * values once per design update, so that the projected values and derivatives can be
+     * reused by all subsequent computations for the same design.
+     */
+    inline void project(const std::vector<ScalarType> &v,
+                        std::vector<ScalarType>       &v_f,
+                        std::vector<ScalarType>       &dv_f) const {
+        
+        const uint_t
+        n    = v.size();
+        
+        v_f.resize(n);
+        dv_f.resize(n);
+        
+        const ScalarType
+        *pv  = v.data();
+        ScalarType
+        *pf  = v_f.data(),
+        *pdf = dv_f.data();
+        
+        const real_t
+        beta = _beta,
+        eta  = _eta,
+        t0   = _tanh_eta,
+        c    = _inv_denom;
+        
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+        for (uint_t i=0; i<n; i++) {
+            
+            const ScalarType
+            t = tanh(beta*(pv[i]-eta));
+            
+            pf[i]  = (t0+t) * c;
+            pdf[i] = (1.-t*t) * beta * c;
+        }
     }
 
     /*!
@@ -83,8 +134,7 @@ public:
         
         Assert0(_v, "Scalar field not initialized");
         
-        return ((tanh(_beta*_eta)+tanh(_beta*(_v->value(c)-_eta))) /
-                (tanh(_beta*_eta)+tanh(_beta*(1.-_eta))));
+        return this->filter(_v->value(c));
     }
 
     /*!
@@ -96,9 +146,7 @@ public:
         
         Assert0(_v, "Scalar field not initialized");
 
-        return ((1.-pow(tanh(_beta*(_v->value(c)-_eta)),2))*
-                _beta*_v->derivative(c, f) /
-                (tanh(_beta*_eta)+tanh(_beta*(1.-_eta))));
+        return this->filter_derivative(_v->value(c), _v->derivative(c, f));
     }
 
     
@@ -106,6 +154,8 @@ private:
     
     real_t                   _beta;
     real_t                   _eta;
+    real_t                   _tanh_eta;
+    real_t                   _inv_denom;
     const FieldType         *_v;
 };
 } // namespace SIMP
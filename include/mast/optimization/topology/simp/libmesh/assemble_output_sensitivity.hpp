@@ -27,6 +27,7 @@
 #include <mast/base/assembly/libmesh/accessor.hpp>
 #include <mast/numerics/utility.hpp>
 #include <mast/optimization/design_parameter_vector.hpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
 #include <mast/mesh/libmesh/utility.hpp>
 
 // libMesh includes
@@ -57,7 +58,8 @@ public:
     
     AssembleOutputSensitivity():
     _e_ops        (nullptr),
-    _output_e_ops (nullptr)
+    _output_e_ops (nullptr),
+    _dv_map       (nullptr)
     { }
     
     virtual ~AssembleOutputSensitivity() {}
@@ -68,10 +70,23 @@ public:
         _e_ops        = &e_ops;
         _output_e_ops = &output_ops;
     }
+    
+    /*!
+     * sets the map from design parameters to density dofs, which defines the layout
+     * of the sensitivity vector computed by \p assemble().
+     */
+    inline void
+    set_design_parameter_map(const MAST::Optimization::Utility::DesignParameterMap<ScalarType> &m) {
+        
+        _dv_map = &m;
+    }
 
     /*!
      *  output derivative is defined as a
      * \f[ \frac{dQ}{d\alpha} = \frac{\partial Q}{\partial \alpha} + \lambda^T \frac{\partial R}{\partial \alpha} \f]
+     * The contributions of local elements are added to a distributed vector whose assembly
+     * sends off-process contributions to their owning ranks, from where the values are
+     * copied to \p sens in the layout of the design parameter map.
      */
     template <typename Vec1Type,
               typename Vec2Type,
@@ -86,19 +101,15 @@ public:
                          std::vector<ScalarType>   &sens) {
                 
         Assert0(_e_ops && _output_e_ops, "Elem Operation objects not initialized");
+        Assert0(_dv_map, "Design parameter map not set");
         Assert2(density.size() == c.rho_sys->n_dofs(),
                 density.size(), c.rho_sys->n_dofs(),
                 "Density coefficients must be provided for whole mesh");
-        Assert2(dvs.size() == sens.size(),
-                dvs.size(), sens.size(),
-                "DV and sensitivity vectors must have same size");
            
         uint_t
         n_density_dofs = c.rho_sys->n_dofs(),
         n_nodes        = 0;
 
-        MAST::Numerics::Utility::setZero(sens);
-
         std::unique_ptr<Vec2Type>
         v (MAST::Numerics::Utility::build<Vec2Type>(*c.rho_sys).release()),
         v_filtered (MAST::Numerics::Utility::build<Vec2Type>(*c.rho_sys).release());
@@ -194,19 +205,14 @@ public:
         filter.compute_reverse_filtered_values(*v, *v_filtered);
 
         // copy the results back to sens
-        for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++) {
-
-            idx = dvs.get_data_for_parameter(dvs[i]).template get<int>("dof_id");
-            sens[i] = MAST::Numerics::Utility::get(*v_filtered, idx);
-        }
-        
-        MAST::Numerics::Utility::comm_sum(c.rho_sys->comm(), sens);
+        _dv_map->gather(*v_filtered, sens);
     }
 
 private:
   
     ResidualElemOpsType  *_e_ops;
     OutputElemOpsType    *_output_e_ops;
+    const MAST::Optimization::Utility::DesignParameterMap<ScalarType> *_dv_map;
 };
 
 } // namespace libMeshWrapper
@@ -0,0 +1,127 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __mast_optimization_topology_simp_libmesh_projected_density_h__
+#define __mast_optimization_topology_simp_libmesh_projected_density_h__
+
+// C++ includes
+#include <memory>
+#include <vector>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+
+// libMesh includes
+#include <libmesh/numeric_vector.h>
+
+
+namespace MAST {
+namespace Optimization {
+namespace Topology {
+namespace SIMP {
+namespace libMeshWrapper {
+
+/*!
+ * Stores the nodal density vector after projection by \p FilterType, and the derivative
+ * of the projected density with respect to the nodal density. \p update() should be
+ * called once per design update, after which the projected values and derivatives are
+ * available to all computations that use nodal densities without evaluating the
+ * projection again. The vectors are cloned from the density vector, so that ghosted
+ * values are also available if the density vector is ghosted.
+ */
+template <typename ScalarType, typename FilterType>
+class ProjectedDensity {
+
+public:
+
+    ProjectedDensity(const FilterType &filter):
+    _filter  (filter)
+    { }
+
+    virtual ~ProjectedDensity() { }
+
+    /*!
+     * projects the local values of \p density and updates the ghosted values of the
+     * projected vectors.
+     */
+    inline void update(const libMesh::NumericVector<ScalarType> &density) {
+
+        if (!_v || _v->size() != density.size() ||
+            _v->local_size() != density.local_size()) {
+
+            _v.reset(density.zero_clone().release());
+            _dv.reset(density.zero_clone().release());
+        }
+
+        const uint_t
+        first = density.first_local_index(),
+        n     = density.local_size();
+
+        _dof_ids.resize(n);
+        for (uint_t i=0; i<n; i++) _dof_ids[i] = first + i;
+
+        density.get(_dof_ids, _vals);
+        _filter.project(_vals, _vals_f, _dvals_f);
+
+        _v->insert(_vals_f, _dof_ids);
+        _dv->insert(_dvals_f, _dof_ids);
+        _v->close();
+        _dv->close();
+    }
+
+    inline bool is_initialized() const { return _v.get() != nullptr;}
+
+    /*!
+     * @returns the projected density vector
+     */
+    inline const libMesh::NumericVector<ScalarType>& values() const {
+
+        Assert0(_v, "Projected density not initialized");
+        return *_v;
+    }
+
+    /*!
+     * @returns the derivative of the projected density with respect to the density
+     */
+    inline const libMesh::NumericVector<ScalarType>& derivatives() const {
+
+        Assert0(_dv, "Projected density not initialized");
+        return *_dv;
+    }
+
+private:
+
+    const FilterType                                    &_filter;
+    std::unique_ptr<libMesh::NumericVector<ScalarType>>  _v;
+    std::unique_ptr<libMesh::NumericVector<ScalarType>>  _dv;
+    std::vector<libMesh::numeric_index_type>             _dof_ids;
+    std::vector<ScalarType>                              _vals;
+    std::vector<ScalarType>                              _vals_f;
+    std::vector<ScalarType>                              _dvals_f;
+};
+
+}  // namespace libMeshWrapper
+}  // namespace SIMP
+}  // namespace Topology
+}  // namespace Optimization
+}  // namespace MAST
+
+
+#endif // __mast_optimization_topology_simp_libmesh_projected_density_h__
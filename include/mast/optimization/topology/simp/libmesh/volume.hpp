@@ -20,11 +20,17 @@
 #ifndef __mast_optimization_topology_simp_libmesh_volume_h__
 #define __mast_optimization_topology_simp_libmesh_volume_h__
 
+// C++ includes
+#include <vector>
+#include <algorithm>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
 #include <mast/numerics/utility.hpp>
 #include <mast/mesh/libmesh/utility.hpp>
+#include <mast/optimization/topology/simp/libmesh/projected_density.hpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
 
 // libMesh includes
 #include <libmesh/nonlinear_implicit_system.h>
@@ -38,30 +44,44 @@ namespace Topology {
 namespace SIMP {
 namespace libMeshWrapper {
 
+/*!
+ * Computes the volume of the material defined by the nodal density values, and its
+ * sensitivity with respect to design parameters. The volume of each element is computed
+ * from the average of the density values at its linear basis nodes. The contribution of
+ * each density dof to the volume, \f$ w_j = \sum_e V_e / n_e \f$, is computed from the
+ * local elements at the first use and cached, so that the volume and its derivative
+ * are each obtained with a single pass over the density dofs. \p clear() must be called
+ * if the mesh is changed.
+ */
 template <typename ScalarType>
 class Volume {
     
 public:
     
-    Volume() {}
+    Volume():
+    _initialized (false),
+    _dv_map      (nullptr)
+    { }
+    
     virtual ~Volume() {}
     
-    template <typename VecType, typename ContextType>
-    inline ScalarType compute(ContextType& c,
-                              const VecType &density) const {
-        
-        ScalarType
-        volume = 0.,
-        rho    = 0.;
+    /*!
+     * computes the contribution of each density dof to the volume from the local elements.
+     */
+    template <typename ContextType>
+    inline void init(ContextType& c) const {
         
         uint_t
         sys_num = c.rho_sys->number(),
         n_nodes = 0;
         
-        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
-        density_accessor (*c.rho_sys, density);
+        real_t
+        e_vol   = 0.;
+        
+        std::vector<std::pair<libMesh::dof_id_type, real_t>>
+        w;
         
-        libMesh::MeshBase::element_iterator
+        libMesh::MeshBase::const_element_iterator
         it    =  c.mesh->active_local_elements_begin(),
         end   =  c.mesh->active_local_elements_end();
         
@@ -69,26 +89,68 @@ public:
             
             const libMesh::Elem& e = **it;
             
-            // compute the average element density value
-            rho = 0.;
-            
             n_nodes = MAST::Mesh::libMeshWrapper::Utility::n_linear_basis_nodes_on_elem(e);
+            e_vol   = e.volume() / (1. * n_nodes);
             
-            for (uint_t i=0; i<n_nodes; i++) {
-                
-                const libMesh::Node& n = *e.node_ptr(i);
+            for (uint_t i=0; i<n_nodes; i++)
+                w.push_back(std::make_pair(e.node_ptr(i)->dof_number(sys_num, 0, 0), e_vol));
+        }
+        
+        // combine the contributions of all elements sharing a node
+        std::sort(w.begin(), w.end());
+        
+        _dof_ids.clear();
+        _weights.clear();
+        
+        for (uint_t i=0; i<w.size(); i++) {
+            
+            if (_dof_ids.empty() || _dof_ids.back() != w[i].first) {
                 
-                rho +=
-                MAST::Numerics::Utility::get(density,
-                                             n.dof_number(sys_num, 0, 0));
+                _dof_ids.push_back(w[i].first);
+                _weights.push_back(0.);
             }
             
-            rho /= (1. * n_nodes);
-            
-            // use this density value to compute the volume
-            volume  +=  e.volume() * rho;
+            _weights.back() += w[i].second;
         }
         
+        _initialized = true;
+    }
+    
+    
+    /*!
+     * sets the map from design parameters to density dofs, which defines the dof IDs
+     * and the layout of the sensitivity vectors computed by \p derivative().
+     */
+    inline void
+    set_design_parameter_map(const MAST::Optimization::Utility::DesignParameterMap<ScalarType> &m) {
+        
+        _dv_map = &m;
+    }
+    
+    
+    /*!
+     * clears the cached data. This should be called if the mesh is modified.
+     */
+    inline void clear() {
+        
+        _dof_ids.clear();
+        _weights.clear();
+        _initialized = false;
+    }
+    
+    
+    template <typename VecType, typename ContextType>
+    inline ScalarType compute(ContextType& c,
+                              const VecType &density) const {
+        
+        if (!_initialized) this->init(c);
+        
+        ScalarType
+        volume = 0.;
+        
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            volume += _weights[i] * MAST::Numerics::Utility::get(density, _dof_ids[i]);
+        
         MAST::Numerics::Utility::comm_sum(c.rho_sys->comm(), volume);
         
         return volume;
@@ -100,43 +162,14 @@ public:
                               const VecType           &density,
                               const DensityFilterType &filter) const {
         
-        ScalarType
-        volume = 0.,
-        rho    = 0.;
-        
-        uint_t
-        sys_num = c.rho_sys->number(),
-        n_nodes = 0;
+        if (!_initialized) this->init(c);
         
-        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
-        density_accessor (*c.rho_sys, density);
+        ScalarType
+        volume = 0.;
         
-        libMesh::MeshBase::element_iterator
-        it    =  c.mesh->active_local_elements_begin(),
-        end   =  c.mesh->active_local_elements_end();
-        
-        for ( ; it != end; it++) {
-            
-            const libMesh::Elem& e = **it;
-            
-            // compute the average element density value
-            rho = 0.;
-            
-            n_nodes = MAST::Mesh::libMeshWrapper::Utility::n_linear_basis_nodes_on_elem(e);
-            
-            for (uint_t i=0; i<n_nodes; i++) {
-                
-                const libMesh::Node& n = *e.node_ptr(i);
-                
-                rho += filter.filter(MAST::Numerics::Utility::get
-                                     (density, n.dof_number(sys_num, 0, 0)));
-            }
-            
-            rho /= (1. * n_nodes);
-            
-            // use this density value to compute the volume
-            volume  +=  e.volume() * rho;
-        }
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            volume += _weights[i] *
+            filter.filter(MAST::Numerics::Utility::get(density, _dof_ids[i]));
         
         MAST::Numerics::Utility::comm_sum(c.rho_sys->comm(), volume);
         
@@ -144,6 +177,16 @@ public:
     }
 
     
+    /*!
+     * computes the volume using the projected density cached in \p density.
+     */
+    template <typename ContextType, typename DensityFilterType>
+    inline ScalarType
+    compute(ContextType                                            &c,
+            const ProjectedDensity<ScalarType, DensityFilterType>  &density) const {
+        
+        return this->compute(c, density.values());
+    }
     
     
     template <typename VecType,
@@ -152,82 +195,23 @@ public:
     inline void derivative(ContextType                      &c,
                            const VecType                    &density,
                            const GeometricFilterType        &filter,
-                           const MAST::Optimization::DesignParameterVector<ScalarType> &dvs,
                            std::vector<ScalarType> &sens) {
         
-        Assert2(dvs.size() == sens.size(),
-                dvs.size(), sens.size(),
-                "DV and sensitivity vectors must have same size");
-
-        uint_t
-        n_density_dofs = c.rho_sys->n_dofs(),
-        n_nodes        = 0;
-
-        MAST::Numerics::Utility::setZero(sens);
-        std::unique_ptr<VecType>
-        v (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release()),
-        v_filtered (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release());
-
-        // iterate over each element, initialize it and get the relevant
-        // analysis quantities
-        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
-        density_accessor (*c.rho_sys, density);
-
-        libMesh::MeshBase::const_element_iterator
-        el     = c.mesh->active_local_elements_begin(),
-        end_el = c.mesh->active_local_elements_end();
+        if (!_initialized) this->init(c);
         
-        // first compute the sensitivity information assuming unfiltered
-        // density variables.
-        real_t
-        e_vol = 0.;
+        std::unique_ptr<VecType>
+        v (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release());
         
-        for ( ; el != end_el; ++el) {
-            
-            // set element in the context, which will be used for
-            // the initialization routines
-            c.elem = *el;
-            e_vol  = c.elem->volume();
-            
-            density_accessor.init(*c.elem);
-
-            const std::vector<libMesh::dof_id_type>
-            &density_dof_ids = density_accessor.dof_indices();
-
-            n_nodes = MAST::Mesh::libMeshWrapper::Utility::n_linear_basis_nodes_on_elem(**el);
-            
-            for (uint_t i=0; i<n_nodes; i++) {
-
-                // each density coefficient shoudl appear only once
-                // for each element. So, if the dof was found for this
-                // element, then we will simply set the element sensitivity
-                // to be the averaged value
-                MAST::Numerics::Utility::add(*v,
-                                             density_dof_ids[i],
-                                             e_vol/(1. * n_nodes));
-            }
-        }
+        // sensitivity of volume with respect to the unfiltered density variables
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            MAST::Numerics::Utility::add(*v, _dof_ids[i], _weights[i]);
         
         MAST::Numerics::Utility::finalize(*v);
-
-        // Now, combine the sensitivty with the filtering data
-        filter.compute_reverse_filtered_values(*v, *v_filtered);
-
-        uint_t
-        idx  = 0;
-
-        // copy the results back to sens
-        for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++) {
-
-            idx = dvs.get_data_for_parameter(dvs[i]).template get<int>("dof_id");
-            sens[i] = MAST::Numerics::Utility::get(*v_filtered, idx);
-        }
-
-        MAST::Numerics::Utility::comm_sum(c.rho_sys->comm(), sens);
+        
+        _filtered_sensitivity(c, *v, filter, sens);
     }
 
     
-    
     template <typename VecType,
               typename ContextType,
               typename DensityFilterType,
@@ -236,90 +220,88 @@ public:
                            const VecType                    &density,
                            const DensityFilterType          &density_filter,
                            const GeometricFilterType        &geom_filter,
-                           const MAST::Optimization::DesignParameterVector<ScalarType> &dvs,
                            std::vector<ScalarType> &sens) {
         
-        Assert2(dvs.size() == sens.size(),
-                dvs.size(), sens.size(),
-                "DV and sensitivity vectors must have same size");
-
-        uint_t
-        sys_num        = c.rho_sys->number(),
-        n_density_dofs = c.rho_sys->n_dofs(),
-        n_nodes        = 0;
-
-        MAST::Numerics::Utility::setZero(sens);
+        if (!_initialized) this->init(c);
         
         std::unique_ptr<VecType>
-        v (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release()),
-        v_filtered (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release());
-
-        // iterate over each element, initialize it and get the relevant
-        // analysis quantities
-        typename MAST::Base::Assembly::libMeshWrapper::Accessor<ScalarType, VecType>
-        density_accessor (*c.rho_sys, density);
-
-        libMesh::MeshBase::const_element_iterator
-        el     = c.mesh->active_local_elements_begin(),
-        end_el = c.mesh->active_local_elements_end();
+        v (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release());
         
-        // first compute the sensitivity information assuming unfiltered
-        // density variables.
-        real_t
-        e_vol = 0.;
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            MAST::Numerics::Utility::add
+            (*v,
+             _dof_ids[i],
+             _weights[i] *
+             density_filter.filter_derivative(MAST::Numerics::Utility::get
+                                              (density, _dof_ids[i]),
+                                              1.));
         
-        for ( ; el != end_el; ++el) {
-            
-            // set element in the context, which will be used for
-            // the initialization routines
-            c.elem = *el;
-            e_vol  = c.elem->volume();
-            
-            density_accessor.init(*c.elem);
-
-            const std::vector<libMesh::dof_id_type>
-            &density_dof_ids = density_accessor.dof_indices();
-
-            n_nodes = MAST::Mesh::libMeshWrapper::Utility::n_linear_basis_nodes_on_elem(**el);
-            
-            for (uint_t i=0; i<n_nodes; i++) {
-
-                const libMesh::Node& n = *c.elem->node_ptr(i);
+        MAST::Numerics::Utility::finalize(*v);
+        
+        _filtered_sensitivity(c, *v, geom_filter, sens);
+    }
 
-                // each density coefficient shoudl appear only once
-                // for each element. So, if the dof was found for this
-                // element, then we will simply set the element sensitivity
-                // to be the averaged value
-                MAST::Numerics::Utility::add
-                (*v,
-                 density_dof_ids[i],
-                 e_vol/(1. * n_nodes) *
-                 density_filter.filter_derivative(MAST::Numerics::Utility::get
-                                                  (density, n.dof_number(sys_num, 0, 0)),
-                                                  1.));
-            }
-        }
+    
+    /*!
+     * computes the sensitivity of volume using the derivative of the projected density
+     * cached in \p density.
+     */
+    template <typename ContextType,
+              typename DensityFilterType,
+              typename GeometricFilterType>
+    inline void derivative(ContextType                                            &c,
+                           const ProjectedDensity<ScalarType, DensityFilterType>  &density,
+                           const GeometricFilterType                              &geom_filter,
+                           std::vector<ScalarType> &sens) {
         
-        MAST::Numerics::Utility::finalize(*v);
+        if (!_initialized) this->init(c);
         
-        // Now, combine the sensitivty with the filtering data
-        geom_filter.compute_reverse_filtered_values(*v, *v_filtered);
+        const libMesh::NumericVector<ScalarType>
+        &drho = density.derivatives();
         
-        uint_t
-        idx  = 0;
-
-        // copy the results back to sens
-        for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++) {
-
-            idx = dvs.get_data_for_parameter(dvs[i]).template get<int>("dof_id");
-            sens[i] = MAST::Numerics::Utility::get(*v_filtered, idx);
-        }
-
-        MAST::Numerics::Utility::comm_sum(c.rho_sys->comm(), sens);
+        std::unique_ptr<libMesh::NumericVector<ScalarType>>
+        v (MAST::Numerics::Utility::build<libMesh::NumericVector<ScalarType>>(*c.rho_sys).release());
+        
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            MAST::Numerics::Utility::add
+            (*v, _dof_ids[i], _weights[i] * MAST::Numerics::Utility::get(drho, _dof_ids[i]));
+        
+        MAST::Numerics::Utility::finalize(*v);
+        
+        _filtered_sensitivity(c, *v, geom_filter, sens);
     }
 
 private:
     
+    /*!
+     * combines the sensitivity with respect to the filtered density in \p v with the
+     * geometric filter, and copies the values for design parameters to \p sens in the
+     * layout of the design parameter map.
+     */
+    template <typename VecType,
+              typename ContextType,
+              typename GeometricFilterType>
+    inline void
+    _filtered_sensitivity(ContextType                       &c,
+                          VecType                           &v,
+                          const GeometricFilterType         &filter,
+                          std::vector<ScalarType>           &sens) const {
+        
+        Assert0(_dv_map, "Design parameter map not set");
+        
+        std::unique_ptr<VecType>
+        v_filtered (MAST::Numerics::Utility::build<VecType>(*c.rho_sys).release());
+        
+        filter.compute_reverse_filtered_values(v, *v_filtered);
+        
+        _dv_map->gather(*v_filtered, sens);
+    }
+    
+    // these are computed at the first use and reused for all evaluations
+    mutable bool                               _initialized;
+    mutable std::vector<libMesh::dof_id_type>  _dof_ids;
+    mutable std::vector<real_t>                _weights;
+    const MAST::Optimization::Utility::DesignParameterMap<ScalarType> *_dv_map;
 };
 
 }  // namespace libMeshWrapper
@@ -0,0 +1,225 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __mast_optimization_design_parameter_map_h__
+#define __mast_optimization_design_parameter_map_h__
+
+// C++ includes
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+#include <mast/numerics/utility.hpp>
+#include <mast/optimization/design_parameter_vector.hpp>
+
+// libMesh includes
+#include <libmesh/parallel.h>
+#include <libmesh/numeric_vector.h>
+
+
+namespace MAST {
+namespace Optimization {
+namespace Utility {
+
+/*!
+ * Maps the local design parameters of a \p DesignParameterVector to the dofs of the
+ * density system vector with which they are associated. The dof IDs of the local
+ * parameters are owned by this rank, and are stored once in an index array that is
+ * reused for all transfers between the design parameters and system vectors. Since
+ * the dofs are local, a design update is copied to a system vector, and a sensitivity
+ * vector is copied from a system vector, without a search or an off-rank access.
+ *
+ * Vectors of design parameter values and sensitivities follow the \p Layout specified
+ * at construction: \p REPLICATED vectors are sized for all design parameters and are
+ * identical on all ranks, while \p LOCAL vectors are sized for the local design
+ * parameters on each rank. The layout is a property of the map, and not of the vector
+ * size, so that all ranks take part in the same collectives.
+ */
+template <typename ScalarType>
+class DesignParameterMap {
+
+public:
+
+    enum Layout { LOCAL, REPLICATED };
+    
+    DesignParameterMap(const MAST::Optimization::DesignParameterVector<ScalarType> &dvs,
+                       Layout                                                       layout):
+    _comm      (dvs.comm()),
+    _layout    (layout),
+    _n_global  (dvs.size()),
+    _begin     (dvs.local_begin()),
+    _dof_ids   (dvs.local_end() - dvs.local_begin()) {
+        
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            _dof_ids[i] = dvs.dof_id(_begin+i);
+    }
+    
+    virtual ~DesignParameterMap() { }
+    
+    inline Layout layout() const { return _layout;}
+    
+    /*!
+     * @returns the total number of design parameters
+     */
+    inline uint_t size() const { return _n_global;}
+    
+    /*!
+     * @returns the number of design parameters local to this rank
+     */
+    inline uint_t n_local() const { return _dof_ids.size();}
+    
+    /*!
+     * @returns the size of design parameter vectors in the layout of this map
+     */
+    inline uint_t vector_size() const {
+        
+        return (_layout == REPLICATED)? _n_global : _dof_ids.size();
+    }
+    
+    inline const std::vector<libMesh::numeric_index_type>& dof_ids() const { return _dof_ids;}
+    
+    /*!
+     * sets the values of design parameters in \p x to their dofs in \p v. Other entries
+     * in \p v are not modified. \p v is closed after the values are set.
+     */
+    template <typename VecType>
+    inline void scatter(const std::vector<ScalarType> &x,
+                        VecType                       &v) const {
+        
+        Assert2(x.size() == this->vector_size(), x.size(), this->vector_size(),
+                "Vector size does not match the layout of design parameters");
+        
+        const uint_t
+        offset = (_layout == REPLICATED)? _begin : 0;
+        
+        _set_values(x.data() + offset, v);
+    }
+    
+    /*!
+     * copies the values from the dofs of local design parameters in \p v to \p x.
+     * \p v must be an assembled vector, so that the values for all local design
+     * parameters are available locally. For the \p REPLICATED layout the local values
+     * of all ranks are gathered so that \p x is identical on all ranks. Since the IDs
+     * of design parameters are contiguous on each rank and ordered by rank, the gathered
+     * values are already in the global order, and each value is communicated only once.
+     */
+    template <typename VecType>
+    inline void gather(const VecType           &v,
+                       std::vector<ScalarType> &x) const {
+        
+        Assert2(x.size() == this->vector_size(), x.size(), this->vector_size(),
+                "Vector size does not match the layout of design parameters");
+        
+        switch (_layout) {
+            
+            case LOCAL:
+                _get_values(v, x);
+                break;
+            
+            case REPLICATED: {
+                
+                std::vector<ScalarType>
+                vals(_dof_ids.size());
+                
+                _get_values(v, vals);
+                _comm.allgather(vals, false);
+                
+                Assert2(vals.size() == x.size(), vals.size(), x.size(),
+                        "Gathered vector size must match number of design parameters");
+                
+                x.swap(vals);
+            }
+                break;
+        }
+    }
+    
+    /*!
+     * sets the values of the local design parameters in \p dvs from their dofs in \p v.
+     * Values of ghosted parameters in \p dvs are not modified.
+     */
+    template <typename VecType>
+    inline void gather(const VecType                                         &v,
+                       MAST::Optimization::DesignParameterVector<ScalarType> &dvs) const {
+        
+        Assert2(dvs.local_begin() == _begin, dvs.local_begin(), _begin,
+                "Design parameter vector does not match the map");
+        
+        std::vector<ScalarType>
+        vals(_dof_ids.size());
+        
+        _get_values(v, vals);
+        
+        // the local parameters are the first entries of the flat layout
+        std::copy(vals.begin(), vals.end(), dvs.flat_values().begin());
+    }
+
+private:
+
+    template <typename VecType>
+    inline typename std::enable_if
+    <std::is_base_of<libMesh::NumericVector<ScalarType>, VecType>::value, void>::type
+    _set_values(const ScalarType *vals, VecType &v) const {
+        
+        v.insert(vals, _dof_ids);
+        v.close();
+    }
+    
+    template <typename VecType>
+    inline typename std::enable_if
+    <!std::is_base_of<libMesh::NumericVector<ScalarType>, VecType>::value, void>::type
+    _set_values(const ScalarType *vals, VecType &v) const {
+        
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            MAST::Numerics::Utility::set(v, _dof_ids[i], vals[i]);
+        
+        MAST::Numerics::Utility::finalize(v);
+    }
+    
+    template <typename VecType>
+    inline typename std::enable_if
+    <std::is_base_of<libMesh::NumericVector<ScalarType>, VecType>::value, void>::type
+    _get_values(const VecType &v, std::vector<ScalarType> &vals) const {
+        
+        v.get(_dof_ids, vals);
+    }
+    
+    template <typename VecType>
+    inline typename std::enable_if
+    <!std::is_base_of<libMesh::NumericVector<ScalarType>, VecType>::value, void>::type
+    _get_values(const VecType &v, std::vector<ScalarType> &vals) const {
+        
+        for (uint_t i=0; i<_dof_ids.size(); i++)
+            vals[i] = MAST::Numerics::Utility::get(v, _dof_ids[i]);
+    }
+    
+    const libMesh::Parallel::Communicator   &_comm;
+    Layout                                   _layout;
+    uint_t                                   _n_global;
+    uint_t                                   _begin;
+    std::vector<libMesh::numeric_index_type> _dof_ids;
+};
+
+} // namespace Utility
+} // namespace Optimization
+} // namespace MAST
+
+#endif // __mast_optimization_design_parameter_map_h__
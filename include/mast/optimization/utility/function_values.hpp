@@ -0,0 +1,94 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_optimization_function_values_h__
+#define __mast_optimization_function_values_h__
+
+// C++ includes
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+
+
+namespace MAST {
+namespace Optimization {
+namespace Utility {
+
+/*!
+ * \p value is \p true if \p FuncEvalType provides the method
+ *    - \p FuncEvalType::evaluate_values(x, obj, fvals) : computes only the objective and
+ *      constraint function values at \p x
+ */
+template <typename FuncEvalType, typename = void>
+struct HasEvaluateValues: public std::false_type { };
+
+template <typename FuncEvalType>
+struct HasEvaluateValues
+<FuncEvalType,
+decltype(std::declval<FuncEvalType&>().evaluate_values(std::declval<const std::vector<real_t>&>(),
+                                                       std::declval<real_t&>(),
+                                                       std::declval<std::vector<real_t>&>()),
+         void())>: public std::true_type { };
+
+
+/*!
+ * computes the objective \p obj and constraint function values \p fvals at \p x without
+ * the gradients. This calls \p FuncEvalType::evaluate_values() if it is provided by
+ * \p feval.
+ */
+template <typename FuncEvalType>
+inline typename std::enable_if<HasEvaluateValues<FuncEvalType>::value, void>::type
+evaluate_values(FuncEvalType                &feval,
+                const std::vector<real_t>   &x,
+                real_t                      &obj,
+                std::vector<real_t>         & /*obj_grad*/,
+                std::vector<real_t>         &fvals,
+                std::vector<real_t>         & /*grads*/) {
+    
+    feval.evaluate_values(x, obj, fvals);
+}
+
+
+/*!
+ * Otherwise, \p FuncEvalType::evaluate() is called with all gradient flags set to false.
+ * \p obj_grad and \p grads are passed to the method, but are not expected to be modified.
+ */
+template <typename FuncEvalType>
+inline typename std::enable_if<!HasEvaluateValues<FuncEvalType>::value, void>::type
+evaluate_values(FuncEvalType                &feval,
+                const std::vector<real_t>   &x,
+                real_t                      &obj,
+                std::vector<real_t>         &obj_grad,
+                std::vector<real_t>         &fvals,
+                std::vector<real_t>         &grads) {
+    
+    std::vector<bool>
+    eval_grads(fvals.size(), false);
+    
+    feval.evaluate(x, obj, false, obj_grad, fvals, eval_grads, grads);
+}
+
+} // namespace Utility
+} // namespace Optimization
+} // namespace MAST
+
+#endif // __mast_optimization_function_values_h__
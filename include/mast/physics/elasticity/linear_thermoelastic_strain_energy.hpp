@@ -0,0 +1,351 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef __mast_linear_thermoelastic_strain_energy_h__
+#define __mast_linear_thermoelastic_strain_energy_h__
+
+// C++ includes
+#include <unordered_map>
+
+// MAST includes
+#include <mast/physics/elasticity/linear_elastic_strain_operator.hpp>
+
+namespace MAST {
+namespace Physics {
+namespace Elasticity {
+namespace LinearContinuum {
+
+/*!
+ * Fused kernel for the linear strain energy and the thermoelastic load of a continuum.
+ * The contributions are identical to using \p StrainEnergy and \p ThermoelasticLoad
+ * on the same element, but the strain operator, constitutive matrix and integration
+ * weight are evaluated once per quadrature point and shared between the stiffness
+ * and the thermal load. Since the thermoelastic stress is \f$ C (\epsilon - \alpha
+ * \Delta T \{1\}) \f$, both terms are accumulated with a single product with
+ * \f$ B^T \f$.
+ */
+template <typename FEVarType,
+          typename TemperatureFieldType,
+          typename ExpansionCoeffType,
+          typename SectionPropertyType,
+          uint_t Dim,
+          typename ContextType>
+class ThermoelasticStrainEnergy {
+    
+public:
+
+    using scalar_t         = typename FEVarType::scalar_t;
+    using basis_scalar_t   = typename FEVarType::fe_shape_deriv_t::scalar_t;
+    using vector_t         = typename Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    using matrix_t         = typename Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using fe_shape_deriv_t = typename FEVarType::fe_shape_deriv_t;
+    static const uint_t
+    n_strain               = MAST::Physics::Elasticity::LinearContinuum::NStrainComponents<Dim>::value;
+
+    ThermoelasticStrainEnergy():
+    _property    (nullptr),
+    _temperature (nullptr),
+    _alpha       (nullptr),
+    _fe_var_data (nullptr)
+    { }
+    
+    virtual ~ThermoelasticStrainEnergy() { }
+
+    inline void
+    set_section_property(const SectionPropertyType& p) {
+        
+        Assert0(!_property, "Property already initialized.");
+        
+        _property = &p;
+    }
+
+    inline void set_temperature(const TemperatureFieldType& dt) { _temperature = &dt;}
+
+    inline void set_coeff_thermal_expansion(const ExpansionCoeffType& a) { _alpha = &a;}
+
+    /*!
+     * clears the element operators cached by \p temperature_load. This must be
+     * called if the mesh changes. The cached operators do not depend on the section
+     * property, the coefficient of thermal expansion or the temperature.
+     */
+    inline void clear_temperature_load() { _load_op.clear();}
+
+    inline void set_fe_var_data(const FEVarType& fe_data)
+    {
+        Assert0(!_fe_var_data, "FE data already initialized.");
+        _fe_var_data = &fe_data;
+    }
+
+    inline uint_t n_dofs() const {
+
+        Assert0(_fe_var_data, "FE data not initialized.");
+
+        return Dim*_fe_var_data->get_fe_shape_data().n_basis();
+    }
+    
+    inline void compute(ContextType& c,
+                        vector_t& res,
+                        matrix_t* jac = nullptr) const {
+        
+        Assert0(_fe_var_data, "FE data not initialized.");
+        Assert0(_property, "Section property not initialized");
+        Assert0(_alpha, "Coefficient of thermal expansion");
+        Assert0(_temperature, "Temperature not initialized");
+
+        const typename FEVarType::fe_shape_deriv_t
+        &fe = _fe_var_data->get_fe_shape_data();
+        
+        typename Eigen::Matrix<scalar_t, n_strain, 1>
+        dt_vec  = Eigen::Matrix<scalar_t, n_strain, 1>::Zero(),
+        epsilon,
+        stress;
+        vector_t
+        vec     = vector_t::Zero(Dim*fe.n_basis());
+
+        for (uint_t i=0; i<Dim; i++) dt_vec(i) = 1.;
+
+        typename SectionPropertyType::value_t
+        mat;
+        
+        matrix_t
+        mat1 = matrix_t::Zero(n_strain, Dim*fe.n_basis()),
+        mat2 = matrix_t::Zero(Dim*fe.n_basis(), Dim*fe.n_basis());
+
+        MAST::Numerics::FEMOperatorMatrix<scalar_t>
+        Bxmat;
+        Bxmat.reinit(n_strain, Dim, fe.n_basis());
+
+        
+        for (uint_t i=0; i<fe.n_q_points(); i++) {
+            
+            c.qp = i;
+
+            _property->value(c, mat);
+            MAST::Physics::Elasticity::LinearContinuum::strain
+            <scalar_t, scalar_t, FEVarType, Dim>(*_fe_var_data, i, epsilon, Bxmat);
+
+            // thermal strain is subtracted from the mechanical strain so that
+            // a single B^T product gives both the elastic and thermal terms
+            epsilon -= (_temperature->value(c) * _alpha->value(c)) * dt_vec;
+            stress = mat * epsilon;
+            Bxmat.vector_mult_transpose(vec, stress);
+            res += fe.detJxW(i) * vec;
+            
+            if (jac) {
+                
+                Bxmat.left_multiply(mat1, mat);
+                Bxmat.right_multiply_transpose(mat2, mat1);
+                (*jac) += fe.detJxW(i) * mat2;
+            }
+        }
+    }
+
+    /*!
+     * adds the thermoelastic load contribution to the residual for the temperature
+     * field \p dt, \f$ -\int_\Omega \alpha \Delta T B^T C \{1\} d\Omega \f$, for the
+     * element in \p c. The temperature field set for this object is not used, so that
+     * for linear problems a load with a different temperature, or a scaled temperature,
+     * can be accumulated without the stiffness. The operator \f$ B^T \f$ weighted
+     * by the quadrature weight at each quadrature point is computed on the first call
+     * for an element and cached by element ID. The section property, the coefficient
+     * of thermal expansion and \p dt are evaluated at each call, so that the cached
+     * operator remains valid when these change, for example with a penalized
+     * property in topology optimization. The cache is cleared by
+     * \p clear_temperature_load().
+     */
+    template <typename TemperatureType>
+    inline void temperature_load(ContextType           &c,
+                                 const TemperatureType &dt,
+                                 vector_t              &res) const {
+        
+        Assert0(_fe_var_data, "FE data not initialized.");
+        Assert0(_property, "Section property not initialized");
+        Assert0(_alpha, "Coefficient of thermal expansion");
+
+        const typename FEVarType::fe_shape_deriv_t
+        &fe = _fe_var_data->get_fe_shape_data();
+
+        typename std::unordered_map<libMesh::dof_id_type, matrix_t>::const_iterator
+        it = _load_op.find(c.elem->id());
+        
+        if (it == _load_op.end()) {
+            
+            matrix_t
+            op;
+            
+            this->_compute_temperature_load_operator(c, op);
+            it = _load_op.insert(std::make_pair(c.elem->id(), op)).first;
+        }
+        
+        Assert2(it->second.cols() == fe.n_q_points()*n_strain,
+                it->second.cols(), fe.n_q_points()*n_strain,
+                "Cached operator incompatible with quadrature");
+        
+        typename Eigen::Matrix<scalar_t, n_strain, 1>
+        dt_vec  = Eigen::Matrix<scalar_t, n_strain, 1>::Zero();
+        vector_t
+        stress  = vector_t::Zero(fe.n_q_points()*n_strain);
+
+        for (uint_t i=0; i<Dim; i++) dt_vec(i) = 1.;
+
+        typename SectionPropertyType::value_t
+        mat;
+
+        for (uint_t i=0; i<fe.n_q_points(); i++) {
+            
+            c.qp = i;
+
+            _property->value(c, mat);
+            stress.segment(i*n_strain, n_strain) =
+            (-_alpha->value(c) * dt.value(c)) * (mat * dt_vec);
+        }
+        
+        res += it->second * stress;
+    }
+
+    /*!
+     * @returns the number of elements for which the operator of \p temperature_load
+     * is cached
+     */
+    inline uint_t n_cached_temperature_loads() const { return _load_op.size();}
+
+    template <typename ScalarFieldType>
+    inline void derivative(ContextType& c,
+                           const ScalarFieldType& f,
+                           vector_t& res,
+                           matrix_t* jac = nullptr) const {
+        
+        Assert0(_fe_var_data, "FE data not initialized.");
+        Assert0(_property, "Section property not initialized");
+        Assert0(_alpha, "Coefficient of thermal expansion");
+        Assert0(_temperature, "Temperature not initialized");
+
+        const typename FEVarType::fe_shape_deriv_t
+        &fe = _fe_var_data->get_fe_shape_data();
+
+        typename Eigen::Matrix<scalar_t, n_strain, 1>
+        dt_vec  = Eigen::Matrix<scalar_t, n_strain, 1>::Zero(),
+        epsilon,
+        stress;
+        vector_t
+        vec     = vector_t::Zero(Dim*fe.n_basis());
+        
+        for (uint_t i=0; i<Dim; i++) dt_vec(i) = 1.;
+
+        typename SectionPropertyType::value_t
+        mat,
+        dmat;
+        matrix_t
+        mat1 = matrix_t::Zero(n_strain, Dim*fe.n_basis()),
+        mat2 = matrix_t::Zero(Dim*fe.n_basis(), Dim*fe.n_basis());
+
+        MAST::Numerics::FEMOperatorMatrix<scalar_t>
+        Bxmat;
+        Bxmat.reinit(n_strain, Dim, fe.n_basis());
+
+        for (uint_t i=0; i<fe.n_q_points(); i++) {
+            
+            c.qp = i;
+
+            MAST::Physics::Elasticity::LinearContinuum::strain
+            <scalar_t, scalar_t, FEVarType, Dim>(*_fe_var_data, i, epsilon, Bxmat);
+
+            scalar_t
+            dt       = _temperature->value(c),
+            dtdp     = _temperature->derivative(c, f),
+            alpha    = _alpha->value(c),
+            dalphadp = _alpha->derivative(c, f);
+            
+            _property->value(c, mat);
+            _property->derivative(c, f, dmat);
+
+            // d/dp [C (eps - alpha dT)] = dC/dp (eps - alpha dT) - C d(alpha dT)/dp
+            stress =
+            dmat * (epsilon - (alpha*dt) * dt_vec) -
+            mat  * dt_vec * (dalphadp*dt + alpha*dtdp);
+            Bxmat.vector_mult_transpose(vec, stress);
+            res += fe.detJxW(i) * vec;
+
+            if (jac) {
+                
+                Bxmat.left_multiply(mat1, dmat);
+                Bxmat.right_multiply_transpose(mat2, mat1);
+                (*jac) += fe.detJxW(i) * mat2;
+            }
+        }
+    }
+
+    
+private:
+    
+    /*!
+     * computes the operator \f$ [ w_1 B_1^T, w_2 B_2^T, \ldots ] \f$ for the element in
+     * \p c, where \f$ w_i \f$ is the quadrature weight times the Jacobian determinant
+     * and \f$ B_i \f$ is the strain operator at quadrature point \p i.
+     */
+    inline void _compute_temperature_load_operator(ContextType& c,
+                                                   matrix_t& op) const {
+        
+        const typename FEVarType::fe_shape_deriv_t
+        &fe = _fe_var_data->get_fe_shape_data();
+        
+        typename Eigen::Matrix<scalar_t, n_strain, 1>
+        epsilon,
+        e_k;
+        vector_t
+        vec     = vector_t::Zero(Dim*fe.n_basis());
+
+        op = matrix_t::Zero(Dim*fe.n_basis(), fe.n_q_points()*n_strain);
+        
+        MAST::Numerics::FEMOperatorMatrix<scalar_t>
+        Bxmat;
+        Bxmat.reinit(n_strain, Dim, fe.n_basis());
+
+        for (uint_t i=0; i<fe.n_q_points(); i++) {
+            
+            c.qp = i;
+
+            MAST::Physics::Elasticity::LinearContinuum::strain
+            <scalar_t, scalar_t, FEVarType, Dim>(*_fe_var_data, i, epsilon, Bxmat);
+            
+            for (uint_t k=0; k<n_strain; k++) {
+                
+                e_k    = Eigen::Matrix<scalar_t, n_strain, 1>::Zero();
+                e_k(k) = 1.;
+                Bxmat.vector_mult_transpose(vec, e_k);
+                op.col(i*n_strain+k) = fe.detJxW(i) * vec;
+            }
+        }
+    }
+    
+    const SectionPropertyType       *_property;
+    const TemperatureFieldType      *_temperature;
+    const ExpansionCoeffType        *_alpha;
+    const FEVarType                 *_fe_var_data;
+    /*!
+     * weighted strain operators used by \p temperature_load, keyed on element ID
+     */
+    mutable std::unordered_map<libMesh::dof_id_type, matrix_t> _load_op;
+};
+
+}  // namespace LinearContinuum
+}  // namespace Elasticity
+}  // namespace Physics
+}  // namespace MAST
+
+#endif // __mast_linear_thermoelastic_strain_energy_h__
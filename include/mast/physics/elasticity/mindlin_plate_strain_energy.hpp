@@ -20,6 +20,9 @@
 #ifndef __mast_linear_mindlin_plate_strain_energy_h__
 #define __mast_linear_mindlin_plate_strain_energy_h__
 
+// C++ includes
+#include <algorithm>
+
 // MAST includes
 #include <mast/physics/elasticity/mindlin_strain_operator.hpp>
 
@@ -85,94 +88,13 @@ public:
         Assert0(_bending_fe_var_data && _shear_fe_var_data,
                 "FE data not initialized.");
         Assert0(_property, "Section property not initialized");
-                
-        // process the inplane strain components
-        {
-            const typename FEVarType::fe_shape_deriv_t
-            &fe = _bending_fe_var_data->get_fe_shape_data();
-
-            typename Eigen::Matrix<scalar_t, 3, 1>
-            epsilon,
-            stress;
-            vector_t
-            vec     = vector_t::Zero(3*fe.n_basis());
-            
-            typename SectionPropertyType::inplane_value_t
-            mat;
-            
-            matrix_t
-            mat1 = matrix_t::Zero(3, 3*fe.n_basis()),
-            mat2 = matrix_t::Zero(3*fe.n_basis(), 3*fe.n_basis());
-            
-            MAST::Numerics::FEMOperatorMatrix<scalar_t>
-            Bxmat;
-            Bxmat.reinit(3, 3, fe.n_basis());
-            
-            
-            for (uint_t i=0; i<fe.n_q_points(); i++) {
-                
-                c.qp = i;
-                
-                _property->inplane_value(c, mat);
-                MAST::Physics::Elasticity::MindlinPlate::inplane_strain
-                <scalar_t, scalar_t, FEVarType>
-                (*_bending_fe_var_data, i, 1., epsilon, Bxmat);
-                stress = mat * epsilon;
-                Bxmat.vector_mult_transpose(vec, stress);
-                res += fe.detJxW(i) * vec;
-                
-                if (jac) {
-                    
-                    Bxmat.left_multiply(mat1, mat);
-                    Bxmat.right_multiply_transpose(mat2, mat1);
-                    (*jac) += fe.detJxW(i) * mat2;
-                }
-            }
-        }
         
-        // process the transverse shear strain components
-        {
-            const typename FEVarType::fe_shape_deriv_t
-            &fe = _shear_fe_var_data->get_fe_shape_data();
-
-            typename Eigen::Matrix<scalar_t, 2, 1>
-            epsilon,
-            stress;
-            vector_t
-            vec     = vector_t::Zero(3*fe.n_basis());
-            
-            typename SectionPropertyType::shear_value_t
-            mat;
-            
-            matrix_t
-            mat1 = matrix_t::Zero(2, 3*fe.n_basis()),
-            mat2 = matrix_t::Zero(3*fe.n_basis(), 3*fe.n_basis());
-            
-            MAST::Numerics::FEMOperatorMatrix<scalar_t>
-            Bxmat;
-            Bxmat.reinit(2, 3, fe.n_basis());
-            
-            
-            for (uint_t i=0; i<fe.n_q_points(); i++) {
-                
-                c.qp = i;
-                
-                _property->shear_value(c, mat);
-                MAST::Physics::Elasticity::MindlinPlate::transverse_shear_strain
-                <scalar_t, scalar_t, FEVarType>
-                (*_shear_fe_var_data, i, epsilon, Bxmat);
-                stress = mat * epsilon;
-                Bxmat.vector_mult_transpose(vec, stress);
-                res += fe.detJxW(i) * vec;
-                
-                if (jac) {
-                    
-                    Bxmat.left_multiply(mat1, mat);
-                    Bxmat.right_multiply_transpose(mat2, mat1);
-                    (*jac) += fe.detJxW(i) * mat2;
-                }
-            }
-        }
+        _compute(c,
+                 [this](ContextType& c, typename SectionPropertyType::inplane_value_t& m)
+                 { _property->inplane_value(c, m);},
+                 [this](ContextType& c, typename SectionPropertyType::shear_value_t& m)
+                 { _property->shear_value(c, m);},
+                 res, jac);
     }
 
     template <typename ScalarFieldType>
@@ -184,99 +106,110 @@ public:
         Assert0(_bending_fe_var_data && _shear_fe_var_data,
                 "FE data not initialized.");
         Assert0(_property, "Section property not initialized");
-                
-        // process the inplane strain components
-        {
-            const typename FEVarType::fe_shape_deriv_t
-            &fe = _bending_fe_var_data->get_fe_shape_data();
+        
+        _compute(c,
+                 [this, &f](ContextType& c, typename SectionPropertyType::inplane_value_t& m)
+                 { _property->inplane_derivative(c, f, m);},
+                 [this, &f](ContextType& c, typename SectionPropertyType::shear_value_t& m)
+                 { _property->shear_derivative(c, f, m);},
+                 res, jac);
+    }
 
-            typename Eigen::Matrix<scalar_t, 3, 1>
-            epsilon,
-            stress;
-            vector_t
-            vec     = vector_t::Zero(3*fe.n_basis());
-            
-            typename SectionPropertyType::inplane_value_t
-            mat;
-            
-            matrix_t
-            mat1 = matrix_t::Zero(3, 3*fe.n_basis()),
-            mat2 = matrix_t::Zero(3*fe.n_basis(), 3*fe.n_basis());
-            
-            MAST::Numerics::FEMOperatorMatrix<scalar_t>
-            Bxmat;
-            Bxmat.reinit(3, 3, fe.n_basis());
+    
+private:
+    
+    /*!
+     * Computes the inplane and transverse shear contributions with the section
+     * stiffness provided by \p inplane_mat and \p shear_mat, which compute either the
+     * value or the derivative of the section property. Both terms are evaluated in one
+     * pass over the quadrature points, and each term is integrated with the quadrature
+     * rule of its FE data.
+     */
+    template <typename InplaneMatType, typename ShearMatType>
+    inline void _compute(ContextType&       c,
+                         InplaneMatType     inplane_mat,
+                         ShearMatType       shear_mat,
+                         vector_t&          res,
+                         matrix_t*          jac) const {
+        
+        const typename FEVarType::fe_shape_deriv_t
+        &fe_b = _bending_fe_var_data->get_fe_shape_data(),
+        &fe_s = _shear_fe_var_data->get_fe_shape_data();
+
+        typename Eigen::Matrix<scalar_t, 3, 1>
+        epsilon_b,
+        stress_b;
+        typename Eigen::Matrix<scalar_t, 2, 1>
+        epsilon_s,
+        stress_s;
+        vector_t
+        vec     = vector_t::Zero(3*fe_b.n_basis());
+        
+        typename SectionPropertyType::inplane_value_t
+        mat_b;
+        typename SectionPropertyType::shear_value_t
+        mat_s;
+
+        matrix_t
+        mat1_b = matrix_t::Zero(3, 3*fe_b.n_basis()),
+        mat1_s = matrix_t::Zero(2, 3*fe_s.n_basis()),
+        mat2   = matrix_t::Zero(3*fe_b.n_basis(), 3*fe_b.n_basis());
+        
+        MAST::Numerics::FEMOperatorMatrix<scalar_t>
+        Bxmat_b,
+        Bxmat_s;
+        Bxmat_b.reinit(3, 3, fe_b.n_basis());
+        Bxmat_s.reinit(2, 3, fe_s.n_basis());
+        
+        const uint_t
+        n_qp_b = fe_b.n_q_points(),
+        n_qp_s = fe_s.n_q_points(),
+        n_qp   = std::max(n_qp_b, n_qp_s);
+        
+        // the inplane and transverse shear strain components are processed in a single
+        // pass over the quadrature points. Since the shear term may use a reduced
+        // quadrature rule, each term is added only at the points of its own rule.
+        for (uint_t i=0; i<n_qp; i++) {
             
+            c.qp = i;
             
-            for (uint_t i=0; i<fe.n_q_points(); i++) {
+            if (i < n_qp_b) {
                 
-                c.qp = i;
-                
-                _property->inplane_derivative(c, f, mat);
+                inplane_mat(c, mat_b);
                 MAST::Physics::Elasticity::MindlinPlate::inplane_strain
                 <scalar_t, scalar_t, FEVarType>
-                (*_bending_fe_var_data, i, 1., epsilon, Bxmat);
-                stress = mat * epsilon;
-                Bxmat.vector_mult_transpose(vec, stress);
-                res += fe.detJxW(i) * vec;
+                (*_bending_fe_var_data, i, 1., epsilon_b, Bxmat_b);
+                stress_b = mat_b * epsilon_b;
+                Bxmat_b.vector_mult_transpose(vec, stress_b);
+                res += fe_b.detJxW(i) * vec;
                 
                 if (jac) {
                     
-                    Bxmat.left_multiply(mat1, mat);
-                    Bxmat.right_multiply_transpose(mat2, mat1);
-                    (*jac) += fe.detJxW(i) * mat2;
+                    Bxmat_b.left_multiply(mat1_b, mat_b);
+                    Bxmat_b.right_multiply_transpose(mat2, mat1_b);
+                    (*jac) += fe_b.detJxW(i) * mat2;
                 }
             }
-        }
-        
-        // process the transverse shear strain components
-        {
-            const typename FEVarType::fe_shape_deriv_t
-            &fe = _shear_fe_var_data->get_fe_shape_data();
-
-            typename Eigen::Matrix<scalar_t, 2, 1>
-            epsilon,
-            stress;
-            vector_t
-            vec     = vector_t::Zero(3*fe.n_basis());
-            
-            typename SectionPropertyType::shear_value_t
-            mat;
-            
-            matrix_t
-            mat1 = matrix_t::Zero(2, 3*fe.n_basis()),
-            mat2 = matrix_t::Zero(3*fe.n_basis(), 3*fe.n_basis());
             
-            MAST::Numerics::FEMOperatorMatrix<scalar_t>
-            Bxmat;
-            Bxmat.reinit(2, 3, fe.n_basis());
-            
-            
-            for (uint_t i=0; i<fe.n_q_points(); i++) {
+            if (i < n_qp_s) {
                 
-                c.qp = i;
-                
-                _property->shear_derivative(c, f, mat);
+                shear_mat(c, mat_s);
                 MAST::Physics::Elasticity::MindlinPlate::transverse_shear_strain
                 <scalar_t, scalar_t, FEVarType>
-                (*_shear_fe_var_data, i, epsilon, Bxmat);
-                stress = mat * epsilon;
-                Bxmat.vector_mult_transpose(vec, stress);
-                res += fe.detJxW(i) * vec;
+                (*_shear_fe_var_data, i, epsilon_s, Bxmat_s);
+                stress_s = mat_s * epsilon_s;
+                Bxmat_s.vector_mult_transpose(vec, stress_s);
+                res += fe_s.detJxW(i) * vec;
                 
                 if (jac) {
                     
-                    Bxmat.left_multiply(mat1, mat);
-                    Bxmat.right_multiply_transpose(mat2, mat1);
-                    (*jac) += fe.detJxW(i) * mat2;
+                    Bxmat_s.left_multiply(mat1_s, mat_s);
+                    Bxmat_s.right_multiply_transpose(mat2, mat1_s);
+                    (*jac) += fe_s.detJxW(i) * mat2;
                 }
             }
         }
     }
-
-    
-private:
-    
     
     
     const SectionPropertyType       *_property;
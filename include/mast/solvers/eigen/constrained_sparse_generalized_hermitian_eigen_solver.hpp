@@ -0,0 +1,447 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __mast_eigen_constrained_sparse_generalized_hermitian_eigen_solver_h__
+#define __mast_eigen_constrained_sparse_generalized_hermitian_eigen_solver_h__
+
+// C++ includes
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+
+// Eigen includes
+#include <Eigen/Eigenvalues>
+
+
+namespace MAST {
+namespace Solvers {
+namespace EigenWrapper {
+
+/*!
+ * Solves the generalized Hermitian eigenvalue problem \f$ A x = \lambda B x \f$ for
+ * sparse matrices, restricted to the unconstrained dofs, for the \p nev eigenvalues
+ * closest to \p shift. This is a sparse alternative to
+ * \p ConstrainedGeneralizedHermitianEigenSolver, which is limited to small problems
+ * since it uses dense matrices and computes all eigenpairs.
+ *
+ * The submatrices of the unconstrained dofs are extracted in a single pass over the
+ * nonzeros of \p A and \p B using a map from the global to the reduced dof numbering.
+ * The Lanczos method is applied to the shift-and-invert operator
+ * \f$ (A - \sigma B)^{-1} B \f$, which is self-adjoint in the \f$ B \f$ inner product,
+ * with full reorthogonalization of the Lanczos vectors. The factorization of
+ * \f$ A - \sigma B \f$ is computed with \p LinearSolverType, for example
+ * \p Eigen::SimplicialLDLT or \p Eigen::SparseLU. The symbolic analysis is retained
+ * across calls to \p solve for matrices with the same sparsity pattern.
+ *
+ * \p B is expected to be positive definite on the unconstrained dofs.
+ */
+template <typename ScalarType,
+          typename LinearSolverType,
+          typename MatType,
+          typename VectorType>
+class ConstrainedSparseGeneralizedHermitianEigenSolver {
+    
+public:
+
+    using scalar_t = ScalarType;
+    using vector_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    using matrix_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
+    
+    /*!
+     * shift \f$ \sigma \f$ of the spectral transformation. The eigenvalues closest to
+     * this value are computed. The default value of zero computes the smallest
+     * eigenvalues of positive definite problems.
+     */
+    real_t shift;
+    
+    /*!
+     * tolerance on the residual of the eigenpairs of the transformed operator,
+     * relative to the magnitude of the transformed eigenvalue.
+     */
+    real_t tol;
+    
+    /*!
+     * maximum dimension of the Lanczos subspace. A value of zero limits the subspace
+     * only by the number of unconstrained dofs.
+     */
+    uint_t max_subspace;
+    
+    /*!
+     * \p dofs is the vector of unconstrained degrees of freedom on the local rank.
+     */
+    ConstrainedSparseGeneralizedHermitianEigenSolver(const std::vector<uint_t> &dofs):
+    shift            (0.),
+    tol              (1.e-10),
+    max_subspace     (0),
+    _dofs            (dofs),
+    _initialized     (false),
+    _pattern_analyzed(false),
+    _n               (0),
+    _n_iters         (0) { }
+    
+    virtual ~ConstrainedSparseGeneralizedHermitianEigenSolver() { }
+
+    
+    /// @returns the number of converged eigen pairs
+    inline uint_t n_converged() const {
+        
+        Assert0(_initialized, "solver not initialized");
+        
+        return _eig.size();
+    }
+    
+    /// @returns the number of Lanczos iterations in the last solve
+    inline uint_t n_iterations() const { return _n_iters;}
+
+    /// this method returns the eigen value
+    inline ScalarType eig(uint_t i) const {
+        
+        Assert0(_initialized, "solver not initialized");
+        Assert2(i < _eig.size(),
+                i, _eig.size(),
+                "Eigenvalue index must be less than n_converged");
+        
+        return _eig(i);
+    }
+    
+    
+    /*!
+     * this method returns the eigen pair. The \p i th eigenvalue is returned in \p eig and the
+     * corresponding eigenvector of the origin problem size (including both constrained and
+     * unconstrained dofs) is returned in \p x. The eigenvectors are normalized to
+     * unit \f$ B \f$ norm.
+     * The index \p i must be less than the total number of converged eigenvalues.
+     */
+    inline void getEigenVector(uint_t        i,
+                               VectorType   &x) const {
+        
+        Assert0(_initialized, "solver not initialized");
+        Assert2(i < _eig.size(),
+                i, _eig.size(),
+                "Eigenvalue index must be less than n_converged");
+        Assert2(x.size() == _n,
+                x.size(), _n,
+                "Vector must have dimension of original matrix");
+        Assert0(_vec.cols(), "Eigenvectors not computed");
+
+        x.setZero();
+        
+        for (uint_t j=0; j<_dofs.size(); j++)
+            x(_dofs[j]) = _vec(j, i);
+    }
+    
+    
+    /*!
+     *  computes the \p nev eigenpairs of \f$ A x = \lambda B x \f$ closest to \p shift.
+     *  The eigenvalues are sorted in ascending order.
+     */
+    inline void solve(const MatType    &A_mat,
+                      const MatType    &B_mat,
+                      uint_t            nev,
+                      bool              computeEigenvectors) {
+        
+        Assert2(A_mat.rows() == A_mat.cols(),
+                A_mat.rows(), A_mat.cols(),
+                "Matrix must be square");
+        Assert2(B_mat.rows() == B_mat.cols(),
+                B_mat.rows(), B_mat.cols(),
+                "Matrix must be square");
+        Assert2(A_mat.rows() == B_mat.rows(),
+                A_mat.rows(), B_mat.rows(),
+                "Matrices must have same dimensions");
+        Assert1(nev > 0, nev, "Number of eigenvalues must be positive");
+
+        _n = A_mat.rows();
+        
+        // initialize the matrices
+        _init_sub_matrices(A_mat, _A_sub);
+        _init_sub_matrices(B_mat, _B_sub);
+        
+        // factorization of the shifted operator
+        _K = _A_sub - shift * _B_sub;
+        
+        if (!_pattern_analyzed) {
+            
+            _solver.analyzePattern(_K);
+            _pattern_analyzed = true;
+        }
+        _solver.factorize(_K);
+        
+        Error(_solver.info() == Eigen::Success,
+              "Factorization of shifted operator failed");
+        
+        _lanczos(std::min<uint_t>(nev, _dofs.size()), computeEigenvectors);
+        
+        _initialized = true;
+    }
+    
+
+    /*!
+     *  compute the sensitivity of \p i th eigenvalue
+     *  \f[  \frac{d \lambda_i}{d p} = \frac{ x^T \left(\frac{\partial A}{\partial p} -
+     *   \lambda_i \frac{\partial B}{\partial p}\right) x}{x_i^T B x_i } \f]
+     *   Dimension of the matrices \p B, \p A_sens and \p B_sens is equal to
+     *   the original problem including both the constrained and unconstrained degrees-of-freedom.
+     */
+    inline scalar_t sensitivity_solve(const MatType      &B,
+                                      const MatType      &A_sens,
+                                      const MatType      &B_sens,
+                                      uint_t              i) const {
+
+        VectorType
+        v1 = VectorType::Zero(_n);
+        
+        this->getEigenVector(i, v1);
+        
+        scalar_t
+        eig   = this->eig(i);
+
+        eig =
+        v1.dot( (A_sens * v1) - (eig * (B_sens * v1)) )/ // numerator
+        v1.dot(B*v1); // denominator
+        
+        return eig;
+    }
+    
+
+protected:
+
+    /*!
+     * extracts the submatrix of \p m for the unconstrained dofs using the map from
+     * global to reduced dofs, which requires a single pass over the nonzeros of \p m.
+     */
+    inline void _init_sub_matrices(const MatType    &m,
+                                   MatType          &m_sub) {
+        
+        if (_dof_map.size() != (uint_t)m.rows()) {
+            
+            _dof_map.assign(m.rows(), -1);
+            for (uint_t i=0; i<_dofs.size(); i++)
+                _dof_map[_dofs[i]] = i;
+        }
+        
+        std::vector<Eigen::Triplet<scalar_t>>
+        entries;
+        entries.reserve(m.nonZeros());
+        
+        for (int_t k=0; k<m.outerSize(); k++)
+            for (typename MatType::InnerIterator it(m, k); it; ++it) {
+                
+                const int_t
+                i = _dof_map[it.row()],
+                j = _dof_map[it.col()];
+                
+                if (i >= 0 && j >= 0)
+                    entries.push_back(Eigen::Triplet<scalar_t>(i, j, it.value()));
+            }
+        
+        m_sub.resize(_dofs.size(), _dofs.size());
+        m_sub.setFromTriplets(entries.begin(), entries.end());
+    }
+    
+    
+    /*!
+     * Lanczos iterations with full reorthogonalization for the operator
+     * \f$ (A - \sigma B)^{-1} B \f$. The subspace is expanded until the \p nev
+     * eigenvalues of largest magnitude of the operator, which correspond to the
+     * eigenvalues \f$ \lambda = \sigma + 1/\theta \f$ closest to the shift,
+     * have converged.
+     */
+    inline void _lanczos(uint_t nev, bool computeEigenvectors) {
+        
+        const uint_t
+        n     = _dofs.size(),
+        m_max = max_subspace? std::min<uint_t>(max_subspace, n) : n;
+        
+        Assert2(m_max >= nev, m_max, nev,
+                "Subspace dimension must not be less than number of eigenvalues");
+        
+        // the storage for the Lanczos vectors is increased as needed, starting
+        // from a subspace that is typically sufficient for shift-and-invert
+        uint_t
+        m_cap = std::min<uint_t>(m_max, std::max<uint_t>(2*nev, nev+20));
+        
+        matrix_t
+        Q  = matrix_t::Zero(n, m_cap),
+        // B Q, which is used for the B inner products
+        BQ = matrix_t::Zero(n, m_cap);
+        
+        vector_t
+        alpha = vector_t::Zero(m_max),
+        beta  = vector_t::Zero(m_max),
+        w,
+        Bw,
+        h;
+        
+        Eigen::SelfAdjointEigenSolver<matrix_t>
+        tri_solver;
+        
+        // deterministic starting vector with components in all directions
+        w = vector_t::Ones(n);
+        for (uint_t i=0; i<n; i++) w(i) += std::sin(1.+i);
+        Bw = _B_sub * w;
+        
+        real_t
+        b_norm = std::sqrt(w.dot(Bw));
+        Q.col(0)  = w / b_norm;
+        BQ.col(0) = Bw / b_norm;
+        
+        uint_t
+        m         = 0;
+        bool
+        converged = false;
+        
+        while (!converged) {
+            
+            const uint_t
+            j = m;
+            
+            w      = _solver.solve(BQ.col(j));
+            Bw     = _B_sub * w;
+            
+            alpha(j) = Q.col(j).dot(Bw);
+            
+            // full reorthogonalization in the B inner product, applied twice
+            for (uint_t k=0; k<2; k++) {
+                
+                h   = Q.leftCols(j+1).transpose() * Bw;
+                w  -= Q.leftCols(j+1)  * h;
+                Bw -= BQ.leftCols(j+1) * h;
+            }
+            
+            beta(j) = std::sqrt(std::max(w.dot(Bw), 0.));
+            m       = j+1;
+            
+            // check for convergence once the subspace has the required dimension
+            if (m >= nev) {
+                
+                tri_solver.computeFromTridiagonal(alpha.head(m), beta.head(m-1),
+                                                  Eigen::ComputeEigenvectors);
+                
+                converged = true;
+                
+                // the eigenvalues of the tridiagonal matrix are sorted in
+                // ascending order. The residual of the Ritz pair is
+                // beta_j times the last component of the eigenvector.
+                _ritz_order(tri_solver.eigenvalues(), nev);
+                
+                for (uint_t i=0; i<nev; i++) {
+                    
+                    const uint_t
+                    l = _order[i];
+                    
+                    if (std::fabs(beta(j) * tri_solver.eigenvectors()(m-1, l)) >
+                        tol * std::fabs(tri_solver.eigenvalues()(l)))
+                        converged = false;
+                }
+            }
+            
+            // invariant subspace, or maximum subspace size
+            if (m == m_max || beta(j) <= tol * std::fabs(alpha(j)))
+                break;
+
+            if (!converged) {
+                
+                if (m == m_cap) {
+                    
+                    m_cap = std::min<uint_t>(2*m_cap, m_max);
+                    Q.conservativeResize(n, m_cap);
+                    BQ.conservativeResize(n, m_cap);
+                }
+                
+                Q.col(m)  = w  / beta(j);
+                BQ.col(m) = Bw / beta(j);
+            }
+        }
+        
+        _n_iters = m;
+        
+        // if the subspace was exhausted before convergence then the eigenpairs
+        // are computed from the current subspace
+        if (m < nev)
+            tri_solver.computeFromTridiagonal(alpha.head(m), beta.head(m-1),
+                                              Eigen::ComputeEigenvectors);
+        _ritz_order(tri_solver.eigenvalues(), std::min(nev, m));
+        
+        // transform the eigenvalues back to the original problem
+        const uint_t
+        n_eig = _order.size();
+        
+        _eig.resize(n_eig);
+        for (uint_t i=0; i<n_eig; i++)
+            _eig(i) = shift + 1./tri_solver.eigenvalues()(_order[i]);
+        
+        if (computeEigenvectors) {
+            
+            _vec.resize(n, n_eig);
+            for (uint_t i=0; i<n_eig; i++)
+                _vec.col(i) = Q.leftCols(m) * tri_solver.eigenvectors().col(_order[i]);
+        }
+        else
+            _vec.resize(0, 0);
+    }
+    
+    
+    /*!
+     * stores in \p _order the indices of the \p nev eigenvalues \f$ \theta \f$ of
+     * largest magnitude, sorted in ascending order of \f$ \sigma + 1/\theta \f$
+     */
+    inline void _ritz_order(const vector_t &theta, uint_t nev) {
+        
+        _order.resize(theta.size());
+        for (uint_t i=0; i<_order.size(); i++) _order[i] = i;
+        
+        std::sort(_order.begin(), _order.end(),
+                  [&theta](uint_t a, uint_t b) {
+            return std::fabs(theta(a)) > std::fabs(theta(b));
+        });
+        
+        _order.resize(std::min<uint_t>(nev, _order.size()));
+        
+        std::sort(_order.begin(), _order.end(),
+                  [&theta](uint_t a, uint_t b) {
+            return 1./theta(a) < 1./theta(b);
+        });
+    }
+
+    
+    const std::vector<uint_t>    &_dofs;
+    bool                          _initialized;
+    bool                          _pattern_analyzed;
+    int                           _n;
+    uint_t                        _n_iters;
+    std::vector<int_t>            _dof_map;
+    std::vector<uint_t>           _order;
+    MatType                       _A_sub;
+    MatType                       _B_sub;
+    MatType                       _K;
+    LinearSolverType              _solver;
+    vector_t                      _eig;
+    matrix_t                      _vec;
+};
+
+}  // namespace EigenWrapper
+}  // namespace Solvers
+}  // namespace MAST
+
+#endif // __mast_eigen_constrained_sparse_generalized_hermitian_eigen_solver_h__
@@ -0,0 +1,243 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_eigen_mixed_precision_solver_h__
+#define __mast_eigen_mixed_precision_solver_h__
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+#include <mast/numerics/utility.hpp>
+
+
+namespace MAST {
+namespace Solvers {
+namespace EigenWrapper {
+
+/*!
+ * Direct solver for sparse systems that computes the factorization in low precision
+ * using \p LowSolverType, typically single precision, and recovers the accuracy of
+ * \p MatrixType by iterative refinement. Each refinement iteration computes the
+ * residual \f$ r = b - A x \f$ in the precision of \p MatrixType and corrects
+ * \f$ x \f$ with the low precision factorization. The low precision factorization
+ * requires roughly half the memory and time of the full precision factorization, and
+ * converges to full precision accuracy for operators with condition number
+ * sufficiently smaller than the inverse of the low precision machine epsilon.
+ *
+ * If the refinement does not converge to \p tol within \p max_iter iterations, or if the
+ * residual norm stagnates, then the factorization is computed with \p HighSolverType
+ * and used for this, and all subsequent, solves until the next factorization.
+ *
+ * The solver provides \p analyzePattern, \p factorize, \p compute and \p solve similar
+ * to the Eigen sparse solvers, so that it can be used as the linear solver of
+ * \p MAST::Solvers::EigenWrapper::NonlinearSolver. The matrix provided to
+ * \p factorize is referenced by the solver and must remain valid for all subsequent
+ * solves. \p LowSolverType must be a direct solver that stores its factors
+ * independently of the matrix, such as \p Eigen::SparseLU or
+ * \p Eigen::SimplicialLDLT, since the low precision copy of the matrix is not retained.
+ */
+template <typename MatrixType,
+          typename LowSolverType,
+          typename HighSolverType>
+class MixedPrecisionSolver {
+  
+public:
+    
+    using scalar_t     = typename MatrixType::Scalar;
+    using low_matrix_t = typename LowSolverType::MatrixType;
+    using low_scalar_t = typename low_matrix_t::Scalar;
+    using vector_t     = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    
+    static_assert(std::is_same<MatrixType, typename HighSolverType::MatrixType>::value,
+                  "Matrix type of solver and high precision solver must be same");
+
+    /*!
+     * tolerance on the residual norm relative to the norm of the right-hand side
+     */
+    real_t tol;
+    
+    /*!
+     * maximum number of refinement iterations before the full precision fallback
+     */
+    uint_t max_iter;
+    
+    /*!
+     * the refinement is considered stagnated if the residual norm in an iteration
+     * reduces by a factor larger than this value
+     */
+    real_t stagnation_ratio;
+    
+    MixedPrecisionSolver():
+    tol                  (1.e-12),
+    max_iter             (10),
+    stagnation_ratio     (0.5),
+    _mat                 (nullptr),
+    _high_analyzed       (false),
+    _use_high            (false),
+    _n_refine_iters      (0),
+    _n_fallbacks         (0) {
+        
+    }
+    
+    virtual ~MixedPrecisionSolver() { }
+    
+    
+    inline void analyzePattern(const MatrixType& m) {
+        
+        _low_solver.analyzePattern(low_matrix_t(m.template cast<low_scalar_t>()));
+        
+        // the full precision analysis is performed only if needed
+        _high_analyzed = false;
+    }
+    
+    
+    inline void factorize(const MatrixType& m) {
+        
+        _mat      = &m;
+        _use_high = false;
+        
+        // the low precision copy of the matrix is released once the factorization
+        // is computed, so that only the low precision factors are stored in
+        // addition to the full precision matrix
+        {
+            low_matrix_t
+            low_mat = m.template cast<low_scalar_t>();
+            _low_solver.factorize(low_mat);
+        }
+        
+        // the low precision factorization fails if the entries of the matrix
+        // or of its factors cannot be represented in low precision
+        if (_low_solver.info() != Eigen::Success)
+            _factorize_high();
+    }
+    
+    
+    inline void compute(const MatrixType& m) {
+        
+        this->analyzePattern(m);
+        this->factorize(m);
+    }
+    
+    
+    inline Eigen::ComputationInfo info() const {
+        
+        if (_use_high) return _high_solver.info();
+        else           return _low_solver.info();
+    }
+    
+    
+    /*!
+     * @returns \p true if the current factorization is computed in full precision
+     */
+    inline bool if_full_precision() const { return _use_high;}
+    
+    /*!
+     * @returns the total number of refinement iterations in all solves
+     */
+    inline uint_t n_refinement_iterations() const { return _n_refine_iters;}
+    
+    /*!
+     * @returns the number of times the full precision factorization was computed due
+     * to failure of the low precision factorization or of the refinement
+     */
+    inline uint_t n_fallbacks() const { return _n_fallbacks;}
+    
+    
+    /*!
+     * @returns the solution of \f$ A x = b \f$ . This is not thread-safe since the
+     * fallback to full precision updates the factorization.
+     */
+    template <typename VecType>
+    inline vector_t solve(const VecType& b) const {
+        
+        Assert0(_mat, "Matrix not factorized");
+        
+        if (_use_high) return _high_solver.solve(b);
+        
+        vector_t
+        x = _low_solver.solve(b.template cast<low_scalar_t>()).template cast<scalar_t>(),
+        r;
+        
+        real_t
+        b_norm = MAST::Numerics::Utility::real_norm(b),
+        r_norm = 0.,
+        r_old  = 0.;
+        
+        if (b_norm == 0.) return x;
+        
+        for (uint_t i=0; i<=max_iter; i++) {
+            
+            r      = b - (*_mat) * x;
+            r_old  = r_norm;
+            r_norm = MAST::Numerics::Utility::real_norm(r);
+            
+            if (r_norm <= tol * b_norm)
+                return x;
+            
+            if (i == max_iter ||
+                (i > 0 && r_norm > stagnation_ratio * r_old))
+                break;
+            
+            x += _low_solver.solve(r.template cast<low_scalar_t>()).template cast<scalar_t>();
+            _n_refine_iters++;
+        }
+        
+        // the refinement did not converge, so a full precision factorization is used
+        _factorize_high();
+        
+        return _high_solver.solve(b);
+    }
+    
+    
+private:
+    
+    inline void _factorize_high() const {
+        
+        if (!_high_analyzed) {
+            
+            _high_solver.analyzePattern(*_mat);
+            _high_analyzed = true;
+        }
+        
+        _high_solver.factorize(*_mat);
+        
+        Error(_high_solver.info() == Eigen::Success,
+              "Full precision factorization failed");
+        
+        _use_high = true;
+        _n_fallbacks++;
+    }
+    
+    const MatrixType         *_mat;
+    LowSolverType             _low_solver;
+    
+    // the full precision factorization is computed on demand from solve, hence
+    // these are mutable
+    mutable HighSolverType    _high_solver;
+    mutable bool              _high_analyzed;
+    mutable bool              _use_high;
+    mutable uint_t            _n_refine_iters;
+    mutable uint_t            _n_fallbacks;
+};
+
+} // EigenWrapper
+} // Solvers
+} // MAST
+
+#endif // __mast_eigen_mixed_precision_solver_h__
@@ -57,11 +57,32 @@ public:
     real_t rtol;
     uint_t max_iter;
     
+    /*!
+     * the Jacobian is assembled and factorized every \p lag_factorization iterations,
+     * and the iterations in between reuse the last factorization (modified Newton).
+     * A value of 1 factorizes the Jacobian at every iteration, and 0 only at the first
+     * iteration of each solve.
+     */
+    uint_t lag_factorization;
+    
+    /*!
+     * the Jacobian is factorized before it is due according to \p lag_factorization
+     * if the residual norm in the last iteration reduced by a factor larger than
+     * this value.
+     */
+    real_t lag_stagnation_ratio;
+    
     NonlinearSolver():
-    tol      (1.e-6),
-    rtol     (1.e-6),
-    max_iter (20),
-    _func    (nullptr) {
+    tol                  (1.e-6),
+    rtol                 (1.e-6),
+    max_iter             (20),
+    lag_factorization    (1),
+    lag_stagnation_ratio (0.5),
+    _func                (nullptr),
+    _jac_initialized     (false),
+    _pattern_analyzed    (false),
+    _n_iters             (0),
+    _n_factorizations    (0) {
         
     }
     
@@ -70,6 +91,98 @@ public:
         
     }
     
+    /*!
+     * clears the Jacobian matrix and the symbolic analysis of its sparsity pattern.
+     * This is necessary if the solver is to be used for a function with a different
+     * size or sparsity pattern.
+     */
+    inline void clear() {
+        
+        _jac_initialized  = false;
+        _pattern_analyzed = false;
+        _n_factorizations = 0;
+        _jac              = matrix_t();
+    }
+    
+    /*!
+     * @returns the factorization object. After \p solve this stores the factorization
+     * of the Jacobian computed at the last factorization during the Newton iterations.
+     */
+    inline const LinearSolverType& linear_solver() const { return _linear_solver;}
+    
+    /*!
+     * @returns the number of numeric factorizations since the last \p clear.
+     */
+    inline uint_t n_factorizations() const { return _n_factorizations;}
+
+    /*!
+     * @returns the number of Newton iterations in the last call to \p solve.
+     */
+    inline uint_t n_iterations() const { return _n_iters;}
+
+    /*!
+     * assembles the Jacobian of \p func at \p x and computes its factorization. The
+     * fill-reducing ordering and symbolic analysis of sparse solvers is performed only
+     * at the first call, and subsequent calls only compute the numeric factorization.
+     * This can be used after \p solve to factorize the Jacobian at the converged
+     * solution of a nonlinear problem before adjoint or sensitivity solves. For linear
+     * problems the factorization from \p solve is already at the solution.
+     */
+    inline void factorize(FuncType       &func,
+                          const vector_t &x) {
+        
+        if (!_jac_initialized) {
+            
+            func.init_matrix(_jac);
+            _jac_initialized = true;
+        }
+        
+        func.jacobian(x, _jac);
+        _factorize(_linear_solver, _jac, !_pattern_analyzed, 0);
+        _pattern_analyzed = true;
+        _n_factorizations++;
+    }
+    
+    /*!
+     * solves \f$ J x = b \f$ with the current factorization.
+     */
+    inline void solve_linear(const vector_t &b,
+                             vector_t       &x) const {
+        
+        Assert0(_n_factorizations, "Jacobian not factorized");
+        
+        x = _linear_solver.solve(b);
+    }
+
+    /*!
+     * solves the adjoint system \f$ J^T x = b \f$ with the current factorization.
+     * If \p LinearSolverType supports solution with the transpose of the matrix,
+     * then this is used directly. Otherwise, if \p symmetric is \p true the
+     * factorization of \f$ J \f$ is used, and if not a factorization of \f$ J^T \f$
+     * is computed for this solve.
+     */
+    inline void solve_adjoint(const vector_t &b,
+                              vector_t       &x,
+                              bool            symmetric = false) {
+        
+        Assert0(_n_factorizations, "Jacobian not factorized");
+        
+        if (_solve_transpose(_linear_solver, b, x, 0))
+            return;
+        else if (symmetric)
+            x = _linear_solver.solve(b);
+        else {
+            
+            matrix_t
+            jac_t = _jac.transpose();
+            
+            LinearSolverType
+            solver;
+            _factorize(solver, jac_t, true, 0);
+            x = solver.solve(b);
+        }
+    }
+    
     /*!
      * initialize the solver for function object \p func that provides the residual and jacobian evaluation.
      * If \p scope is provided then the solver will pass this to the \p KSPSetOptionsPrefix method.
@@ -85,23 +198,21 @@ public:
         x0,
         dx;
         
-        matrix_t
-        jac;
-        
         func.init_vector(res);
         func.init_vector(x0);
         func.init_vector(dx);
-        func.init_matrix(jac);
         
         func.residual(x, res);
 
         bool
-        if_cont = true;
+        if_cont      = true,
+        if_factorize = true;
         
         real_t
-        res_l2  = 0.,
-        res0_l2 = 0.,
-        dx_l2   = 0.;
+        res_l2     = 0.,
+        res0_l2    = 0.,
+        res_old_l2 = 0.,
+        dx_l2      = 0.;
         
         uint_t
         iter = 0;
@@ -115,9 +226,18 @@ public:
         
         while (if_cont) {
             
-            func.jacobian(x, jac);
+            // the Jacobian is factorized at the first iteration, at the interval
+            // specified by the lagging policy, or if the convergence with the lagged
+            // factorization has stagnated.
+            if_factorize =
+            (iter == 0) ||
+            (lag_factorization > 0 && iter % lag_factorization == 0) ||
+            (res_l2 > lag_stagnation_ratio * res_old_l2);
+            
+            if (if_factorize)
+                this->factorize(func, x);
 
-            dx    = LinearSolverType(jac).solve(res);
+            dx    = _linear_solver.solve(res);
             
             dx_l2 = MAST::Numerics::Utility::real_norm(dx);
 
@@ -134,6 +254,7 @@ public:
             iter++;
 
             // new residual
+            res_old_l2 = res_l2;
             func.residual(x, res);
             
             // check for convergence
@@ -173,13 +294,74 @@ public:
                 << std::endl;
             }
         }
+        
+        _n_iters = iter;
     }
     
     
 private:
 
-    FuncType        *_func;
-    std::string      _nm;
+    /*!
+     * computes the factorization of \p m using \p analyzePattern and \p factorize for
+     * solvers that provide these methods. The symbolic analysis is performed only if
+     * \p analyze is \p true.
+     */
+    template <typename SolverType, typename MatType>
+    static inline auto
+    _factorize(SolverType    &s,
+               const MatType &m,
+               bool           analyze,
+               int) -> decltype(s.analyzePattern(m), void()) {
+        
+        if (analyze) s.analyzePattern(m);
+        s.factorize(m);
+        
+        Error(s.info() == Eigen::Success, "Factorization of Jacobian failed");
+    }
+    
+    /*!
+     * computes the factorization of \p m for solvers that do not separate the
+     * symbolic and numeric factorizations, such as the dense solvers.
+     */
+    template <typename SolverType, typename MatType>
+    static inline void
+    _factorize(SolverType    &s,
+               const MatType &m,
+               bool           analyze,
+               long) {
+        
+        s.compute(m);
+    }
+
+    template <typename SolverType>
+    static inline auto
+    _solve_transpose(SolverType       &s,
+                     const vector_t   &b,
+                     vector_t         &x,
+                     int) -> decltype(x = s.transpose().solve(b), bool()) {
+        
+        x = s.transpose().solve(b);
+        return true;
+    }
+
+    template <typename SolverType>
+    static inline bool
+    _solve_transpose(SolverType       &s,
+                     const vector_t   &b,
+                     vector_t         &x,
+                     long) {
+        
+        return false;
+    }
+
+    
+    FuncType          *_func;
+    bool               _jac_initialized;
+    bool               _pattern_analyzed;
+    uint_t             _n_iters;
+    uint_t             _n_factorizations;
+    matrix_t           _jac;
+    LinearSolverType   _linear_solver;
 };
 
 } // EigenWrapper
@@ -20,9 +20,15 @@
 #ifndef __mast_petsc_linear_solver_h__
 #define __mast_petsc_linear_solver_h__
 
+// C++ includes
+#include <vector>
+#include <string>
+#include <algorithm>
+
 // MAST includes
 #include <mast/base/mast_data_types.h>
 #include <mast/base/exceptions.hpp>
+#include <mast/solvers/petsc/recycled_subspace.hpp>
 
 // PETSc includes
 #include <petsc.h>
@@ -38,21 +44,88 @@ class LinearSolver {
 public:
     
     LinearSolver(const MPI_Comm comm):
-    _comm  (comm),
-    _A     (nullptr) {
+    amg_threshold           (0.01),
+    amg_reuse_interpolation (true),
+    _comm                   (comm),
+    _ksp                    (nullptr),
+    _A                      (nullptr),
+    _P                      (nullptr),
+    _nsp                    (nullptr),
+    _subspace               (nullptr),
+    _A_state                (-1),
+    _n_pc_setup             (0),
+    _n_solves               (0),
+    _n_iterations           (0) {
         
     }
     
     
     virtual ~LinearSolver() {
         
+        this->clear();
+        
+        if (_nsp) MatNullSpaceDestroy(&_nsp);
+    }
+    
+    
+    /*!
+     * Threshold used to drop weak connections in the strength-of-connection graph of
+     * the \p PCGAMG preconditioner. Options provided on the command line take
+     * precedence.
+     */
+    real_t amg_threshold;
+    
+    /*!
+     * If \p true, the interpolation operators of \p PCGAMG (and \p PCML) are retained
+     * when the operator changes with the same nonzero pattern, for example between the
+     * design iterations of an optimization. Only the numeric Galerkin coarse operators
+     * and smoothers are then recomputed.
+     */
+    bool   amg_reuse_interpolation;
+    
+    
+    /*!
+     * Sets the near-nullspace of the operator, for example the rigid-body modes
+     * created by \p MAST::Physics::Elasticity::libMeshWrapper::NullSpace. This is
+     * attached to the preconditioner matrix with every call to \p set_operators so that
+     * smoothed aggregation multigrid can construct its tentative prolongators from
+     * these modes. The block size used for nodal aggregation is obtained from the
+     * matrix and should be set when the matrix is created with node-major dofs.
+     * This should be called before \p init.
+     */
+    inline void set_near_null_space(MatNullSpace nsp) {
+        
+        if (nsp) PetscObjectReference((PetscObject)nsp);
+        if (_nsp) MatNullSpaceDestroy(&_nsp);
+        
+        _nsp = nsp;
+        
+        if (_P && _nsp) MatSetNearNullSpace(_P, _nsp);
+    }
+    
+
+    /*!
+     * destroys the \p KSP object so that the solver can be initialized again, possibly
+     * for operators of different size.
+     */
+    inline void clear() {
+        
         if (_ksp) {
             
             PetscErrorCode
             ierr = KSPDestroy(&_ksp);
             CHKERRABORT(_comm, ierr);
         }
+        
+        _ksp        = nullptr;
+        _A          = nullptr;
+        _P          = nullptr;
+        _A_state    = -1;
+        _n_pc_setup = 0;
     }
+
+    
+    inline bool is_initialized() const { return _ksp != nullptr;}
     
     /*!
      * initialize the solver for operator matrix \p A. This creates the \p KSP object
@@ -62,10 +135,8 @@ public:
      */
     inline void init(Mat A, const std::string* scope = nullptr) {
 
-        Assert0(!_A, "solver already initialized");
+        Assert0(!_ksp, "solver already initialized");
 
-        _A = &A;
-        
         PC pc;
         
         // setup the KSP
@@ -80,8 +151,8 @@ public:
             CHKERRABORT(_comm, ierr);
         }
 
-        ierr = KSPSetOperators(_ksp, *_A, *_A);
-        CHKERRABORT(_comm, ierr);
+        this->set_operators(A);
+        _n_pc_setup = 1;
         
         ierr = KSPSetFromOptions(_ksp);
         CHKERRABORT(_comm, ierr);
@@ -90,9 +161,140 @@ public:
         ierr = KSPGetPC(_ksp, &pc);
         CHKERRABORT(_comm, ierr);
         
+        _set_amg_defaults(pc);
+        
         ierr = PCSetFromOptions(pc);
         CHKERRABORT(_comm, ierr);
+        
+        // the defaults have been read by the PC, and are removed from the options
+        // database so that they do not apply to other solvers
+        _clear_default_options();
+    }
+    
+    
+    /*!
+     * sets the operator matrix \p A and the matrix \p P used to construct the
+     * preconditioner. If \p P is not provided then \p A is used for both. The
+     * \p KSP object, along with its options, is retained. If the matrices have the
+     * same nonzero pattern as before then the preconditioner reuses its symbolic
+     * data, for example the symbolic factorization of direct solvers or the
+     * aggregates of algebraic multigrid, when it is next setup.
+     */
+    inline void set_operators(Mat A, Mat P = nullptr) {
+        
+        Assert0(_ksp, "solver not initialized");
+        
+        _A = A;
+        _P = P?P:A;
+        
+        PetscErrorCode
+        ierr = KSPSetOperators(_ksp, _A, _P);
+        CHKERRABORT(_comm, ierr);
+        
+        // the near-nullspace is attached before the state of the operator is
+        // recorded so that this is not seen as a change in the operator
+        if (_nsp) MatSetNearNullSpace(_P, _nsp);
+        
+        ierr = PetscObjectStateGet((PetscObject)_A, &_A_state);
+        CHKERRABORT(_comm, ierr);
+    }
+    
+    
+    /*!
+     * Prepares the solver for solves with operator \p A. The solver is initialized
+     * if this has not been done already. If \p A is the same matrix as the current
+     * operator and has not been modified since it was set, then nothing is done so
+     * that the preconditioner, or factorization, is reused for all subsequent solves.
+     * This allows one object to be used for the forward solve and all adjoint
+     * solves with the same operator, and to be retained across the design
+     * iterations of an optimization, where the operator has the same nonzero
+     * pattern. \p scope is used only if the solver is initialized by this call.
+     * @returns \p true if the operator was updated.
+     */
+    inline bool update_operators(Mat A, const std::string* scope = nullptr) {
+        
+        if (!_ksp) {
+            
+            this->init(A, scope);
+            return true;
+        }
+        
+        PetscObjectState
+        state = -1;
+        
+        PetscErrorCode
+        ierr = PetscObjectStateGet((PetscObject)A, &state);
+        CHKERRABORT(_comm, ierr);
+
+        if (A == _A && state == _A_state)
+            return false;
+        
+        this->reinit(A);
+        return true;
+    }
+    
+    
+    /*!
+     * Prepares the solver for a new solve with operator \p A, which is typically the
+     * same matrix with updated values. If \p reuse_pc is \p true, then the preconditioner
+     * computed for the previous operator is used without any update. Otherwise the
+     * preconditioner is recomputed at the next solve from the numeric values of \p A.
+     */
+    inline void reinit(Mat A, bool reuse_pc = false) {
+        
+        Assert0(_ksp, "solver not initialized");
+        
+        this->set_operators(A);
+        this->set_reuse_preconditioner(reuse_pc);
+    }
+    
+    
+    inline void set_reuse_preconditioner(bool f) {
+        
+        Assert0(_ksp, "solver not initialized");
+        
+        PetscErrorCode
+        ierr = KSPSetReusePreconditioner(_ksp, f?PETSC_TRUE:PETSC_FALSE);
+        CHKERRABORT(_comm, ierr);
+        
+        if (!f) _n_pc_setup++;
     }
+
+    
+    /*!
+     * @returns the number of times the preconditioner was requested to be recomputed
+     * since initialization.
+     */
+    inline uint_t n_preconditioner_setups() const { return _n_pc_setup;}
+    
+    
+    /*!
+     * Sets the subspace of previous solutions used to compute the initial guess of
+     * \p solve and \p solve_transpose. Each solution is added to the subspace after the
+     * solve. The subspace is owned by the caller so that it can be retained when this
+     * solver is cleared or recreated. A \p nullptr disables the use of the subspace,
+     * in which case the Krylov solves start from a zero initial guess. The subspace is
+     * not used if the \p KSP type is \p KSPPREONLY, as is the case for direct solvers.
+     * Each initial guess requires one product with the operator for every vector in
+     * the subspace, so this is useful only if this is cheaper than the Krylov
+     * iterations it saves.
+     */
+    inline void set_recycled_subspace(MAST::Solvers::PETScWrapper::RecycledSubspace* s) {
+        
+        _subspace = s;
+    }
+    
+    
+    /*!
+     * @returns the number of single right-hand side solves since construction
+     */
+    inline uint_t n_solves() const { return _n_solves;}
+    
+    /*!
+     * @returns the total number of Krylov iterations of all single right-hand side
+     * solves since construction
+     */
+    inline uint_t n_iterations() const { return _n_iterations;}
     
     
     /*!
@@ -101,14 +303,145 @@ public:
      */
     inline void solve(Vec x, Vec b) {
         
-        Assert0(_A, "solver not initialized");
+        Assert0(_ksp, "solver not initialized");
+        
+        this->_solve(x, b, false);
+    }
+    
+
+    /*!
+     * Solves \f$ A X = B \f$ for multiple right-hand sides stored as columns of the
+     * dense matrix \p B, with the solutions returned in the columns of the dense matrix
+     * \p X. With PETSc 3.14 or later this uses \p KSPMatSolve, which uses block Krylov
+     * methods or the multiple right-hand side triangular solves of direct solvers.
+     * Otherwise, each column is solved in turn with the same preconditioner.
+     */
+    inline void solve(Mat X, Mat B) {
+        
+        Assert0(_ksp, "solver not initialized");
         
         PetscErrorCode
         ierr = 0;
-        
-        // now solve
-        ierr = KSPSolve(_ksp, b, x);
+
+#if PETSC_VERSION_GE(3,14,0)
+        ierr = KSPMatSolve(_ksp, B, X);
         CHKERRABORT(_comm, ierr);
+#else
+        Vec
+        x,
+        b;
+        PetscInt
+        n_rhs = 0,
+        x_lda = 0,
+        b_lda = 0;
+        PetscScalar
+        *x_vals = nullptr,
+        *b_vals = nullptr;
+        
+        // the columns of the dense matrices are stored with the leading dimension,
+        // which may be larger than the number of local rows
+        MatCreateVecs(_A, &x, &b);
+        MatGetSize(B, PETSC_NULL, &n_rhs);
+        MatDenseGetLDA(X, &x_lda);
+        MatDenseGetLDA(B, &b_lda);
+        MatDenseGetArray(X, &x_vals);
+        MatDenseGetArray(B, &b_vals);
+
+        for (PetscInt i=0; i<n_rhs; i++) {
+            
+            VecPlaceArray(x, x_vals+i*x_lda);
+            VecPlaceArray(b, b_vals+i*b_lda);
+            ierr = KSPSolve(_ksp, b, x);
+            CHKERRABORT(_comm, ierr);
+            VecResetArray(x);
+            VecResetArray(b);
+        }
+        
+        MatDenseRestoreArray(X, &x_vals);
+        MatDenseRestoreArray(B, &b_vals);
+        VecDestroy(&x);
+        VecDestroy(&b);
+#endif
+    }
+    
+    
+    /*!
+     * Solves \f$ A x_i = b_i \f$ for all vectors in \p b as a single block solve. The
+     * vectors are copied to the columns of a dense matrix, solved with
+     * \p solve(Mat, Mat) and the solutions are copied back to \p x. This is used for
+     * multiple adjoint solves with the same operator, with the adjoint right-hand sides
+     * assembled by \p MultiOutputDerivative.
+     */
+    inline void solve(const std::vector<Vec> &x,
+                      const std::vector<Vec> &b) {
+        
+        Assert0(_ksp, "solver not initialized");
+        Assert2(x.size() == b.size(), x.size(), b.size(),
+                "Incompatible number of solution and RHS vectors");
+        
+        if (b.empty()) return;
+        
+        Mat
+        X,
+        B;
+        PetscInt
+        m     = 0,
+        n     = 0,
+        lda   = 0;
+        PetscScalar
+        *vals = nullptr;
+        const PetscScalar
+        *v    = nullptr;
+        
+        VecGetLocalSize(b[0], &m);
+        VecGetSize(b[0], &n);
+        MatCreateDense(_comm, m, PETSC_DECIDE, n, (PetscInt)b.size(), PETSC_NULL, &B);
+        MatCreateDense(_comm, m, PETSC_DECIDE, n, (PetscInt)b.size(), PETSC_NULL, &X);
+        
+        // copy the RHS vectors to the columns of B
+        MatDenseGetLDA(B, &lda);
+        MatDenseGetArray(B, &vals);
+        for (uint_t i=0; i<b.size(); i++) {
+            
+            VecGetArrayRead(b[i], &v);
+            std::copy(v, v+m, vals+i*lda);
+            VecRestoreArrayRead(b[i], &v);
+        }
+        MatDenseRestoreArray(B, &vals);
+        MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY);
+        MatAssemblyBegin(X, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(X, MAT_FINAL_ASSEMBLY);
+        
+        this->solve(X, B);
+        
+        // copy the solutions from columns of X
+        MatDenseGetLDA(X, &lda);
+        MatDenseGetArray(X, &vals);
+        for (uint_t i=0; i<x.size(); i++) {
+            
+            PetscScalar
+            *xv = nullptr;
+            VecGetArray(x[i], &xv);
+            std::copy(vals+i*lda, vals+i*lda+m, xv);
+            VecRestoreArray(x[i], &xv);
+        }
+        MatDenseRestoreArray(X, &vals);
+        
+        MatDestroy(&X);
+        MatDestroy(&B);
+    }
+    
+    
+    /*!
+     * Solves \f$ A^T x = b \f$ using the same \p KSP and preconditioner as \p solve.
+     * For symmetric operators the adjoint solves can use either of the two methods.
+     */
+    inline void solve_transpose(Vec x, Vec b) {
+        
+        Assert0(_ksp, "solver not initialized");
+        
+        this->_solve(x, b, true);
     }
     
 
@@ -120,10 +453,149 @@ public:
     
 private:
 
+    inline void _solve(Vec x, Vec b, bool transpose) {
+        
+        PetscErrorCode
+        ierr = 0;
+        
+        PetscInt
+        n_its = 0;
+        
+        // the subspace is not used with direct solvers, which do not accept an
+        // initial guess
+        PetscBool
+        preonly = PETSC_FALSE;
+        ierr = PetscObjectTypeCompare((PetscObject)_ksp, KSPPREONLY, &preonly);
+        CHKERRABORT(_comm, ierr);
+        
+        const bool
+        use_subspace = _subspace && !preonly;
+
+        if (use_subspace) {
+            
+            bool
+            f = _subspace->initial_guess(_A, b, x, transpose);
+            
+            ierr = KSPSetInitialGuessNonzero(_ksp, f?PETSC_TRUE:PETSC_FALSE);
+            CHKERRABORT(_comm, ierr);
+        }
+        
+        // now solve
+        if (transpose) ierr = KSPSolveTranspose(_ksp, b, x);
+        else           ierr = KSPSolve(_ksp, b, x);
+        CHKERRABORT(_comm, ierr);
+        
+        ierr = KSPGetIterationNumber(_ksp, &n_its);
+        CHKERRABORT(_comm, ierr);
+
+        _n_solves++;
+        _n_iterations += n_its;
+        
+        if (use_subspace) _subspace->add(x);
+    }
+    
+    
+    /*!
+     * sets the default parameters of algebraic multigrid preconditioners before the
+     * command line options are processed. \p PCGAMG is configured through its API,
+     * while defaults for \p PCML and \p PCHYPRE are added to the options database
+     * only if they are not already provided by the user.
+     */
+    inline void _set_amg_defaults(PC pc) {
+        
+        PCType
+        type = nullptr;
+        PCGetType(pc, &type);
+        
+        if (!type) return;
+        
+        PetscInt
+        bs   = 1;
+        MatGetBlockSize(_P, &bs);
+        
+        if (std::string(type) == PCGAMG) {
+            
+            PetscReal
+            th = amg_threshold;
+            
+            PCGAMGSetThreshold(pc, &th, 1);
+            PCGAMGSetNSmooths(pc, 1);
+            PCGAMGSetReuseInterpolation(pc, amg_reuse_interpolation?PETSC_TRUE:PETSC_FALSE);
+        }
+        else if (std::string(type) == PCML) {
+            
+            if (amg_reuse_interpolation)
+                _set_default_option("pc_ml_reuse_interpolation", "true");
+        }
+        else if (std::string(type) == PCHYPRE) {
+            
+            // BoomerAMG uses a different measure of strength, for which 0.5 is
+            // recommended for 3D problems
+            _set_default_option("pc_hypre_boomeramg_strong_threshold", "0.5");
+            
+            // nodal coarsening for systems with node-major dofs
+            if (bs > 1)
+                _set_default_option("pc_hypre_boomeramg_nodal_coarsen", "6");
+        }
+    }
+
+    
+    /*!
+     * sets option \p nm with the prefix of the \p KSP to \p val, unless it has been
+     * provided by the user. PETSc does not provide an API for these options of
+     * \p PCML and \p PCHYPRE, so they are inserted in the options database and
+     * removed by \p _clear_default_options after they are read by the PC.
+     */
+    inline void _set_default_option(const std::string& nm,
+                                    const std::string& val) {
+        
+        const char
+        *prefix = nullptr;
+        PetscBool
+        flg     = PETSC_FALSE;
+        
+        KSPGetOptionsPrefix(_ksp, &prefix);
+        PetscOptionsHasName(PETSC_NULL, prefix, ("-" + nm).c_str(), &flg);
+        
+        if (!flg) {
+            
+            std::string
+            opt = "-" + std::string(prefix?prefix:"") + nm;
+            
+            PetscErrorCode
+            ierr = PetscOptionsSetValue(PETSC_NULL, opt.c_str(), val.c_str());
+            CHKERRABORT(_comm, ierr);
+            
+            _default_options.push_back(opt);
+        }
+    }
+    
+    
+    inline void _clear_default_options() {
+        
+        for (uint_t i=0; i<_default_options.size(); i++) {
+            
+            PetscErrorCode
+            ierr = PetscOptionsClearValue(PETSC_NULL, _default_options[i].c_str());
+            CHKERRABORT(_comm, ierr);
+        }
+        
+        _default_options.clear();
+    }
+    
+
     const MPI_Comm   _comm;
     
-    KSP  _ksp;
-    Mat *_A;
+    KSP               _ksp;
+    Mat               _A;
+    Mat               _P;
+    MatNullSpace      _nsp;
+    MAST::Solvers::PETScWrapper::RecycledSubspace *_subspace;
+    PetscObjectState  _A_state;
+    uint_t            _n_pc_setup;
+    uint_t            _n_solves;
+    uint_t            _n_iterations;
+    std::vector<std::string> _default_options;
 };
 
 }
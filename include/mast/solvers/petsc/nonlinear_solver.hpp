@@ -22,6 +22,8 @@
 
 // C++ includes
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
 
 // MAST includes
 #include <mast/base/mast_data_types.h>
@@ -45,12 +47,72 @@ public:
     real_t rtol;
     uint_t max_iter;
     
+    /*!
+     * the preconditioner is recomputed every \p lag_preconditioner iterations. A value
+     * of 1 recomputes the preconditioner for each Jacobian, and 0 computes it only at the
+     * first iteration of each solve. This is analogous to \p -snes_lag_preconditioner .
+     */
+    uint_t lag_preconditioner;
+    
+    /*!
+     * the preconditioner is recomputed before it is due according to
+     * \p lag_preconditioner if the residual norm in the last iteration reduced by
+     * a factor larger than this value, which indicates stagnation due to the lagged
+     * preconditioner.
+     */
+    real_t lag_stagnation_ratio;
+    
+    /*!
+     * if \p true, a backtracking line search is used along the Newton direction.
+     * The full step is accepted if it satisfies the sufficient decrease condition
+     * \f$ \| R(x - \lambda dx) \|^2 \leq (1 - 2 c \lambda) \| R(x) \|^2 \f$ with
+     * \f$ c = \f$ \p line_search_c . Otherwise, \f$ \lambda \f$ is reduced using the
+     * minimum of a quadratic fit through the computed residual norms. The residual
+     * at the accepted point is used for the next iteration, so that the full step does
+     * not require any additional residual evaluations. If the condition is not satisfied
+     * in \p line_search_max_iter reductions of the step, the trial step with the smallest
+     * residual norm is accepted and the failure is reported. Line search is disabled
+     * by default.
+     */
+    bool   line_search;
+    real_t line_search_c;
+    uint_t line_search_max_iter;
+    
+    /*!
+     * if \p true, the relative tolerance of the linear solver is adapted using the
+     * Eisenstat-Walker method (choice 2), so that the early Newton iterations are
+     * not solved to a tighter tolerance than is useful. \p ew_eta0 is the tolerance
+     * at the first iteration, and \p ew_eta_max is the upper limit of the tolerance.
+     * The tolerances of the \p KSP, including those set from the options database, are
+     * restored at the end of each solve.
+     */
+    bool   eisenstat_walker;
+    real_t ew_eta0;
+    real_t ew_eta_max;
+    real_t ew_gamma;
+    real_t ew_alpha;
+    
     NonlinearSolver(const MPI_Comm comm):
-    tol      (1.e-6),
-    rtol     (1.e-6),
-    max_iter (20),
-    _comm    (comm),
-    _func    (nullptr) {
+    tol                  (1.e-6),
+    rtol                 (1.e-6),
+    max_iter             (20),
+    lag_preconditioner   (1),
+    lag_stagnation_ratio (0.5),
+    line_search          (false),
+    line_search_c        (1.e-4),
+    line_search_max_iter (10),
+    eisenstat_walker     (false),
+    ew_eta0              (0.3),
+    ew_eta_max           (0.9),
+    ew_gamma             (0.9),
+    ew_alpha             (0.5*(1.+std::sqrt(5.))),
+    _comm                (comm),
+    _linear_solver       (comm),
+    _n_iters             (0),
+    _n_linear_iters      (0),
+    _n_residuals         (0),
+    _n_jacobians         (0),
+    _n_ls_failures       (0) {
         
     }
     
@@ -59,6 +121,26 @@ public:
         
     }
     
+    /*!
+     * @returns the linear solver used for Newton updates. The \p KSP of this solver is
+     * created at the first Newton iteration and retained for subsequent iterations and
+     * solves, so that the preconditioner can reuse the symbolic information from its
+     * previous setup.
+     */
+    inline MAST::Solvers::PETScWrapper::LinearSolver& linear_solver() {
+        
+        return _linear_solver;
+    }
+    
+    /*!
+     * destroys the \p KSP object used for the linear solves. This is necessary if the
+     * solver is to be used for a system of a different size.
+     */
+    inline void clear() {
+        
+        _linear_solver.clear();
+    }
+    
     /*!
      * initialize the solver for function object \p func that provides the residual and jacobian evaluation.
      * If \p scope is provided then the solver will pass this to the \p KSPSetOptionsPrefix method.
@@ -79,20 +161,44 @@ public:
         
         VecZeroEntries(res);
 
+        _n_iters        = 0;
+        _n_linear_iters = 0;
+        _n_residuals    = 0;
+        _n_jacobians    = 0;
+        _n_ls_failures  = 0;
+
         func.residual(x, res);
+        _n_residuals++;
         jac = func.matrix();
 
         bool
         if_cont = true;
         
         real_t
-        res_l2  = 0.,
-        res0_l2 = 0.,
-        dx_l2   = 0.;
+        res_l2     = 0.,
+        res0_l2    = 0.,
+        res_old_l2 = 0.,
+        dx_l2      = 0.,
+        lambda     = 1.,
+        eta        = ew_eta0;
+        
+        bool
+        if_pc_setup = true;
         
         uint_t
         iter = 0;
         
+        PetscInt
+        n_ksp_iters = 0,
+        ksp_maxits  = 0;
+        
+        // tolerances of the linear solver, which are modified by the Eisenstat-Walker
+        // method and restored at the end of the solve
+        PetscReal
+        ksp_rtol    = 0.,
+        ksp_abstol  = 0.,
+        ksp_dtol    = 0.;
+        
         VecNorm(res, NORM_2, &res_l2);
         res0_l2 = res_l2;
         
@@ -104,35 +210,72 @@ public:
         while (if_cont) {
             
             func.jacobian(x, *jac);
+            _n_jacobians++;
 
-            MAST::Solvers::PETScWrapper::LinearSolver solver(_comm);
-            solver.init(*jac, _nm.size()?&_nm:nullptr);
-            solver.solve(dx, res);
+            // the preconditioner is recomputed at the first iteration, at the
+            // interval specified by the lagging policy, or if the convergence with
+            // the lagged preconditioner has stagnated.
+            if_pc_setup =
+            (iter == 0) ||
+            (lag_preconditioner > 0 && iter % lag_preconditioner == 0) ||
+            (res_l2 > lag_stagnation_ratio * res_old_l2);
+            
+            if (!_linear_solver.is_initialized())
+                _linear_solver.init(*jac, scope);
+            else
+                _linear_solver.reinit(*jac, !if_pc_setup);
+            
+            if (eisenstat_walker) {
+                
+                if (iter == 0)
+                    KSPGetTolerances(_linear_solver.ksp(),
+                                     &ksp_rtol,
+                                     &ksp_abstol,
+                                     &ksp_dtol,
+                                     &ksp_maxits);
+                else
+                    eta = _ew_forcing_term(eta, res_l2, res_old_l2);
+                
+                KSPSetTolerances(_linear_solver.ksp(),
+                                 eta,
+                                 PETSC_DEFAULT,
+                                 PETSC_DEFAULT,
+                                 PETSC_DEFAULT);
+            }
+            
+            _linear_solver.solve(dx, res);
+            
+            KSPGetIterationNumber(_linear_solver.ksp(), &n_ksp_iters);
+            _n_linear_iters += n_ksp_iters;
             
             VecNorm(dx, NORM_2, &dx_l2);
 
             // output
             std::cout
             << " : || dx ||_2 = "
-            << std::setw(15) << dx_l2 << std::endl;
+            << std::setw(15) << dx_l2
+            << " : KSP iters = "
+            << std::setw(5) << n_ksp_iters << std::endl;
 
-            // x = x + dx
-            VecAXPY(x, -1., dx);
-
-            // copy solution to another vector
+            // copy solution to another vector before the update
             VecCopy(x, x0);
             iter++;
-
-            // new residual
-            func.residual(x, res);
             
-            // check for convergence
-            VecNorm(res, NORM_2, &res_l2);
-
+            // x = x0 - lambda dx, and the new residual. The residual is evaluated
+            // at the trial points of the line search, and the one at the accepted point
+            // is used for the next iteration.
+            res_old_l2 = res_l2;
+            lambda     = _update_solution(func, x0, dx, res_old_l2, x, res, res_l2);
+            
             std::cout
             << " Iter: " << std::setw(5) << iter
             << " : || res ||_2 = "
             << std::setw(15) << res_l2;
+            
+            if (lambda < 1.)
+                std::cout
+                << " : step = "
+                << std::setw(15) << lambda;
 
             if (res_l2/res0_l2 < rtol) {
                 
@@ -163,14 +306,153 @@ public:
                 << std::endl;
             }
         }
+        
+        _n_iters = iter;
+        
+        if (eisenstat_walker)
+            KSPSetTolerances(_linear_solver.ksp(),
+                             ksp_rtol,
+                             ksp_abstol,
+                             ksp_dtol,
+                             ksp_maxits);
+        
+        // the lagged preconditioner is not retained beyond this solve, so that a later
+        // solve with the same KSP, for example an adjoint solve through
+        // linear_solver(), recomputes the preconditioner for its operator.
+        KSPSetReusePreconditioner(_linear_solver.ksp(), PETSC_FALSE);
+        
+        std::cout
+        << " Newton iters: "      << _n_iters
+        << " : linear iters: "    << _n_linear_iters
+        << " : residual evals: "  << _n_residuals
+        << " : Jacobian evals: "  << _n_jacobians
+        << " : PC setups: "       << _linear_solver.n_preconditioner_setups()
+        << std::endl;
+        
+        VecDestroy(&res);
+        VecDestroy(&x0);
+        VecDestroy(&dx);
     }
     
     
+    /*!
+     * statistics from the last call to \p solve
+     */
+    inline uint_t n_iterations() const { return _n_iters;}
+    inline uint_t n_linear_iterations() const { return _n_linear_iters;}
+    inline uint_t n_residual_evaluations() const { return _n_residuals;}
+    inline uint_t n_jacobian_evaluations() const { return _n_jacobians;}
+    inline uint_t n_line_search_failures() const { return _n_ls_failures;}
+    
+    
 private:
 
-    const MPI_Comm   _comm;
-    FuncType        *_func;
-    std::string      _nm;
+    /*!
+     * updates the solution as \f$ x = x_0 - \lambda dx \f$ and computes the residual
+     * \p res and its norm \p res_l2 at the updated solution. If line search is enabled,
+     * \f$ \lambda \f$ is selected by backtracking from the full step. If no trial step
+     * satisfies the sufficient decrease condition, the one with the smallest residual norm
+     * is used.
+     * @returns the step length \f$ \lambda \f$ .
+     */
+    inline real_t _update_solution(FuncType&  func,
+                                   Vec        x0,
+                                   Vec        dx,
+                                   real_t     res0_l2,
+                                   Vec        x,
+                                   Vec        res,
+                                   real_t    &res_l2) {
+        
+        real_t
+        lambda      = 1.,
+        lambda_best = 1.,
+        f0          = res0_l2 * res0_l2,
+        f           = 0.,
+        f_best      = 0.;
+
+        uint_t
+        ls_iter  = 0;
+        
+        while (true) {
+            
+            VecWAXPY(x, -lambda, dx, x0);
+            func.residual(x, res);
+            _n_residuals++;
+            VecNorm(res, NORM_2, &res_l2);
+            
+            f = res_l2 * res_l2;
+            
+            if (!line_search ||
+                f <= (1. - 2. * line_search_c * lambda) * f0)
+                break;
+            
+            if (ls_iter == 0 || f < f_best) {
+                
+                lambda_best = lambda;
+                f_best      = f;
+            }
+            
+            if (ls_iter >= line_search_max_iter) {
+                
+                _n_ls_failures++;
+                
+                std::cout
+                << " : line search failed, using step = "
+                << std::setw(15) << lambda_best;
+                
+                // the residual is recomputed if the last trial is not the one
+                // with the smallest residual
+                if (lambda_best != lambda) {
+                    
+                    lambda = lambda_best;
+                    VecWAXPY(x, -lambda, dx, x0);
+                    func.residual(x, res);
+                    _n_residuals++;
+                    VecNorm(res, NORM_2, &res_l2);
+                }
+                
+                break;
+            }
+            
+            // minimum of the quadratic that matches f(0), f'(0) = -2 f(0) and f(lambda),
+            // safeguarded to reduce the step by a factor between 0.1 and 0.5
+            lambda = std::max(0.1 * lambda,
+                              std::min(0.5 * lambda,
+                                       f0 * lambda * lambda / (f - f0 + 2. * f0 * lambda)));
+            ls_iter++;
+        }
+        
+        return lambda;
+    }
+    
+    
+    /*!
+     * @returns the Eisenstat-Walker forcing term (choice 2) for the current iteration given
+     * the term \p eta_old from the previous iteration and the residual norms at the
+     * current and previous iterates.
+     */
+    inline real_t _ew_forcing_term(real_t eta_old,
+                                   real_t res_l2,
+                                   real_t res_old_l2) const {
+        
+        real_t
+        eta = ew_gamma * std::pow(res_l2/res_old_l2, ew_alpha),
+        eta_safe = ew_gamma * std::pow(eta_old, ew_alpha);
+        
+        // safeguard to avoid a rapid decrease of the tolerance
+        if (eta_safe > 0.1) eta = std::max(eta, eta_safe);
+        
+        return std::min(eta, ew_eta_max);
+    }
+    
+    
+    const MPI_Comm                               _comm;
+    MAST::Solvers::PETScWrapper::LinearSolver    _linear_solver;
+    uint_t                                       _n_iters;
+    uint_t                                       _n_linear_iters;
+    uint_t                                       _n_residuals;
+    uint_t                                       _n_jacobians;
+    uint_t                                       _n_ls_failures;
 };
 
 } // PETScWrapper
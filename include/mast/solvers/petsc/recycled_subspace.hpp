@@ -0,0 +1,222 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_petsc_recycled_subspace_h__
+#define __mast_petsc_recycled_subspace_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/base/exceptions.hpp>
+
+// PETSc includes
+#include <petsc.h>
+
+
+namespace MAST {
+namespace Solvers {
+namespace PETScWrapper {
+
+/*!
+ * Subspace spanned by the solutions of previous linear solves, which is used to
+ * compute the initial guess for subsequent solves with a modified operator. This is
+ * intended for sequences of solves where the operator changes slowly, for example
+ * between the design iterations of a topology optimization, or between the forward and
+ * adjoint solves of the same iteration.
+ *
+ * The basis \f$ W \f$ is kept orthonormal. For a new system \f$ A x = b \f$ the
+ * initial guess is obtained from the Galerkin projection
+ * \f$ x_0 = W (W^T A W)^{-1} W^T b \f$, which for symmetric positive definite
+ * operators minimizes the energy norm of the error over the subspace. The residual
+ * of the Krylov solve is then orthogonal to all previous solutions, which deflates the
+ * components of the solution already captured in the subspace. The projected system
+ * is recomputed with the current operator for each solve, so that the subspace remains
+ * valid when the operator changes.
+ *
+ * The object is independent of \p LinearSolver so that it can be shared by solvers
+ * for the same problem and retained when the solvers are recreated.
+ */
+class RecycledSubspace {
+    
+public:
+    
+    RecycledSubspace(uint_t max_size = 10):
+    tol        (1.e-8),
+    _max_size  (max_size),
+    _n_guesses (0) {
+        
+        Assert1(max_size > 0, max_size, "Subspace size must be positive");
+    }
+    
+    
+    virtual ~RecycledSubspace() {
+        
+        this->clear();
+    }
+    
+    
+    /*!
+     * relative norm of the component of a new vector orthogonal to the subspace below
+     * which the vector is not added to the subspace.
+     */
+    real_t tol;
+
+    
+    inline void clear() {
+        
+        for (uint_t i=0; i<_W.size(); i++)
+            VecDestroy(&_W[i]);
+        
+        _W.clear();
+        _n_guesses = 0;
+    }
+    
+    
+    inline uint_t size() const { return _W.size();}
+    
+    inline uint_t max_size() const { return _max_size;}
+    
+    /*!
+     * @returns the number of initial guesses computed from the subspace.
+     */
+    inline uint_t n_initial_guesses() const { return _n_guesses;}
+    
+    
+    /*!
+     * computes the initial guess \p x for the solution of \f$ A x = b \f$ , or
+     * \f$ A^T x = b \f$ if \p transpose is \p true, from the Galerkin projection on
+     * the subspace. \p x is set to zero if the subspace is empty.
+     * @returns \p true if a nonzero initial guess was computed.
+     */
+    inline bool initial_guess(Mat A, Vec b, Vec x, bool transpose = false) {
+        
+        VecSet(x, 0.);
+        
+        const uint_t
+        n = _W.size();
+        
+        if (n == 0) return false;
+        
+        Vec
+        Aw;
+        VecDuplicate(x, &Aw);
+        
+        std::vector<PetscScalar>
+        v(n, 0.);
+        
+        Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>
+        WtAW = Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>::Zero(n, n);
+        
+        Eigen::Matrix<real_t, Eigen::Dynamic, 1>
+        Wtb  = Eigen::Matrix<real_t, Eigen::Dynamic, 1>::Zero(n),
+        y;
+        
+        // projected operator, computed with the current operator since this may have
+        // changed after the vectors were added
+        for (uint_t j=0; j<n; j++) {
+            
+            if (transpose) MatMultTranspose(A, _W[j], Aw);
+            else           MatMult(A, _W[j], Aw);
+            
+            VecMDot(Aw, n, _W.data(), v.data());
+            for (uint_t i=0; i<n; i++) WtAW(i, j) = PetscRealPart(v[i]);
+        }
+        
+        VecMDot(b, n, _W.data(), v.data());
+        for (uint_t i=0; i<n; i++) Wtb(i) = PetscRealPart(v[i]);
+
+        VecDestroy(&Aw);
+
+        // the rank-revealing decomposition protects against a projected operator that
+        // is singular due to the constraints
+        y = WtAW.colPivHouseholderQr().solve(Wtb);
+        
+        for (uint_t i=0; i<n; i++) v[i] = y(i);
+        VecMAXPY(x, n, v.data(), _W.data());
+        
+        _n_guesses++;
+        
+        return true;
+    }
+    
+    
+    /*!
+     * adds the solution \p x to the subspace. The component of \p x orthogonal to the
+     * current subspace is normalized and appended to the basis, unless \p x already
+     * lies in the subspace. If the subspace is full then the oldest vector is removed.
+     */
+    inline void add(Vec x) {
+        
+        PetscReal
+        x_norm  = 0.,
+        w_norm  = 0.;
+        
+        VecNorm(x, NORM_2, &x_norm);
+        
+        if (x_norm == 0.) return;
+        
+        Vec
+        w;
+        VecDuplicate(x, &w);
+        VecCopy(x, w);
+        
+        std::vector<PetscScalar>
+        v(_W.size(), 0.);
+        
+        // classical Gram-Schmidt with one reorthogonalization pass
+        for (uint_t k=0; k<2 && _W.size(); k++) {
+            
+            VecMDot(w, _W.size(), _W.data(), v.data());
+            for (uint_t i=0; i<v.size(); i++) v[i] = -v[i];
+            VecMAXPY(w, _W.size(), v.data(), _W.data());
+        }
+        
+        VecNorm(w, NORM_2, &w_norm);
+
+        if (w_norm > tol * x_norm) {
+            
+            // removing a vector leaves the remaining basis orthonormal
+            if (_W.size() == _max_size) {
+                
+                VecDestroy(&_W.front());
+                _W.erase(_W.begin());
+            }
+            
+            VecScale(w, 1./w_norm);
+            _W.push_back(w);
+        }
+        else
+            VecDestroy(&w);
+    }
+    
+    
+private:
+    
+    const uint_t        _max_size;
+    uint_t              _n_guesses;
+    std::vector<Vec>    _W;
+};
+
+}
+}
+}
+
+#endif // __mast_petsc_recycled_subspace_h__
@@ -22,6 +22,8 @@
 
 // C++ includes
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 
 // MAST includes
 #include <mast/base/mast_data_types.h>
@@ -45,17 +47,44 @@ public:
     ConstrainedHermitianEigenSolver(MPI_Comm                     comm,
                                     const std::vector<PetscInt> &dofs,
                                     EPSProblemType               type):
+    warm_start    (true),
+    same_nonzero_pattern (false),
     _comm         (comm),
     _dofs         (dofs),
     _initialized  (false),
     _n            (0),
     _n_converged  (0),
     _type         (type),
+    _nev          (0),
+    _spectrum     (EPS_LARGEST_MAGNITUDE),
     _A_sub        (nullptr),
     _B_sub        (nullptr) { }
     
     virtual ~ConstrainedHermitianEigenSolver() {
         
+        this->clear();
+    }
+    
+    /*!
+     * If \p true, then repeated calls to \p solve use the eigenvectors converged in the
+     * previous solve as the initial space of the next solve.
+     */
+    bool warm_start;
+    
+    /*!
+     * If \p true, then the spectral transformation assumes that \p A and \p B have the
+     * same nonzero pattern, so that \f$ A - \sigma B \f$ is computed without a change in
+     * the nonzero structure. This must be set before the first \p solve, and should be
+     * used only if the pattern of \p B is the same as that of \p A.
+     */
+    bool same_nonzero_pattern;
+
+    /*!
+     * destroys the \p EPS object and the submatrices so that the next \p solve
+     * creates new objects. This is necessary if the unconstrained dofs change.
+     */
+    inline void clear() {
+        
         if (_initialized) {
             
             EPSDestroy(&_eps);
@@ -64,6 +93,23 @@ public:
             if (_B_sub)
                 MatDestroy(&_B_sub);
         }
+        
+        _initialized = false;
+        _n_converged = 0;
+        _A_sub       = nullptr;
+        _B_sub       = nullptr;
+    }
+
+    /// @returns the number of iterations of the last solve
+    inline uint_t n_iterations() {
+        
+        Assert0(_initialized, "solver not initialized");
+        
+        PetscInt
+        its = 0;
+        EPSGetIterationNumber(_eps, &its);
+        
+        return its;
     }
     
     /// @returns the number of converged eigen pairs
@@ -135,7 +181,12 @@ public:
     }
     
     /*!
-     *  method for eigenvalue problems  \f$ A x = \lambda B x \f$
+     *  method for eigenvalue problems  \f$ A x = \lambda B x \f$. The \p EPS object
+     *  and the submatrices are created at the first call and are reused for
+     *  subsequent calls, which only update the values of the submatrices. This retains
+     *  the spectral transformation along with its \p KSP. The options are read from
+     *  the command line when the \p EPS object is created, and again if \p nev or
+     *  \p spectrum change, so that the options take precedence over these arguments.
      */
     inline void solve(Mat               A_mat,
                       Mat              *B_mat,
@@ -143,8 +194,6 @@ public:
                       EPSWhich          spectrum,
                       bool              computeEigenvectors) {
         
-        Assert0(!_initialized, "solver already initialized");
-        
         PetscInt
         m = 0,
         n = 0;
@@ -166,11 +215,34 @@ public:
             Assert2(m==m2 && n==n2, m2, n2, "A and B must be same size");
         }
 
+        // the converged eigenvectors are obtained before the operators are updated,
+        // which resets the state of the EPS object
+        std::vector<Vec>
+        init_space;
+        
+        if (_initialized && warm_start) {
+            
+            init_space.resize(std::min<uint_t>(nev, _n_converged), nullptr);
+            
+            for (uint_t i=0; i<init_space.size(); i++) {
+                
+                MatCreateVecs(_A_sub, &init_space[i], PETSC_NULL);
+                EPSGetEigenvector(_eps, i, init_space[i], PETSC_NULL);
+            }
+        }
+        
+        bool
+        if_create = !_initialized;
+        
         // initialize the matrices
         _init_sub_matrices(A_mat, B_mat);
         
         // create the solver context
-        EPSCreate(_comm, &_eps);
+        if (if_create) {
+            
+            EPSCreate(_comm, &_eps);
+            _initialized = true;
+        }
         
         if (!B_mat) {
 
@@ -187,27 +259,55 @@ public:
             Assert0(_type == EPS_GHEP || _type == EPS_GNHEP, "Invalid EPS type");
         }
         
-        if (spectrum == EPS_LARGEST_MAGNITUDE)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_MAGNITUDE);
-        else if (spectrum == EPS_SMALLEST_MAGNITUDE)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_MAGNITUDE);
-        else if (spectrum == EPS_LARGEST_IMAGINARY)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_IMAGINARY);
-        else if (spectrum == EPS_SMALLEST_IMAGINARY)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_IMAGINARY);
-        else if (spectrum == EPS_LARGEST_REAL)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_REAL);
-        else if (spectrum == EPS_SMALLEST_REAL)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_REAL);
-        else
-            Assert0(false, "Invalid spectrum type");
-
-        EPSSetDimensions(_eps, nev, PETSC_DEFAULT, PETSC_DEFAULT);
-        EPSSetFromOptions(_eps);
+        // the spectrum and number of eigenpairs are defaults that are overridden by the
+        // command line options. These are set only when the EPS object is created or when
+        // the requested values change, and are always followed by the options.
+        if (if_create || nev != _nev || spectrum != _spectrum) {
+            
+            if (spectrum == EPS_LARGEST_MAGNITUDE)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_MAGNITUDE);
+            else if (spectrum == EPS_SMALLEST_MAGNITUDE)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_MAGNITUDE);
+            else if (spectrum == EPS_LARGEST_IMAGINARY)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_IMAGINARY);
+            else if (spectrum == EPS_SMALLEST_IMAGINARY)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_IMAGINARY);
+            else if (spectrum == EPS_LARGEST_REAL)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_REAL);
+            else if (spectrum == EPS_SMALLEST_REAL)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_REAL);
+            else
+                Assert0(false, "Invalid spectrum type");
+            
+            EPSSetDimensions(_eps, nev, PETSC_DEFAULT, PETSC_DEFAULT);
+            
+            if (if_create) {
+                
+                ST st;
+                EPSGetST(_eps, &st);
+                
+                if (same_nonzero_pattern)
+                    STSetMatStructure(st, SAME_NONZERO_PATTERN);
+            }
+            
+            EPSSetFromOptions(_eps);
+            
+            _nev      = nev;
+            _spectrum = spectrum;
+        }
+        
+        // the initial space is used only for the next solve, and the
+        // vectors can be destroyed once they have been provided
+        if (init_space.size()) {
+            
+            EPSSetInitialSpace(_eps, init_space.size(), init_space.data());
+            
+            for (uint_t i=0; i<init_space.size(); i++)
+                VecDestroy(&init_space[i]);
+        }
+        
         EPSSolve(_eps);
         EPSGetConverged(_eps, &_n_converged);
-        
-        _initialized = true;
     }
     
 
@@ -276,24 +376,35 @@ public:
 
 protected:
 
+    /*!
+     * extracts the submatrices of the unconstrained dofs. The submatrices are created
+     * at the first call, and subsequent calls only update their values.
+     */
     inline void _init_sub_matrices(Mat               A_mat,
                                    Mat              *B_mat) {
         
-        Assert0(!_initialized, "solver already initialized");
-
-        ISCreateGeneral(_comm, _dofs.size(), _dofs.data(), PETSC_USE_POINTER, &_dof_indices);
+        MatReuse
+        reuse = _initialized? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX;
+        
+        if (!_initialized)
+            ISCreateGeneral(_comm, _dofs.size(), _dofs.data(), PETSC_USE_POINTER, &_dof_indices);
+        
         MatCreateSubMatrix(A_mat, _dof_indices, _dof_indices,
 #if (PETSC_VERSION_MAJOR == 3) && (PETSC_VERSION_MINOR > 7)
-                           MAT_INITIAL_MATRIX,
+                           reuse,
 #endif
                            &_A_sub);
         
-        if (B_mat)
+        if (B_mat) {
+            
+            Assert0(!_initialized || _B_sub, "B matrix not provided in previous solve");
+            
             MatCreateSubMatrix(*B_mat, _dof_indices, _dof_indices,
 #if (PETSC_VERSION_MAJOR == 3) && (PETSC_VERSION_MINOR > 7)
-                               MAT_INITIAL_MATRIX,
+                               reuse,
 #endif
                                &_B_sub);
+        }
     }
     
     
@@ -302,6 +413,8 @@ protected:
     bool                          _initialized;
     int                           _n, _n_converged;
     EPSProblemType                _type;
+    uint_t                        _nev;
+    EPSWhich                      _spectrum;
     IS                            _dof_indices;
     Mat                           _A_sub;
     Mat                           _B_sub;
@@ -22,6 +22,8 @@
 
 // C++ includes
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 
 // MAST includes
 #include <mast/base/mast_data_types.h>
@@ -41,16 +43,59 @@ public:
     
     HermitianEigenSolver(MPI_Comm          comm,
                          EPSProblemType    type):
+    warm_start    (true),
+    same_nonzero_pattern (false),
     _comm         (comm),
     _initialized  (false),
     _n            (0),
     _n_converged  (0),
-    _type(type)   { }
+    _type         (type),
+    _nev          (0),
+    _spectrum     (EPS_LARGEST_MAGNITUDE) { }
     
     virtual ~HermitianEigenSolver() {
         
+        this->clear();
+    }
+    
+    /*!
+     * If \p true, then repeated calls to \p solve use the eigenvectors converged in the
+     * previous solve as the initial space of the next solve. This reduces the number
+     * of iterations if the operators change only slightly between solves, such as in
+     * the later design iterations of an optimization.
+     */
+    bool warm_start;
+    
+    /*!
+     * If \p true, then the spectral transformation assumes that \p A and \p B have the
+     * same nonzero pattern, so that \f$ A - \sigma B \f$ is computed without a change in
+     * the nonzero structure. This must be set before the first \p solve, and should be
+     * used only if the pattern of \p B is the same as that of \p A.
+     */
+    bool same_nonzero_pattern;
+    
+    /*!
+     * destroys the \p EPS object so that the next \p solve creates a new object
+     */
+    inline void clear() {
+        
         if (_initialized)
             EPSDestroy(&_eps);
+        
+        _initialized = false;
+        _n_converged = 0;
+    }
+    
+    /// @returns the number of iterations of the last solve
+    inline uint_t n_iterations() {
+        
+        Assert0(_initialized, "solver not initialized");
+        
+        PetscInt
+        its = 0;
+        EPSGetIterationNumber(_eps, &its);
+        
+        return its;
     }
     
     /// @returns the number of converged eigen pairs
@@ -109,7 +154,14 @@ public:
     }
     
     /*!
-     *  method for eigenvalue problems  \f$ A x = \lambda B x \f$
+     *  method for eigenvalue problems  \f$ A x = \lambda B x \f$. The \p EPS object
+     *  is created at the first call and is reused for subsequent calls, which only
+     *  update the operators. This retains the spectral transformation along with its
+     *  \p KSP, so that a factorization for shift-and-invert is recomputed only
+     *  numerically if the matrices have the same nonzero pattern. The options are
+     *  read from the command line when the \p EPS object is created, and again if
+     *  \p nev or \p spectrum change, so that the options take precedence over these
+     *  arguments.
      */
     inline void solve(Mat               A_mat,
                       Mat              *B_mat,
@@ -117,8 +169,6 @@ public:
                       EPSWhich          spectrum,
                       bool              computeEigenvectors) {
         
-        Assert0(!_initialized, "solver already initialized");
-
         PetscInt
         m = 0,
         n = 0;
@@ -140,7 +190,22 @@ public:
             Assert2(m==m2 && n==n2, m2, n2, "A and B must be same size");
         }
         
-        EPSCreate(_comm, &_eps);
+        // the converged eigenvectors are obtained before the operators are updated,
+        // which resets the state of the EPS object
+        std::vector<Vec>
+        init_space;
+        
+        if (_initialized && warm_start)
+            _get_eigenvectors(A_mat, std::min<uint_t>(nev, _n_converged), init_space);
+        
+        bool
+        if_create = !_initialized;
+        
+        if (if_create) {
+            
+            EPSCreate(_comm, &_eps);
+            _initialized = true;
+        }
         
         if (!B_mat) {
 
@@ -157,27 +222,55 @@ public:
             Assert0(_type == EPS_GHEP || _type == EPS_GNHEP, "Invalid EPS type");
         }
         
-        if (spectrum == EPS_LARGEST_MAGNITUDE)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_MAGNITUDE);
-        else if (spectrum == EPS_SMALLEST_MAGNITUDE)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_MAGNITUDE);
-        else if (spectrum == EPS_LARGEST_IMAGINARY)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_IMAGINARY);
-        else if (spectrum == EPS_SMALLEST_IMAGINARY)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_IMAGINARY);
-        else if (spectrum == EPS_LARGEST_REAL)
-            EPSSetWhichEigenpairs(_eps, EPS_LARGEST_REAL);
-        else if (spectrum == EPS_SMALLEST_REAL)
-            EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_REAL);
-        else
-            Assert0(false, "Invalid spectrum type");
-
-        EPSSetDimensions(_eps, nev, PETSC_DEFAULT, PETSC_DEFAULT);
-        EPSSetFromOptions(_eps);
+        // the spectrum and number of eigenpairs are defaults that are overridden by the
+        // command line options. These are set only when the EPS object is created or when
+        // the requested values change, and are always followed by the options.
+        if (if_create || nev != _nev || spectrum != _spectrum) {
+            
+            if (spectrum == EPS_LARGEST_MAGNITUDE)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_MAGNITUDE);
+            else if (spectrum == EPS_SMALLEST_MAGNITUDE)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_MAGNITUDE);
+            else if (spectrum == EPS_LARGEST_IMAGINARY)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_IMAGINARY);
+            else if (spectrum == EPS_SMALLEST_IMAGINARY)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_IMAGINARY);
+            else if (spectrum == EPS_LARGEST_REAL)
+                EPSSetWhichEigenpairs(_eps, EPS_LARGEST_REAL);
+            else if (spectrum == EPS_SMALLEST_REAL)
+                EPSSetWhichEigenpairs(_eps, EPS_SMALLEST_REAL);
+            else
+                Assert0(false, "Invalid spectrum type");
+            
+            EPSSetDimensions(_eps, nev, PETSC_DEFAULT, PETSC_DEFAULT);
+            
+            if (if_create) {
+                
+                ST st;
+                EPSGetST(_eps, &st);
+                
+                if (same_nonzero_pattern)
+                    STSetMatStructure(st, SAME_NONZERO_PATTERN);
+            }
+            
+            EPSSetFromOptions(_eps);
+            
+            _nev      = nev;
+            _spectrum = spectrum;
+        }
+        
+        // the initial space is used only for the next solve, and the
+        // vectors can be destroyed once they have been provided
+        if (init_space.size()) {
+            
+            EPSSetInitialSpace(_eps, init_space.size(), init_space.data());
+            
+            for (uint_t i=0; i<init_space.size(); i++)
+                VecDestroy(&init_space[i]);
+        }
+        
         EPSSolve(_eps);
         EPSGetConverged(_eps, &_n_converged);
-        
-        _initialized = true;
     }
     
 
@@ -244,10 +337,30 @@ public:
 
 protected:
     
+    /*!
+     * creates \p n vectors compatible with \p A and copies the first \p n converged
+     * eigenvectors to them
+     */
+    inline void _get_eigenvectors(Mat               A,
+                                  uint_t            n,
+                                  std::vector<Vec> &vecs) {
+        
+        vecs.resize(n, nullptr);
+        
+        for (uint_t i=0; i<n; i++) {
+            
+            MatCreateVecs(A, &vecs[i], PETSC_NULL);
+            EPSGetEigenvector(_eps, i, vecs[i], PETSC_NULL);
+        }
+    }
+    
+    
     MPI_Comm          _comm;
     bool              _initialized;
     int               _n, _n_converged;
     EPSProblemType    _type;
+    uint_t            _nev;
+    EPSWhich          _spectrum;
     EPS               _eps;
 };
 
@@ -0,0 +1,232 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/base/assembly/libmesh/utility.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/libmesh.h>
+#include <libmesh/replicated_mesh.h>
+#include <libmesh/mesh_generation.h>
+#include <libmesh/mesh_refinement.h>
+#include <libmesh/equation_systems.h>
+#include <libmesh/explicit_system.h>
+#include <libmesh/elem.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Assembly {
+namespace ConstrainAndAdd {
+
+using dual_t          = MAST::Dual<2>;
+using dual_vector_t   = Eigen::Matrix<dual_t, Eigen::Dynamic, 1>;
+using dual_matrix_t   = Eigen::Matrix<dual_t, Eigen::Dynamic, Eigen::Dynamic>;
+using real_vector_t   = Eigen::Matrix<real_t, Eigen::Dynamic, 1>;
+using real_matrix_t   = Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+
+/*!
+ * @returns component \p k of \p v, where \p k = 0 is the value and \p k > 0
+ * is the derivative \p k-1.
+ */
+inline real_t component(const dual_t &v, uint_t k) {
+
+    return (k == 0)? v.value() : v.derivative(k-1);
+}
+
+
+/*!
+ * Assembles Dual element vectors and matrices on a mesh with hanging nodes, and
+ * compares the value and each derivative with the assembly of the real-valued
+ * components. The element dofs on the coarse element next to the refined element
+ * are constrained, so that the constrained dof indices are expanded by libMesh.
+ */
+inline void test_constrained_dual_assembly() {
+
+    libMesh::ReplicatedMesh
+    mesh(p_global_init->comm());
+    
+    libMesh::MeshTools::Generation::build_square(mesh, 2, 1, 0., 2., 0., 1., libMesh::QUAD4);
+    
+    // refine the first element to create hanging nodes on the side shared with the second
+    libMesh::MeshRefinement
+    refinement(mesh);
+    
+    mesh.elem_ref(0).set_refinement_flag(libMesh::Elem::REFINE);
+    refinement.refine_elements();
+    
+    libMesh::EquationSystems
+    eq_sys(mesh);
+    
+    libMesh::ExplicitSystem
+    &sys = eq_sys.add_system<libMesh::ExplicitSystem>("u");
+    sys.add_variable("u", libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE));
+    eq_sys.init();
+    
+    const libMesh::DofMap
+    &dof_map = sys.get_dof_map();
+    
+    const uint_t
+    n_dofs = sys.n_dofs(),
+    n_d    = dual_t::n_derivatives();
+    
+    REQUIRE(dof_map.n_constrained_dofs() > 0);
+    
+    dual_vector_t
+    v_dual      = dual_vector_t::Zero(n_dofs),
+    v_dual_only = dual_vector_t::Zero(n_dofs);
+    dual_matrix_t
+    m_dual      = dual_matrix_t::Zero(n_dofs, n_dofs),
+    m_dual_only = dual_matrix_t::Zero(n_dofs, n_dofs);
+    
+    std::vector<real_vector_t>
+    v_ref(n_d+1, real_vector_t::Zero(n_dofs));
+    std::vector<real_matrix_t>
+    m_ref(n_d+1, real_matrix_t::Zero(n_dofs, n_dofs));
+    
+    std::vector<libMesh::dof_id_type>
+    dof_indices,
+    dof_indices0;
+    
+    uint_t
+    n_expanded = 0;
+    
+    libMesh::MeshBase::const_element_iterator
+    it   = mesh.active_local_elements_begin(),
+    end  = mesh.active_local_elements_end();
+    
+    for ( ; it != end; it++) {
+    
+        const libMesh::Elem
+        &e = **it;
+        
+        dof_map.dof_indices(&e, dof_indices0);
+        
+        const uint_t
+        n = dof_indices0.size();
+        
+        dual_vector_t
+        v_e(n);
+        dual_matrix_t
+        m_e(n, n);
+        
+        for (uint_t i=0; i<n; i++) {
+        
+            v_e(i) = 1. + i + e.id();
+            for (uint_t k=0; k<n_d; k++) v_e(i).derivative(k) = 0.5 * (k+1) - 0.25 * i;
+            
+            for (uint_t j=0; j<n; j++) {
+            
+                m_e(i, j) = 2. + i * j + e.id();
+                for (uint_t k=0; k<n_d; k++) m_e(i, j).derivative(k) = (k+1.) * (i + 1.) - 0.1 * j;
+            }
+        }
+        
+        // the element vector and matrix together
+        {
+            dual_vector_t v_sub = v_e;
+            dual_matrix_t m_sub = m_e;
+            dof_indices = dof_indices0;
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix_and_vector<dual_t>
+            (v_dual, m_dual, dof_map, dof_indices, v_sub, m_sub);
+            
+            if (dof_indices.size() > n) n_expanded++;
+        }
+        
+        // the element vector and matrix separately
+        {
+            dual_vector_t v_sub = v_e;
+            dual_matrix_t m_sub = m_e;
+            dof_indices = dof_indices0;
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_vector<dual_t>
+            (v_dual_only, dof_map, dof_indices, v_sub);
+            dof_indices = dof_indices0;
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix<dual_t>
+            (m_dual_only, dof_map, dof_indices, m_sub);
+        }
+        
+        // reference assembly for the value and each derivative
+        for (uint_t k=0; k<=n_d; k++) {
+        
+            real_vector_t v_sub(n);
+            real_matrix_t m_sub(n, n);
+            
+            for (uint_t i=0; i<n; i++) {
+            
+                v_sub(i) = component(v_e(i), k);
+                for (uint_t j=0; j<n; j++)
+                    m_sub(i, j) = component(m_e(i, j), k);
+            }
+            
+            dof_indices = dof_indices0;
+            MAST::Base::Assembly::libMeshWrapper::constrain_and_add_matrix_and_vector<real_t>
+            (v_ref[k], m_ref[k], dof_map, dof_indices, v_sub, m_sub);
+        }
+    }
+    
+    // the test requires at least one element with expanded dof indices
+    REQUIRE(n_expanded > 0);
+    
+    for (uint_t k=0; k<=n_d; k++) {
+    
+        std::vector<real_t>
+        v1(n_dofs),
+        v2(n_dofs),
+        m1(n_dofs*n_dofs),
+        m2(n_dofs*n_dofs);
+        
+        for (uint_t i=0; i<n_dofs; i++) {
+        
+            v1[i] = component(v_dual(i), k);
+            v2[i] = component(v_dual_only(i), k);
+            
+            for (uint_t j=0; j<n_dofs; j++) {
+            
+                m1[j*n_dofs+i] = component(m_dual(i, j), k);
+                m2[j*n_dofs+i] = component(m_dual_only(i, j), k);
+            }
+        }
+        
+        CHECK_THAT(v1, Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(v_ref[k])));
+        CHECK_THAT(v2, Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(v_ref[k])));
+        CHECK_THAT(m1, Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(m_ref[k])));
+        CHECK_THAT(m2, Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(m_ref[k])));
+    }
+}
+
+
+
+TEST_CASE("constrain_and_add_dual",
+          "[Assembly][Dual]") {
+    
+    test_constrained_dual_assembly();
+}
+
+} // namespace ConstrainAndAdd
+} // namespace Assembly
+} // namespace Test
+} // namespace MAST
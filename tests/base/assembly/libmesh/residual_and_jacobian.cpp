@@ -0,0 +1,225 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/fe/libmesh/fe.hpp>
+#include <mast/fe/eval/fe_basis_derivatives.hpp>
+#include <mast/fe/fe_var_data.hpp>
+#include <mast/physics/elasticity/isotropic_stiffness.hpp>
+#include <mast/base/scalar_constant.hpp>
+#include <mast/physics/elasticity/linear_strain_energy.hpp>
+#include <mast/base/assembly/libmesh/residual_and_jacobian.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/libmesh.h>
+#include <libmesh/replicated_mesh.h>
+#include <libmesh/mesh_generation.h>
+#include <libmesh/equation_systems.h>
+#include <libmesh/nonlinear_implicit_system.h>
+#include <libmesh/elem.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Assembly {
+namespace ResidualAndJacobian {
+
+struct Context {
+    Context(): elem(nullptr), qp(-1), s(-1), sys(nullptr), mesh(nullptr) {}
+    uint_t elem_dim() const {return elem->dim();}
+    uint_t  n_nodes() const {return elem->n_nodes();}
+    real_t  nodal_coord(uint_t nd, uint_t c) const {return elem->point(nd)(c);}
+    const libMesh::Elem* elem;
+    uint_t qp;
+    uint_t s;
+    libMesh::NonlinearImplicitSystem* sys;
+    libMesh::MeshBase*                mesh;
+};
+
+
+template <typename ScalarType>
+struct Traits {
+
+    using scalar_t          = ScalarType;
+    using fe_basis_t        = typename MAST::FEBasis::libMeshWrapper::FEBasis<ScalarType, 2>;
+    using quadrature_t      = typename fe_basis_t::quadrature_t;
+    using fe_shape_t        = typename MAST::FEBasis::Evaluation::FEShapeDerivative<ScalarType, ScalarType, 2, 2, fe_basis_t>;
+    using fe_var_t          = typename MAST::FEBasis::FEVarData<ScalarType, ScalarType, ScalarType, 2, 2, Context, fe_shape_t>;
+    using modulus_t         = typename MAST::Base::ScalarConstant<ScalarType>;
+    using nu_t              = typename MAST::Base::ScalarConstant<ScalarType>;
+    using prop_t            = typename MAST::Physics::Elasticity::IsotropicMaterialStiffness<ScalarType, 2, modulus_t, nu_t, Context>;
+    using energy_t          = typename MAST::Physics::Elasticity::LinearContinuum::StrainEnergy<fe_var_t, prop_t, 2, Context>;
+};
+
+
+/*!
+ * element operations for the linear strain energy, with all element quantities
+ * computed in \p Traits::scalar_t.
+ */
+template <typename Traits>
+class ElemOps {
+  
+public:
+    
+    using scalar_t = typename Traits::scalar_t;
+    using vector_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    using matrix_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
+    
+    ElemOps():
+    _q        (new typename Traits::quadrature_t(libMesh::QGAUSS, libMesh::SECOND)),
+    _fe       (new typename Traits::fe_basis_t(libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE))),
+    _fe_deriv (new typename Traits::fe_shape_t),
+    _fe_var   (new typename Traits::fe_var_t),
+    _E        (new typename Traits::modulus_t(72.e9)),
+    _nu       (new typename Traits::nu_t(0.33)),
+    _prop     (new typename Traits::prop_t),
+    _energy   (new typename Traits::energy_t) {
+        
+        _fe->set_compute_dphi_dxi(true);
+        
+        _fe_deriv->set_compute_dphi_dx(true);
+        _fe_deriv->set_compute_detJ(true);
+        _fe_deriv->set_compute_detJxW(true);
+        _fe_deriv->set_compute_Jac_inverse(true);
+        _fe_deriv->set_fe_basis(*_fe);
+        
+        _fe_var->set_compute_du_dx(true);
+        _fe_var->set_fe_shape_data(*_fe_deriv);
+        
+        _prop->set_modulus_and_nu(*_E, *_nu);
+        
+        _energy->set_section_property(*_prop);
+        _energy->set_fe_var_data(*_fe_var);
+    }
+    
+    virtual ~ElemOps() {}
+    
+    template <typename AccessorType>
+    inline void compute(Context            &c,
+                        const AccessorType &v,
+                        vector_t           &res,
+                        matrix_t           *jac) {
+        
+        _fe->reinit(*c.elem, *_q);
+        _fe_deriv->reinit(c);
+        _fe_var->init(c, v);
+        _energy->compute(c, res, jac);
+    }
+    
+private:
+    
+    std::unique_ptr<typename Traits::quadrature_t>   _q;
+    std::unique_ptr<typename Traits::fe_basis_t>     _fe;
+    std::unique_ptr<typename Traits::fe_shape_t>     _fe_deriv;
+    std::unique_ptr<typename Traits::fe_var_t>       _fe_var;
+    std::unique_ptr<typename Traits::modulus_t>      _E;
+    std::unique_ptr<typename Traits::nu_t>           _nu;
+    std::unique_ptr<typename Traits::prop_t>         _prop;
+    std::unique_ptr<typename Traits::energy_t>       _energy;
+};
+
+
+using real_vector_t = Eigen::Matrix<real_t, Eigen::Dynamic, 1>;
+using real_matrix_t = Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+
+/*!
+ * assembles the residual and Jacobian in double precision with element operations
+ * computed in \p ElemScalarType.
+ */
+template <typename ElemScalarType>
+inline void assemble(Context             &c,
+                     const real_vector_t &sol,
+                     real_vector_t       &res,
+                     real_matrix_t       &jac) {
+    
+    ElemOps<Traits<ElemScalarType>>
+    e_ops;
+    
+    MAST::Base::Assembly::libMeshWrapper::ResidualAndJacobian<real_t, ElemOps<Traits<ElemScalarType>>>
+    assembly;
+    assembly.set_elem_ops(e_ops);
+    
+    res = real_vector_t::Zero(c.sys->n_dofs());
+    jac = real_matrix_t::Zero(c.sys->n_dofs(), c.sys->n_dofs());
+    
+    assembly.assemble(c, sol, &res, &jac);
+}
+
+
+
+TEST_CASE("residual_and_jacobian_mixed_precision",
+          "[Assembly][SinglePrecision]") {
+    
+    libMesh::ReplicatedMesh
+    mesh(p_global_init->comm());
+    
+    libMesh::MeshTools::Generation::build_square(mesh, 4, 4, 0., 1., 0., 1., libMesh::QUAD4);
+    
+    libMesh::EquationSystems
+    eq_sys(mesh);
+    
+    libMesh::NonlinearImplicitSystem
+    &sys = eq_sys.add_system<libMesh::NonlinearImplicitSystem>("structural");
+    sys.add_variable("u_x", libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE));
+    sys.add_variable("u_y", libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE));
+    eq_sys.init();
+    
+    Context
+    c;
+    c.sys  = &sys;
+    c.mesh = &mesh;
+    
+    real_vector_t
+    sol = 1.e-3 * real_vector_t::Random(sys.n_dofs()),
+    res_d,
+    res_f;
+    
+    real_matrix_t
+    jac_d,
+    jac_f;
+    
+    assemble<real_t>(c, sol, res_d, jac_d);
+    assemble<float>(c, sol, res_f, jac_f);
+    
+    // the element quantities computed in single precision are accumulated in the
+    // double precision vector and matrix, and should match the all-double assembly to
+    // the single precision tolerance relative to the largest entry.
+    const real_t
+    tol = 1.e-5;
+    
+    CHECK((res_f - res_d).cwiseAbs().maxCoeff() <= tol * res_d.cwiseAbs().maxCoeff());
+    CHECK((jac_f - jac_d).cwiseAbs().maxCoeff() <= tol * jac_d.cwiseAbs().maxCoeff());
+    
+    // the assembled quantities should be symmetric, which is independent of the
+    // precision of the element quantities
+    CHECK((jac_f - jac_f.transpose()).cwiseAbs().maxCoeff() <= tol * jac_d.cwiseAbs().maxCoeff());
+}
+
+} // namespace ResidualAndJacobian
+} // namespace Assembly
+} // namespace Test
+} // namespace MAST
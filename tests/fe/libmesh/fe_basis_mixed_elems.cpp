@@ -0,0 +1,170 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/fe/libmesh/fe.hpp>
+#include <mast/quadrature/libmesh/quadrature.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/elem.h>
+#include <libmesh/node.h>
+#include <libmesh/quadrature.h>
+
+
+namespace MAST {
+namespace Test {
+namespace FEBasis {
+namespace MixedElems {
+
+using quadrature_t   = MAST::Quadrature::libMeshWrapper::Quadrature<real_t, 2>;
+using fe_t           = MAST::FEBasis::libMeshWrapper::FEBasis<real_t, 2>;
+
+
+inline std::unique_ptr<libMesh::Elem>
+build_elem(const libMesh::ElemType         t,
+           const std::vector<real_t>      &x,
+           const std::vector<real_t>      &y,
+           std::vector<libMesh::Node*>    &nodes) {
+    
+    std::unique_ptr<libMesh::Elem>
+    e(libMesh::Elem::build(t).release());
+    
+    for (uint_t i=0; i<e->n_nodes(); i++) {
+        nodes.push_back(libMesh::Node::build(libMesh::Point(x[i], y[i]), nodes.size()).release());
+        e->set_node(i) = nodes.back();
+    }
+    
+    return e;
+}
+
+
+/*!
+ * compares the quadrature and basis of \p fe, which may use cached reference values,
+ * with a basis initialized from scratch for element \p e.
+ */
+inline void check_basis(const libMesh::Elem &e,
+                        const fe_t          &fe,
+                        const real_t         ref_area) {
+    
+    // reference quadrature rule initialized for this element
+    std::unique_ptr<libMesh::QBase>
+    q_ref(libMesh::QBase::build(libMesh::QGAUSS, 2, libMesh::FOURTH).release());
+    q_ref->init(e.type(), e.p_level());
+    
+    quadrature_t
+    q_fresh(*q_ref);
+    
+    fe_t
+    fe_fresh(libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE));
+    fe_fresh.set_compute_dphi_dxi(true);
+    fe_fresh.reinit(e, q_fresh);
+    
+    REQUIRE(fe.n_q_points() == q_ref->n_points());
+    REQUIRE(fe.n_basis()    == e.n_nodes());
+    
+    std::vector<real_t>
+    w(fe.n_q_points()),
+    w_ref(fe.n_q_points());
+    
+    real_t
+    area = 0.;
+    
+    for (uint_t i=0; i<fe.n_q_points(); i++) {
+        
+        w[i]     = fe.qp_weight(i);
+        w_ref[i] = q_ref->w(i);
+        area    += w[i];
+        
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(fe.phi(i)),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(fe_fresh.phi(i))));
+        
+        for (uint_t j=0; j<2; j++)
+            CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(fe.dphi_dxi(i, j)),
+                       Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(fe_fresh.dphi_dxi(i, j))));
+    }
+    
+    CHECK_THAT(w, Catch::Approx(w_ref));
+    CHECK(area == Catch::Detail::Approx(ref_area));
+}
+
+
+
+TEST_CASE("fe_basis_mixed_elem_types",
+          "[2D],[QUAD4],[TRI3],[FEBasis]") {
+    
+    std::vector<libMesh::Node*>
+    nodes;
+    
+    std::unique_ptr<libMesh::Elem>
+    quad_1 = build_elem(libMesh::QUAD4, {0., 1., 1., 0.},  {0., 0., 1., 1.}, nodes),
+    quad_2 = build_elem(libMesh::QUAD4, {1., 2.1, 2., 1.}, {0., 0., 1.2, 1.}, nodes),
+    tri_1  = build_elem(libMesh::TRI3,  {0., 1., 0.},      {1., 1., 2.}, nodes),
+    tri_2  = build_elem(libMesh::TRI3,  {1., 2., 1.1},     {1., 1.2, 2.}, nodes);
+    
+    // area of the reference elements, which is the sum of quadrature weights
+    const real_t
+    quad_area = 4.,
+    tri_area  = 0.5;
+
+    // same quadrature rule is used for all elements, as is done in the assembly
+    quadrature_t
+    q(libMesh::QGAUSS, libMesh::FOURTH);
+    
+    fe_t
+    fe(libMesh::FEType(libMesh::FIRST, libMesh::LAGRANGE));
+    fe.set_compute_dphi_dxi(true);
+    
+    REQUIRE(fe.if_reference_values_cached());
+
+    // first element of each type computes the values
+    fe.reinit(*quad_1, q);
+    check_basis(*quad_1, fe, quad_area);
+    
+    fe.reinit(*tri_1, q);
+    check_basis(*tri_1, fe, tri_area);
+    
+    // subsequent elements use the cached values after switching the element type,
+    // and the quadrature rule must be reinitialized for the element type
+    fe.reinit(*quad_2, q);
+    check_basis(*quad_2, fe, quad_area);
+    
+    fe.reinit(*tri_2, q);
+    check_basis(*tri_2, fe, tri_area);
+
+    // element of same type as the current element
+    fe.reinit(*tri_1, q);
+    check_basis(*tri_1, fe, tri_area);
+
+    fe.reinit(*quad_1, q);
+    check_basis(*quad_1, fe, quad_area);
+
+    for (uint_t i=0; i<nodes.size(); i++)
+        delete nodes[i];
+}
+
+} // namespace MixedElems
+} // namespace FEBasis
+} // namespace Test
+} // namespace MAST
@@ -0,0 +1,319 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// C++ includes
+#include <algorithm>
+
+// MAST includes
+#include <mast/optimization/aggregation/discrete_aggregation.hpp>
+#include <mast/optimization/aggregation/discrete_aggregator.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/libmesh.h>
+#include <libmesh/parallel.h>
+
+extern libMesh::LibMeshInit *p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Aggregator {
+
+
+template <typename Type>
+void check_gradient(Type                       type,
+                    const real_t               p,
+                    const std::vector<real_t> &vec,
+                    const std::vector<real_t> &dvec) {
+
+    uint_t
+    n  = vec.size();
+
+    MAST::Optimization::Aggregation::DiscreteAggregator<real_t>
+    agg(nullptr, type, p);
+
+    std::vector<real_t>
+    grad;
+
+    agg.compute(vec);
+    agg.gradient(vec, grad);
+
+    REQUIRE(grad.size() == n);
+
+    // compare the gradient with complex-step sensitivity
+    MAST::Optimization::Aggregation::DiscreteAggregator<complex_t>
+    agg_cs(nullptr,
+           static_cast<typename MAST::Optimization::Aggregation::DiscreteAggregator<complex_t>::Type>(type),
+           p);
+
+    std::vector<complex_t>
+    vec_cs(vec.begin(), vec.end());
+
+    real_t
+    dval = 0.;
+
+    for (uint_t i=0; i<n; i++) {
+
+        vec_cs[i] += complex_t(0., ComplexStepDelta);
+        agg_cs.compute(vec_cs);
+        vec_cs[i] = vec[i];
+
+        CHECK(agg_cs.value().imag()/ComplexStepDelta == Catch::Detail::Approx(grad[i]));
+
+        dval += grad[i] * dvec[i];
+    }
+
+    CHECK(agg.sensitivity(vec, dvec) == Catch::Detail::Approx(dval));
+}
+
+
+void run_checks(const real_t p) {
+
+    using aggregator_t = MAST::Optimization::Aggregation::DiscreteAggregator<real_t>;
+
+    uint_t
+    n  = 10;
+
+    Eigen::Matrix<real_t, Eigen::Dynamic, 1>
+    vals  = Eigen::Matrix<real_t, Eigen::Dynamic, 1>::Random(n),
+    dvals = Eigen::Matrix<real_t, Eigen::Dynamic, 1>::Random(n);
+
+    std::vector<real_t>
+    vec  (vals.data(), vals.data()+n),
+    dvec (dvals.data(), dvals.data()+n),
+    pos  (n);
+
+    for (uint_t i=0; i<n; i++) pos[i] = 1.5 + vec[i];
+
+    aggregator_t
+    agg_max (nullptr, aggregator_t::MAXIMUM, p),
+    agg_min (nullptr, aggregator_t::MINIMUM, p),
+    agg_pn  (nullptr, aggregator_t::P_NORM,  p);
+
+    //////////////////////////////////////////////////////////
+    // values should match the discrete aggregation functions
+    //////////////////////////////////////////////////////////
+    agg_max.compute(vec);
+    agg_min.compute(vec);
+    agg_pn.compute(pos);
+
+    CHECK(agg_max.value() ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_maximum(nullptr, vec, p)));
+    CHECK(agg_min.value() ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_minimum(nullptr, vec, p)));
+    CHECK(agg_max.sensitivity(vec, dvec) ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_maximum_sensitivity(nullptr, vec, dvec, p)));
+    CHECK(agg_min.sensitivity(vec, dvec) ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_minimum_sensitivity(nullptr, vec, dvec, p)));
+
+    real_t
+    v_pn = 0.;
+    for (uint_t i=0; i<n; i++) v_pn += pow(pos[i], p);
+    v_pn = pow(v_pn, 1./p);
+
+    CHECK(agg_pn.value() == Catch::Detail::Approx(v_pn));
+
+    //////////////////////////////////////////////////////////
+    // gradient with respect to all values
+    //////////////////////////////////////////////////////////
+    check_gradient(aggregator_t::MAXIMUM, p, vec, dvec);
+    check_gradient(aggregator_t::MINIMUM, p, vec, dvec);
+    check_gradient(aggregator_t::P_NORM,  p, pos, dvec);
+
+    //////////////////////////////////////////////////////////
+    // batched regions should match independent aggregation
+    //////////////////////////////////////////////////////////
+    std::vector<uint_t>
+    region(n);
+
+    std::vector<real_t>
+    vec0,
+    vec1,
+    grad,
+    dv;
+
+    for (uint_t i=0; i<n; i++) {
+
+        region[i] = i%2;
+        if (region[i] == 0) vec0.push_back(vec[i]);
+        else                vec1.push_back(vec[i]);
+    }
+
+    agg_max.set_regions(2, region);
+    agg_max.compute(vec);
+    agg_max.gradient(vec, grad);
+    agg_max.sensitivity(vec, dvec, dv);
+
+    REQUIRE(dv.size() == 2);
+
+    CHECK(agg_max.value(0) ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_maximum(nullptr, vec0, p)));
+    CHECK(agg_max.value(1) ==
+          Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_maximum(nullptr, vec1, p)));
+
+    for (uint_t i=0; i<n; i++) {
+
+        const std::vector<real_t>
+        &v = (region[i] == 0)? vec0 : vec1;
+
+        CHECK(grad[i] ==
+              Catch::Detail::Approx(MAST::Optimization::Aggregation::aggregate_maximum_sensitivity
+                                    (nullptr, v, i/2, p)));
+    }
+}
+
+
+TEST_CASE("discrete_aggregator",
+          "[Optimization][Aggregation]") {
+
+    run_checks(10);
+    run_checks(100);
+}
+
+
+
+/*!
+ * @returns the value at global index \p i in the parallel tests. The first two values
+ * are zero so that the p-norm of their region is zero.
+ */
+inline real_t parallel_test_value(uint_t i) {
+    
+    return (i < 2)? 0. : 0.2 + 0.5 * ((7 * i) % 11) / 11.;
+}
+
+
+/*!
+ * @returns the region of the value at global index \p i in the parallel tests. Region 2
+ * has values only on the first rank, and region 3 has no values.
+ */
+inline uint_t parallel_test_region(uint_t i) {
+    
+    return (i < 2)? 2 : i%2;
+}
+
+
+template <typename Type>
+void check_parallel(const libMesh::Parallel::Communicator &comm,
+                    Type                                   type,
+                    const real_t                           p) {
+    
+    using aggregator_t = MAST::Optimization::Aggregation::DiscreteAggregator<real_t>;
+    
+    const uint_t
+    n_local    = 6,
+    n_regions  = 4,
+    n          = n_local * comm.size(),
+    first      = n_local * comm.rank();
+    
+    std::vector<real_t>
+    vec_local(n_local),
+    dvec_local(n_local),
+    vec(n),
+    dvec(n),
+    grad_local,
+    grad,
+    dv_local,
+    dv;
+    
+    std::vector<uint_t>
+    region_local(n_local),
+    region(n);
+    
+    for (uint_t i=0; i<n; i++) {
+        
+        vec[i]    = parallel_test_value(i);
+        dvec[i]   = 0.1 * (i%5) - 0.2;
+        region[i] = parallel_test_region(i);
+    }
+    
+    for (uint_t i=0; i<n_local; i++) {
+        
+        vec_local[i]    = vec[first+i];
+        dvec_local[i]   = dvec[first+i];
+        region_local[i] = region[first+i];
+    }
+    
+    // aggregation of local values combined across ranks
+    aggregator_t
+    agg(&comm, type, p);
+    agg.set_regions(n_regions, region_local);
+    agg.compute(vec_local);
+    agg.gradient(vec_local, grad_local);
+    agg.sensitivity(vec_local, dvec_local, dv_local);
+
+    // reference aggregation of all values on each rank
+    aggregator_t
+    agg_ref(nullptr, type, p);
+    agg_ref.set_regions(n_regions, region);
+    agg_ref.compute(vec);
+    agg_ref.gradient(vec, grad);
+    agg_ref.sensitivity(vec, dvec, dv);
+    
+    REQUIRE(dv_local.size() == n_regions);
+    
+    for (uint_t r=0; r<n_regions; r++) {
+        
+        CHECK(agg.value(r) == Catch::Detail::Approx(agg_ref.value(r)));
+        CHECK(dv_local[r]  == Catch::Detail::Approx(dv[r]).margin(1.e-12));
+    }
+    
+    for (uint_t i=0; i<n_local; i++)
+        CHECK(grad_local[i] == Catch::Detail::Approx(grad[first+i]).margin(1.e-12));
+    
+    // the region without values has a zero aggregate
+    CHECK(agg.value(3) == 0.);
+    
+    // the p-norm of zero values is zero, with zero gradient
+    if (type == aggregator_t::P_NORM) {
+        
+        CHECK(agg.value(2) == 0.);
+        
+        for (uint_t i=0; i<n_local; i++)
+            if (region_local[i] == 2)
+                CHECK(grad_local[i] == 0.);
+    }
+}
+
+
+TEST_CASE("discrete_aggregator_parallel",
+          "[Optimization][Aggregation]") {
+    
+    using aggregator_t = MAST::Optimization::Aggregation::DiscreteAggregator<real_t>;
+    
+    const libMesh::Parallel::Communicator
+    &comm = p_global_init->comm();
+    
+    for (real_t p: {10., 100.}) {
+        
+        check_parallel(comm, aggregator_t::MAXIMUM, p);
+        check_parallel(comm, aggregator_t::MINIMUM, p);
+        check_parallel(comm, aggregator_t::P_NORM,  p);
+    }
+}
+
+} // namespace Aggregator
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
@@ -0,0 +1,366 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#ifndef MAST_TESTING
+#define MAST_TESTING 1
+#endif
+
+#include <structural/example_6/example_6.cpp>
+#include <mast/optimization/design_parameter_vector.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace DesignParameterVector {
+
+using traits_t = MAST::Examples::Structural::Example6::Traits<real_t, real_t, real_t, MAST::Mesh::Generation::Bracket2D>;
+using dvs_t    = MAST::Optimization::DesignParameterVector<real_t>;
+
+
+/*!
+ * checks that the lookups by parameter ID and by dof ID return the entries of the
+ * flat layout, that the parameters store their values in the flat layout, and that
+ * the flat layout has the local parameters first followed by the ghosted parameters
+ * in the order of their IDs.
+ */
+inline void check_flat_index(dvs_t &dvs) {
+    
+    std::vector<real_t>
+    &values  = dvs.flat_values();
+    const std::vector<uint_t>
+    &ids     = dvs.flat_ids(),
+    &dof_ids = dvs.flat_dof_ids();
+    
+    const uint_t
+    n_local  = dvs.local_end() - dvs.local_begin();
+    
+    REQUIRE(values.size()  == n_local + dvs.n_ghosted());
+    REQUIRE(ids.size()     == values.size());
+    REQUIRE(dof_ids.size() == values.size());
+    
+    for (uint_t k=0; k<values.size(); k++) {
+        
+        if (k < n_local)
+            CHECK(ids[k] == dvs.local_begin() + k);
+        else {
+            
+            CHECK((ids[k] < dvs.local_begin() || ids[k] >= dvs.local_end()));
+            if (k > n_local) CHECK(ids[k-1] < ids[k]);
+        }
+        
+        // lookup by parameter ID
+        CHECK(&dvs[ids[k]]() == &values[k]);
+        CHECK(dvs[ids[k]].id() == ids[k]);
+        CHECK(dvs.dof_id(ids[k]) == dof_ids[k]);
+        
+        // lookup by dof ID
+        CHECK(dvs.is_design_parameter_dof_id(dof_ids[k]));
+        CHECK(dvs.get_dv_id_for_topology_dof(dof_ids[k]) == ids[k]);
+    }
+    
+    // the dof ID field of the parameter data is available for the local parameters
+    std::vector<int_t>
+    dof_field;
+    
+    dvs.get_local_field("dof_id", dof_field);
+    
+    REQUIRE(dof_field.size() == n_local);
+    
+    for (uint_t k=0; k<n_local; k++)
+        CHECK(uint_t(dof_field[k]) == dof_ids[k]);
+}
+
+
+TEST_CASE("design_parameter_vector_flat_index",
+          "[Optimization]") {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    const libMesh::DofMap
+    &dof_map = ex_init.rho_sys->get_dof_map();
+    
+    const libMesh::Parallel::Communicator
+    &comm    = p_global_init->comm();
+
+    dvs_t dvs(comm);
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    check_flat_index(dvs);
+    
+    const std::vector<uint_t>
+    &ids     = dvs.flat_ids(),
+    &dof_ids = dvs.flat_dof_ids();
+    
+    const uint_t
+    n_local   = dvs.local_end() - dvs.local_begin(),
+    first_dof = dof_map.first_dof(comm.rank()),
+    end_dof   = dof_map.end_dof(comm.rank());
+    
+    // dofs of local parameters are owned by this rank, and dofs of ghosted
+    // parameters are owned by other ranks
+    for (uint_t k=0; k<dof_ids.size(); k++) {
+        
+        const bool
+        is_local_dof = dof_ids[k] >= first_dof && dof_ids[k] < end_dof;
+        
+        CHECK(is_local_dof == (k < n_local));
+    }
+    
+    // the IDs of ghosted parameters must match the IDs assigned by the owning ranks
+    std::vector<uint_t>
+    local_dofs(dof_ids.begin(), dof_ids.begin() + n_local),
+    local_ids (ids.begin(),     ids.begin()     + n_local);
+    
+    comm.allgather(local_dofs, false);
+    comm.allgather(local_ids,  false);
+    
+    REQUIRE(local_dofs.size() == dvs.size());
+    
+    std::map<uint_t, uint_t>
+    dof_to_id;
+    
+    for (uint_t i=0; i<local_dofs.size(); i++)
+        dof_to_id[local_dofs[i]] = local_ids[i];
+    
+    for (uint_t k=n_local; k<dof_ids.size(); k++) {
+        
+        REQUIRE(dof_to_id.count(dof_ids[k]));
+        CHECK(ids[k] == dof_to_id[dof_ids[k]]);
+    }
+    
+    // dofs that are not associated with a design parameter
+    for (uint_t i=first_dof; i<end_dof; i++)
+        if (!std::count(dof_ids.begin(), dof_ids.end(), i))
+            CHECK_FALSE(dvs.is_design_parameter_dof_id(i));
+    
+    CHECK_FALSE(dvs.is_design_parameter_dof_id(dof_map.n_dofs()));
+}
+
+
+TEST_CASE("design_parameter_vector_nonlocal_dof",
+          "[Optimization]") {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    const libMesh::DofMap
+    &dof_map = ex_init.rho_sys->get_dof_map();
+    
+    const libMesh::Parallel::Communicator
+    &comm    = p_global_init->comm();
+    
+    const uint_t
+    n_params  = 3,
+    n_dofs    = dof_map.n_dofs(),
+    first_dof = dof_map.first_dof(comm.rank()),
+    end_dof   = dof_map.end_dof(comm.rank());
+    
+    REQUIRE(end_dof > first_dof);
+    
+    dvs_t dvs(comm);
+    
+    // the first parameter on each rank is associated with a dof owned by this rank,
+    // and the others with dof IDs that are not owned by any rank, which are stored
+    // in the sorted list of nonlocal dofs.
+    std::vector<uint_t>
+    dofs(n_params);
+    
+    dofs[0] = first_dof;
+    for (uint_t i=1; i<n_params; i++)
+        dofs[i] = n_dofs + n_params * (comm.size() - comm.rank()) - i;
+    
+    for (uint_t i=0; i<n_params; i++)
+        dvs.add_topology_parameter(*new MAST::Optimization::DesignParameter<real_t>(0.1*i),
+                                   dofs[i]);
+    
+    dvs.synchronize(dof_map);
+    
+    REQUIRE(dvs.size() == n_params * comm.size());
+    REQUIRE(dvs.n_ghosted() == 0);
+    
+    check_flat_index(dvs);
+    
+    for (uint_t i=0; i<n_params; i++) {
+        
+        CHECK(dvs.dof_id(dvs.local_begin()+i) == dofs[i]);
+        CHECK(dvs.get_dv_id_for_topology_dof(dofs[i]) == dvs.local_begin()+i);
+        CHECK(dvs[dvs.local_begin()+i]() == Catch::Detail::Approx(0.1*i));
+    }
+    
+    // nonlocal dofs of parameters on other ranks are not known on this rank
+    if (comm.size() > 1) {
+        
+        const uint_t
+        other = (comm.rank() + 1) % comm.size();
+        
+        CHECK_FALSE(dvs.is_design_parameter_dof_id(n_dofs + n_params * (comm.size() - other) - 1));
+    }
+}
+
+
+/*!
+ * @returns the value of the design parameter with ID \p i in update \p k
+ */
+inline real_t ghost_test_value(uint_t i, uint_t k) { return 0.5 + 0.01 * i + k;}
+
+
+TEST_CASE("design_parameter_vector_ghost_values",
+          "[Optimization]") {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    const libMesh::Parallel::Communicator
+    &comm    = p_global_init->comm();
+
+    dvs_t dvs(comm);
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    const std::vector<uint_t>
+    &ids     = dvs.flat_ids();
+    
+    const uint_t
+    n_local  = dvs.local_end() - dvs.local_begin();
+    
+    // parameters on the boundary between partitions are ghosted on the
+    // neighboring ranks
+    uint_t
+    n_ghosted = dvs.n_ghosted();
+    comm.sum(n_ghosted);
+    
+    if (comm.size() > 1)
+        CHECK(n_ghosted > 0);
+    
+    // repeated updates reuse the communication pattern and buffers
+    for (uint_t k=0; k<2; k++) {
+        
+        for (uint_t i=0; i<ids.size(); i++)
+            dvs[ids[i]]() = (i < n_local)? ghost_test_value(ids[i], k) : -1.;
+        
+        dvs.synchronize_ghost_values();
+        
+        for (uint_t i=0; i<ids.size(); i++)
+            CHECK(dvs[ids[i]]() == Catch::Detail::Approx(ghost_test_value(ids[i], k)));
+    }
+}
+
+
+
+TEST_CASE("design_parameter_vector_ghost_values_overlap",
+          "[Optimization]") {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    const libMesh::Parallel::Communicator
+    &comm    = p_global_init->comm();
+    
+    dvs_t dvs(comm);
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    const std::vector<uint_t>
+    &ids     = dvs.flat_ids();
+    
+    std::vector<real_t>
+    &values  = dvs.flat_values();
+    
+    const uint_t
+    n_local  = dvs.local_end() - dvs.local_begin();
+    
+    for (uint_t i=0; i<ids.size(); i++)
+        values[i] = (i < n_local)? ghost_test_value(ids[i], 0) : -1.;
+    
+    dvs.synchronize_ghost_values_begin();
+    
+    // local work between the two calls. The local values are copied to the send
+    // buffers by the first call, so changes to the local values are not sent.
+    real_t
+    local_sum = 0.;
+    
+    for (uint_t i=0; i<n_local; i++) {
+        
+        local_sum += values[i];
+        values[i]  = ghost_test_value(ids[i], 1);
+    }
+    
+    dvs.synchronize_ghost_values_end();
+    
+    real_t
+    ref_sum = 0.;
+    
+    for (uint_t i=0; i<n_local; i++) {
+        
+        ref_sum += ghost_test_value(ids[i], 0);
+        CHECK(values[i] == Catch::Detail::Approx(ghost_test_value(ids[i], 1)));
+    }
+    
+    CHECK(local_sum == Catch::Detail::Approx(ref_sum));
+    
+    for (uint_t i=n_local; i<ids.size(); i++)
+        CHECK(values[i] == Catch::Detail::Approx(ghost_test_value(ids[i], 0)));
+    
+    // a second update sends the modified local values
+    dvs.synchronize_ghost_values();
+    
+    for (uint_t i=n_local; i<ids.size(); i++)
+        CHECK(values[i] == Catch::Detail::Approx(ghost_test_value(ids[i], 1)));
+}
+
+} // namespace DesignParameterVector
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
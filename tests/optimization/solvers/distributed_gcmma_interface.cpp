@@ -0,0 +1,160 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/optimization/solvers/distributed_gcmma_interface.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/libmesh.h>
+
+extern libMesh::LibMeshInit *p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Solvers {
+namespace DistributedGCMMA {
+
+/*!
+ *  minimize \f$ \sum_j w_j x_j^2 \f$ subject to \f$ 1 - \frac{1}{N} \sum_j x_j \leq 0 \f$,
+ *  with \f$ w_j = 1 + (j \mod 3) \f$. Each rank owns \p n_local variables.
+ */
+struct WeightedQuadraticFunction {
+
+    WeightedQuadraticFunction(const libMesh::Parallel::Communicator& c):
+    comm    (c),
+    n_local (10),
+    obj     (0.) {}
+    
+    const libMesh::Parallel::Communicator &comm;
+    uint_t n_local;
+    real_t obj;
+    std::vector<real_t> x;
+    
+    inline uint_t n_local_vars() const {return n_local;}
+    inline uint_t       n_vars() const {return n_local * comm.size();}
+    inline uint_t         n_eq() const {return 0;}
+    inline uint_t       n_ineq() const {return 1;}
+    
+    inline real_t weight(uint_t i) const {return 1. + (comm.rank()*n_local + i)%3;}
+    
+    virtual void init_dvar(std::vector<real_t>& x,
+                           std::vector<real_t>& xmin,
+                           std::vector<real_t>& xmax) {
+        
+        std::fill(   x.begin(),    x.end(),  0.5);
+        std::fill(xmin.begin(), xmin.end(),  0.1);
+        std::fill(xmax.begin(), xmax.end(), 10.0);
+    }
+
+    virtual void evaluate(const std::vector<real_t>& x,
+                          real_t& obj,
+                          bool eval_obj_grad,
+                          std::vector<real_t>& obj_grad,
+                          std::vector<real_t>& fvals,
+                          std::vector<bool>& eval_grads,
+                          std::vector<real_t>& grads) {
+       
+        const real_t
+        n = n_vars();
+        
+        std::vector<real_t>
+        v = {0., 0.};
+        
+        for (uint_t i=0; i<n_local; i++) {
+            
+            v[0] += weight(i) * x[i] * x[i];
+            v[1] += x[i];
+        }
+        
+        comm.sum(v);
+        
+        obj      = v[0];
+        fvals[0] = 1. - v[1]/n;
+        
+        for (uint_t i=0; i<n_local; i++) {
+            
+            if (eval_obj_grad) obj_grad[i] = 2. * weight(i) * x[i];
+            if (eval_grads[0]) grads[i]    = -1./n;
+        }
+    }
+
+    inline void output(const uint_t                iter,
+                       const std::vector<real_t>  &dvars,
+                       real_t                     &o,
+                       std::vector<real_t>        &fvals) {
+        
+        obj = o;
+        x   = dvars;
+    }
+};
+
+
+
+TEST_CASE("distributed_gcmma_interface",
+          "[Optimization][Solvers][GCMMA]") {
+    
+    const libMesh::Parallel::Communicator
+    &comm = p_global_init->comm();
+    
+    MAST::Test::Optimization::Solvers::DistributedGCMMA::WeightedQuadraticFunction
+    f(comm);
+
+    MAST::Optimization::Solvers::DistributedGCMMAInterface<WeightedQuadraticFunction>
+    opt(comm);
+    // the Lagrange multiplier of the constraint is \f$ 2 N^2 / \sum_k 1/w_k \f$, which
+    // grows with the number of ranks and exceeds the default penalty on the constraint
+    // violation for more than one rank.
+    opt.constr_penalty = 1.e3;
+    opt.set_function_evaluation(f);
+    opt.init();
+    
+    opt.optimize();
+    
+    // analytical solution: x_j = N / (w_j \sum_k 1/w_k)
+    real_t
+    winv = 0.;
+    
+    for (uint_t i=0; i<f.n_local; i++)
+        winv += 1./f.weight(i);
+    comm.sum(winv);
+    
+    std::vector<real_t>
+    x_ref(f.n_local);
+    
+    for (uint_t i=0; i<f.n_local; i++)
+        x_ref[i] = f.n_vars() / (f.weight(i) * winv);
+    
+    // the objective is replicated on all ranks
+    CHECK(comm.verify(f.obj));
+    CHECK(f.obj == Catch::Detail::Approx(f.n_vars() * f.n_vars() / winv).epsilon(1.e-4));
+    CHECK_THAT(f.x, Catch::Approx(x_ref).epsilon(1.e-3));
+}
+
+} // namespace DistributedGCMMA
+} // namespace Solvers
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
@@ -85,12 +85,115 @@ struct RosenbrockFunction {
 };
 
 
+/*!
+ * provides the function values separately, which are used by GCMMA for the inner
+ * iterations.
+ */
+struct RosenbrockFunctionValues: public RosenbrockFunction {
+    
+    RosenbrockFunctionValues():
+    RosenbrockFunction(), n_evals(0), n_evals_without_grads(0), n_value_evals(0) {}
+    
+    uint_t n_evals, n_evals_without_grads, n_value_evals;
+    
+    virtual void evaluate(const std::vector<real_t>& x,
+                          real_t& obj,
+                          bool eval_obj_grad,
+                          std::vector<real_t>& obj_grad,
+                          std::vector<real_t>& fvals,
+                          std::vector<bool>& eval_grads,
+                          std::vector<real_t>& grads) {
+        
+        n_evals++;
+        if (!eval_obj_grad) n_evals_without_grads++;
+        RosenbrockFunction::evaluate(x, obj, eval_obj_grad, obj_grad, fvals, eval_grads, grads);
+    }
+    
+    inline void evaluate_values(const std::vector<real_t>& x,
+                                real_t& obj,
+                                std::vector<real_t>& fvals) {
+        
+        n_value_evals++;
+        obj = b*pow((x[1]-pow(x[0],2)),2) + pow(a-x[0], 2);
+    }
+};
+
+
+/*!
+ * toy problem from Svanberg's GCMMA documentation:
+ * minimize \f$ x_1^2 + x_2^2 + x_3^2 \f$ subject to
+ * \f$ (x_1-5)^2 + (x_2-2)^2 + (x_3-1)^2 \leq 9 \f$ and
+ * \f$ (x_1-3)^2 + (x_2-4)^2 + (x_3-3)^2 \leq 9 \f$, with \f$ 0 \leq x_j \leq 5 \f$.
+ * All iterates are stored.
+ */
+struct ToyProblem {
+
+    ToyProblem(): obj(0.) {}
+    
+    real_t obj;
+    std::vector<real_t> x;
+    std::vector<std::vector<real_t>> iterates;
+    
+    inline uint_t n_vars() const {return 3;}
+    inline uint_t   n_eq() const {return 0;}
+    inline uint_t n_ineq() const {return 2;}
+    
+    inline void init_dvar(std::vector<real_t>& x,
+                          std::vector<real_t>& xmin,
+                          std::vector<real_t>& xmax) {
+        
+        x    = {4., 3., 2.};
+        xmin = {0., 0., 0.};
+        xmax = {5., 5., 5.};
+    }
+
+    inline void evaluate(const std::vector<real_t>& x,
+                         real_t& obj,
+                         bool eval_obj_grad,
+                         std::vector<real_t>& obj_grad,
+                         std::vector<real_t>& fvals,
+                         std::vector<bool>& eval_grads,
+                         std::vector<real_t>& grads) {
+       
+        const std::vector<real_t>
+        c1 = {5., 2., 1.},
+        c2 = {3., 4., 3.};
+        
+        obj      =  0.;
+        fvals[0] = -9.;
+        fvals[1] = -9.;
+        
+        for (uint_t j=0; j<3; j++) {
+            
+            obj      += x[j]*x[j];
+            fvals[0] += pow(x[j]-c1[j], 2);
+            fvals[1] += pow(x[j]-c2[j], 2);
+            
+            if (eval_obj_grad) obj_grad[j] = 2.*x[j];
+            
+            // gradient of constraint i wrt x_j stored at index j*M+i
+            if (eval_grads[0]) grads[j*2]   = 2.*(x[j]-c1[j]);
+            if (eval_grads[1]) grads[j*2+1] = 2.*(x[j]-c2[j]);
+        }
+    }
+
+    inline void output(const uint_t                iter,
+                       const std::vector<real_t>  &dvars,
+                       real_t                     &o,
+                       std::vector<real_t>        &fvals) {
+        
+        obj = o;
+        x   = dvars;
+        iterates.push_back(dvars);
+    }
+};
+
+
 
 TEST_CASE("gcmma_interface",
           "[Optimization][Solvers][GCMMA]") {
     
     MAST::Test::Optimization::Solvers::GCMMA::RosenbrockFunction f;
-#if MAST_ENABLE_GCMMA == 1
 
     MAST::Optimization::Solvers::GCMMAInterface<RosenbrockFunction>
     opt(p_global_init->comm());
@@ -101,7 +204,65 @@ TEST_CASE("gcmma_interface",
     
     CHECK(f.obj == Catch::Detail::Approx(0.).margin(1.e-5));
     CHECK_THAT(f.x, Catch::Approx(std::vector<real_t>({1., 1.})).epsilon(1.e-2));
-#endif
+}
+
+
+TEST_CASE("gcmma_interface_function_values",
+          "[Optimization][Solvers][GCMMA]") {
+    
+    MAST::Test::Optimization::Solvers::GCMMA::RosenbrockFunctionValues f;
+
+    MAST::Optimization::Solvers::GCMMAInterface<RosenbrockFunctionValues>
+    opt(p_global_init->comm());
+    opt.set_function_evaluation(f);
+    opt.init();
+    
+    opt.optimize();
+    
+    // one gradient evaluation per outer iteration, and at least one function
+    // evaluation per inner iteration
+    CHECK(f.n_evals == opt.total_iter);
+    CHECK(f.n_evals_without_grads == 0);
+    CHECK(f.n_value_evals >= opt.total_iter);
+    CHECK(f.obj == Catch::Detail::Approx(0.).margin(1.e-5));
+    CHECK_THAT(f.x, Catch::Approx(std::vector<real_t>({1., 1.})).epsilon(1.e-2));
+}
+
+
+
+TEST_CASE("gcmma_interface_reference_iterates",
+          "[Optimization][Solvers][GCMMA]") {
+    
+    MAST::Test::Optimization::Solvers::GCMMA::ToyProblem f;
+
+    MAST::Optimization::Solvers::GCMMAInterface<ToyProblem>
+    opt(p_global_init->comm());
+    opt.set_function_evaluation(f);
+    opt.init();
+    
+    opt.optimize();
+    
+    // first iterates of the native subproblem solver, recorded as reference to
+    // detect changes in the approximation, asymptote update or subproblem solution.
+    // These are regression values from this implementation, and not from the Fortran
+    // reference implementation. Only the optimum below is an independent reference.
+    const std::vector<std::vector<real_t>>
+    x_ref = {
+        {4.0000000000e+00, 3.0000000000e+00, 2.0000000000e+00},
+        {3.9709965045e+00, 2.9732468153e+00, 1.9765894486e+00},
+        {3.9419811598e+00, 2.9464946130e+00, 1.9532036562e+00},
+        {3.9071483413e+00, 2.9143931822e+00, 1.9251709326e+00},
+        {3.8653279100e+00, 2.8758732630e+00, 1.8915760508e+00},
+        {3.8151125381e+00, 2.8296520441e+00, 1.8513276450e+00}};
+    
+    REQUIRE(f.iterates.size() > x_ref.size());
+    
+    for (uint_t i=0; i<x_ref.size(); i++)
+        CHECK_THAT(f.iterates[i], Catch::Approx(x_ref[i]).epsilon(1.e-6));
+    
+    // optimum of the toy problem, where both constraints are active
+    CHECK(f.obj == Catch::Detail::Approx(8.7702).epsilon(1.e-4));
+    CHECK_THAT(f.x, Catch::Approx(std::vector<real_t>({2.0175, 1.7800, 1.2375})).epsilon(1.e-4));
 }
 
 } // namespace GCMMA
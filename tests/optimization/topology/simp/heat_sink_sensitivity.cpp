@@ -0,0 +1,265 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#ifndef MAST_TESTING
+#define MAST_TESTING 1
+#endif
+
+#include <conduction/example_2/example_2.cpp>
+
+// Test includes
+#include <test_helpers.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Topology {
+namespace SIMP {
+namespace HeatSinkSensitivity {
+
+using traits_t    = MAST::Examples::Conduction::Example2::Traits<real_t, real_t, real_t, MAST::Mesh::Generation::HeatSink2D>;
+using elem_ops_t  = MAST::Examples::Conduction::Example2::ElemOps<traits_t>;
+using func_eval_t = MAST::Examples::Conduction::Example2::FunctionEvaluation<traits_t>;
+
+
+/*!
+ * @returns a density value in (0, 1) for design parameter \p i
+ */
+inline real_t test_value(uint_t i) { return 0.1 + 0.08 * ((7 * i) % 11);}
+
+
+/*!
+ * The adjoint problems of the mean temperature objective and of the p-norm temperature
+ * constraint are solved together in a single block solve, with the right-hand side of
+ * the constraint assembled by \p MultiOutputDerivative. The sensitivities of both are
+ * compared with central differences for a subset of design parameters.
+ */
+inline void test_heat_sink_sensitivity() {
+
+    char *args[] = {
+        (char*)" ",
+        (char*)"nx_divs=10",
+        (char*)"ny_divs=10",
+        (char*)"filter_radius=0.15",
+        (char*)"temperature_limit=1.",
+        (char*)"temperature_pnorm=4.",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(6, args);
+    
+    // the sensitivities are compared with central differences, which requires tightly
+    // converged solves
+    PetscOptionsSetValue(PETSC_NULL, "-ksp_rtol", "1.e-12");
+    
+    {
+        typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+        typename traits_t::context_t c(ex_init);
+        elem_ops_t                   e_ops(c);
+        func_eval_t                  f_eval(e_ops, c);
+        
+        REQUIRE(f_eval.n_ineq() == 2);
+        
+        const uint_t
+        n_vars = f_eval.n_vars(),
+        n_con  = f_eval.n_ineq();
+        
+        std::vector<real_t>
+        x,
+        xmin,
+        xmax,
+        obj_grad(n_vars, 0.),
+        fvals(n_con, 0.),
+        fvals_p(n_con, 0.),
+        fvals_m(n_con, 0.),
+        grads(n_vars*n_con, 0.);
+        
+        std::vector<bool>
+        eval_grads(n_con, true);
+        
+        real_t
+        obj   = 0.,
+        obj_p = 0.,
+        obj_m = 0.;
+        
+        f_eval.init_dvar(x, xmin, xmax);
+        
+        for (uint_t i=0; i<n_vars; i++)
+            x[i] = test_value(i);
+        
+        f_eval.evaluate(x, obj, true, obj_grad, fvals, eval_grads, grads);
+        
+        const real_t
+        delta = 1.e-5;
+        
+        const uint_t
+        stride = std::max<uint_t>(1, n_vars/10);
+        
+        for (uint_t i=0; i<n_vars; i+=stride) {
+        
+            x[i] += delta;
+            f_eval.evaluate_values(x, obj_p, fvals_p);
+            
+            x[i] -= 2.*delta;
+            f_eval.evaluate_values(x, obj_m, fvals_m);
+            
+            x[i] += delta;
+            
+            CHECK(obj_grad[i] == Catch::Detail::Approx((obj_p - obj_m)/(2.*delta)).epsilon(1.e-4).margin(1.e-8));
+            CHECK(grads[i*n_con] ==
+                  Catch::Detail::Approx((fvals_p[0] - fvals_m[0])/(2.*delta)).epsilon(1.e-4).margin(1.e-8));
+            CHECK(grads[i*n_con+1] ==
+                  Catch::Detail::Approx((fvals_p[1] - fvals_m[1])/(2.*delta)).epsilon(1.e-4).margin(1.e-8));
+        }
+    }
+    
+    PetscOptionsClearValue(PETSC_NULL, "-ksp_rtol");
+}
+
+
+/*!
+ * evaluates the objective and constraint gradients at the design of \p test_value()
+ * with the design parameter layout chosen by \p distributed.
+ */
+inline void evaluate_gradients(bool                 distributed,
+                               uint_t              &first_local,
+                               std::vector<real_t> &obj_grad,
+                               std::vector<real_t> &grads) {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"nx_divs=10",
+        (char*)"ny_divs=10",
+        (char*)"filter_radius=0.15",
+        (char*)"temperature_limit=1.",
+        (char*)(distributed? "distributed_optimizer=true" : "distributed_optimizer=false"),
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(6, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    typename traits_t::context_t c(ex_init);
+    elem_ops_t                   e_ops(c);
+    func_eval_t                  f_eval(e_ops, c);
+    
+    const uint_t
+    n_con = f_eval.n_ineq();
+    
+    std::vector<real_t>
+    x,
+    xmin,
+    xmax,
+    fvals(n_con, 0.);
+    
+    std::vector<bool>
+    eval_grads(n_con, true);
+    
+    real_t
+    obj = 0.;
+    
+    f_eval.init_dvar(x, xmin, xmax);
+    
+    // the local design parameters are contiguous and ordered by rank
+    first_local = 0;
+    
+    if (distributed) {
+        
+        REQUIRE(x.size() == f_eval.n_local_vars());
+        
+        std::vector<uint_t>
+        n_local;
+        p_global_init->comm().allgather(uint_t(x.size()), n_local);
+        
+        for (uint_t i=0; i<p_global_init->comm().rank(); i++)
+            first_local += n_local[i];
+    }
+    else
+        REQUIRE(x.size() == f_eval.n_vars());
+    
+    for (uint_t i=0; i<x.size(); i++)
+        x[i] = test_value(first_local + i);
+    
+    obj_grad.resize(x.size(), 0.);
+    grads.resize(x.size()*n_con, 0.);
+    
+    f_eval.evaluate(x, obj, true, obj_grad, fvals, eval_grads, grads);
+}
+
+
+/*!
+ * The gradients for the distributed optimizer, with only the local design parameters
+ * on each rank, must match the corresponding entries of the replicated gradients.
+ */
+inline void test_heat_sink_distributed_layout() {
+    
+    uint_t
+    first_local      = 0,
+    first_replicated = 0;
+    
+    std::vector<real_t>
+    obj_grad,
+    grads,
+    obj_grad_local,
+    grads_local;
+    
+    evaluate_gradients(false, first_replicated, obj_grad, grads);
+    evaluate_gradients(true,  first_local,  obj_grad_local, grads_local);
+    
+    const uint_t
+    n_con = grads.size()/obj_grad.size();
+    
+    for (uint_t i=0; i<obj_grad_local.size(); i++) {
+        
+        CHECK(obj_grad_local[i] == Catch::Detail::Approx(obj_grad[first_local+i]));
+        
+        for (uint_t j=0; j<n_con; j++)
+            CHECK(grads_local[i*n_con+j] ==
+                  Catch::Detail::Approx(grads[(first_local+i)*n_con+j]).margin(1.e-12));
+    }
+}
+
+
+
+TEST_CASE("heat_sink_multiple_adjoint_sensitivity",
+          "[Optimization][Topology][SIMP]") {
+    
+    test_heat_sink_sensitivity();
+}
+
+
+
+TEST_CASE("heat_sink_distributed_layout",
+          "[Optimization][Topology][SIMP]") {
+    
+    test_heat_sink_distributed_layout();
+}
+
+} // namespace HeatSinkSensitivity
+} // namespace SIMP
+} // namespace Topology
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
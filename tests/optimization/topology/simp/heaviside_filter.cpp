@@ -117,11 +117,43 @@ inline void test_heaviside_sensitivity()  {
 }
 
 
+inline void test_heaviside_projection()  {
+    
+    MAST::Optimization::Topology::SIMP::HeavisideFilter
+    <real_t, DensityField<real_t>>
+    density;
+    
+    density.set_parameters(10., 0.2);
+    
+    std::vector<real_t>
+    v    = {0., 0.1, 0.2, 0.5, 0.9, 1.},
+    v_f,
+    dv_f;
+    
+    density.project(v, v_f, dv_f);
+    
+    REQUIRE(v_f.size()  == v.size());
+    REQUIRE(dv_f.size() == v.size());
+    
+    // the projection should match the filter at each point, and should be 0 and 1
+    // at the bounds
+    CHECK(v_f[0] == Catch::Detail::Approx(0.).margin(1.e-12));
+    CHECK(v_f.back() == Catch::Detail::Approx(1.));
+    
+    for (uint_t i=0; i<v.size(); i++) {
+        
+        CHECK(v_f[i]  == Catch::Detail::Approx(density.filter(v[i])));
+        CHECK(dv_f[i] == Catch::Detail::Approx(density.filter_derivative(v[i], 1.)));
+    }
+}
+
+
 
 TEST_CASE("heaviside_filter_sensitivity",
           "[Optimization][Topology][SIMP][ComplexStep][AdolC]") {
     
     test_heaviside_sensitivity();
+    test_heaviside_projection();
 }
 
 } // namespace SIMP
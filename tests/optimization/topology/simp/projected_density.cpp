@@ -0,0 +1,294 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#ifndef MAST_TESTING
+#define MAST_TESTING 1
+#endif
+
+#include <structural/example_6/example_6.cpp>
+
+// Test includes
+#include <test_helpers.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Topology {
+namespace SIMP {
+namespace ProjectedDensity {
+
+using traits_t    = MAST::Examples::Structural::Example6::Traits<real_t, real_t, real_t, MAST::Mesh::Generation::Bracket2D>;
+using heaviside_t = typename traits_t::heaviside_t;
+using projected_t = MAST::Optimization::Topology::SIMP::libMeshWrapper::ProjectedDensity<real_t, heaviside_t>;
+using volume_t    = MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<real_t>;
+using map_t       = MAST::Optimization::Utility::DesignParameterMap<real_t>;
+
+
+/*!
+ * @returns a density value in (0, 1) for dof or design parameter \p i, so that the
+ * projection is evaluated over a range of values.
+ */
+inline real_t test_value(uint_t i) { return 0.1 + 0.08 * ((7 * i) % 11);}
+
+
+/*!
+ * sets the density design parameters to \p x, applies the geometric filter and
+ * updates the projected density.
+ */
+inline void update_density(typename traits_t::ex_init_t &ex_init,
+                           const map_t                  &dv_map,
+                           const std::vector<real_t>    &x,
+                           projected_t                  &density) {
+    
+    std::unique_ptr<libMesh::NumericVector<real_t>>
+    rho_base(ex_init.rho_sys->current_local_solution->clone().release());
+    
+    *rho_base = 1.;
+    dv_map.scatter(x, *rho_base);
+    
+    ex_init.filter->compute_filtered_values
+    (dynamic_cast<libMesh::PetscVector<real_t>*>(rho_base.get())->vec(),
+     dynamic_cast<libMesh::PetscVector<real_t>*>(ex_init.rho_sys->solution.get())->vec());
+    ex_init.rho_sys->solution->close();
+    ex_init.rho_sys->update();
+    
+    density.update(*ex_init.rho_sys->current_local_solution);
+}
+
+
+/*!
+ * sets the local density dofs to \p test_value() shifted by \p shift, and updates the
+ * projected density.
+ */
+inline void set_local_density(libMesh::ExplicitSystem &rho_sys,
+                              const real_t             shift,
+                              projected_t             &density) {
+    
+    for (uint_t i=rho_sys.solution->first_local_index();
+         i<rho_sys.solution->last_local_index(); i++)
+        rho_sys.solution->set(i, test_value(i) + shift);
+    rho_sys.solution->close();
+    rho_sys.update();
+    
+    density.update(*rho_sys.current_local_solution);
+}
+
+
+/*!
+ * copies the local values of \p v to \p vals
+ */
+inline void local_values(libMesh::ExplicitSystem              &rho_sys,
+                         const libMesh::NumericVector<real_t> &v,
+                         std::vector<real_t>                  &vals) {
+    
+    vals.clear();
+    
+    for (uint_t i=rho_sys.solution->first_local_index();
+         i<rho_sys.solution->last_local_index(); i++)
+        vals.push_back(v.el(i));
+}
+
+
+inline void test_projected_density() {
+
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    heaviside_t
+    heaviside;
+    heaviside.set_parameters(4., 0.5);
+    
+    projected_t
+    density(heaviside);
+    
+    CHECK_FALSE(density.is_initialized());
+    
+    libMesh::ExplicitSystem
+    &rho_sys = *ex_init.rho_sys;
+    
+    const uint_t
+    first_local_rho = rho_sys.get_dof_map().first_dof(rho_sys.comm().rank()),
+    last_local_rho  = rho_sys.get_dof_map().end_dof(rho_sys.comm().rank());
+    
+    const real_t
+    delta = 1.e-6;
+    
+    std::vector<real_t>
+    v_p,
+    v_m;
+    
+    // since each value is projected independently, all values are perturbed together
+    // for the central difference derivative
+    set_local_density(rho_sys, delta, density);
+    local_values(rho_sys, density.values(), v_p);
+    
+    set_local_density(rho_sys, -delta, density);
+    local_values(rho_sys, density.values(), v_m);
+    
+    set_local_density(rho_sys, 0., density);
+    
+    REQUIRE(density.is_initialized());
+    
+    // the values and derivatives at the unperturbed density
+    const libMesh::NumericVector<real_t>
+    &rho  = *rho_sys.current_local_solution,
+    &v    = density.values(),
+    &dv   = density.derivatives();
+    
+    for (uint_t i=first_local_rho; i<last_local_rho; i++) {
+    
+        CHECK(v.el(i)  == Catch::Detail::Approx(heaviside.filter(test_value(i))));
+        CHECK(dv.el(i) == Catch::Detail::Approx(heaviside.filter_derivative(test_value(i), 1.)));
+        CHECK(dv.el(i) == Catch::Detail::Approx((v_p[i-first_local_rho] -
+                                                 v_m[i-first_local_rho])/(2.*delta)));
+    }
+    
+    // the ghosted values should be available from the projected vectors
+    const std::vector<libMesh::dof_id_type>
+    &send_list = rho_sys.get_dof_map().get_send_list();
+    
+    for (uint_t i=0; i<send_list.size(); i++) {
+    
+        CHECK(v.el(send_list[i])  == Catch::Detail::Approx(heaviside.filter(rho.el(send_list[i]))));
+        CHECK(dv.el(send_list[i]) ==
+              Catch::Detail::Approx(heaviside.filter_derivative(rho.el(send_list[i]), 1.)));
+    }
+}
+
+
+inline void test_volume_projected_density_sensitivity() {
+
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    typename traits_t::context_t c(ex_init);
+    
+    MAST::Optimization::DesignParameterVector<real_t> dvs(p_global_init->comm());
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    map_t
+    dv_map(dvs, map_t::REPLICATED);
+    
+    heaviside_t
+    heaviside;
+    heaviside.set_parameters(4., 0.5);
+    
+    projected_t
+    density(heaviside);
+    
+    volume_t
+    volume;
+    volume.set_design_parameter_map(dv_map);
+    
+    std::vector<real_t>
+    x          (dv_map.vector_size(), 0.),
+    sens       (dv_map.vector_size(), 0.),
+    sens_filter(dv_map.vector_size(), 0.);
+    
+    for (uint_t i=0; i<x.size(); i++)
+        x[i] = test_value(i);
+    
+    update_density(ex_init, dv_map, x, density);
+    
+    // the overloads with the projected density should match the overloads that
+    // project the density at each dof
+    const real_t
+    vol = volume.compute(c, density);
+    
+    CHECK(vol == Catch::Detail::Approx
+          (volume.compute(c, *ex_init.rho_sys->current_local_solution, heaviside)));
+    
+    volume.derivative(c, density, *ex_init.filter, sens);
+    volume.derivative(c,
+                      *ex_init.rho_sys->current_local_solution,
+                      heaviside,
+                      *ex_init.filter,
+                      sens_filter);
+    
+    REQUIRE(sens.size() == dvs.size());
+    CHECK_THAT(sens, Catch::Approx(sens_filter));
+    
+    // central difference sensitivity for a subset of design parameters that is
+    // the same on all ranks
+    const real_t
+    delta = 1.e-6;
+    
+    const uint_t
+    stride = std::max<uint_t>(1, x.size()/10);
+    
+    real_t
+    vol_p = 0.,
+    vol_m = 0.;
+    
+    for (uint_t i=0; i<x.size(); i+=stride) {
+    
+        x[i] += delta;
+        update_density(ex_init, dv_map, x, density);
+        vol_p = volume.compute(c, density);
+        
+        x[i] -= 2.*delta;
+        update_density(ex_init, dv_map, x, density);
+        vol_m = volume.compute(c, density);
+        
+        x[i] += delta;
+        
+        CHECK(sens[i] == Catch::Detail::Approx((vol_p - vol_m)/(2.*delta)).margin(1.e-8));
+    }
+}
+
+
+
+TEST_CASE("projected_density",
+          "[Optimization][Topology][SIMP]") {
+    
+    test_projected_density();
+}
+
+
+TEST_CASE("volume_projected_density_sensitivity",
+          "[Optimization][Topology][SIMP]") {
+    
+    test_volume_projected_density_sensitivity();
+}
+
+} // namespace ProjectedDensity
+} // namespace SIMP
+} // namespace Topology
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
@@ -0,0 +1,159 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#ifndef MAST_TESTING
+#define MAST_TESTING 1
+#endif
+
+#include <structural/example_6/example_6.cpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/mesh_modification.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Topology {
+namespace SIMP {
+namespace Volume {
+
+using traits_t = MAST::Examples::Structural::Example6::Traits<real_t, real_t, real_t, MAST::Mesh::Generation::Bracket2D>;
+using volume_t = MAST::Optimization::Topology::SIMP::libMeshWrapper::Volume<real_t>;
+
+
+/*!
+ * @returns a density value in (0, 1) for dof \p i
+ */
+inline real_t test_value(uint_t i) { return 0.1 + 0.08 * ((7 * i) % 11);}
+
+
+/*!
+ * @returns the volume computed element-by-element from the current mesh, without
+ * the cached contribution of each dof.
+ */
+inline real_t
+reference_volume(typename traits_t::ex_init_t         &ex_init,
+                 const libMesh::NumericVector<real_t> &density) {
+    
+    uint_t
+    sys_num = ex_init.rho_sys->number(),
+    n_nodes = 0;
+    
+    real_t
+    rho     = 0.,
+    vol     = 0.;
+    
+    libMesh::MeshBase::const_element_iterator
+    it    =  ex_init.mesh->active_local_elements_begin(),
+    end   =  ex_init.mesh->active_local_elements_end();
+    
+    for ( ; it != end; it++) {
+    
+        const libMesh::Elem& e = **it;
+        
+        n_nodes = MAST::Mesh::libMeshWrapper::Utility::n_linear_basis_nodes_on_elem(e);
+        rho     = 0.;
+        
+        for (uint_t i=0; i<n_nodes; i++)
+            rho += density.el(e.node_ptr(i)->dof_number(sys_num, 0, 0));
+        
+        vol += e.volume() * rho / (1. * n_nodes);
+    }
+    
+    ex_init.rho_sys->comm().sum(vol);
+    
+    return vol;
+}
+
+
+inline void test_cached_weights() {
+
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    typename traits_t::context_t c(ex_init);
+    
+    libMesh::ExplicitSystem
+    &rho_sys = *ex_init.rho_sys;
+    
+    for (uint_t i=rho_sys.solution->first_local_index();
+         i<rho_sys.solution->last_local_index(); i++)
+        rho_sys.solution->set(i, test_value(i));
+    rho_sys.solution->close();
+    rho_sys.update();
+    
+    const libMesh::NumericVector<real_t>
+    &rho = *rho_sys.current_local_solution;
+    
+    volume_t
+    volume;
+    
+    // the weights are computed at the first use, and the values from the cached weights
+    // should match a fresh computation over the elements
+    const real_t
+    vol0 = reference_volume(ex_init, rho);
+    
+    CHECK(volume.compute(c, rho) == Catch::Detail::Approx(vol0));
+    CHECK(volume.compute(c, rho) == Catch::Detail::Approx(vol0));
+    
+    // scale the mesh, which changes the volume of each element by a factor of 4
+    libMesh::MeshTools::Modification::scale(*ex_init.mesh, 2., 2.);
+    
+    const real_t
+    vol1 = reference_volume(ex_init, rho);
+    
+    CHECK(vol1 == Catch::Detail::Approx(4. * vol0));
+    
+    // the cached weights are used until the object is cleared
+    CHECK(volume.compute(c, rho) == Catch::Detail::Approx(vol0));
+    
+    volume.clear();
+    
+    CHECK(volume.compute(c, rho) == Catch::Detail::Approx(vol1));
+}
+
+
+
+TEST_CASE("volume_cached_weights",
+          "[Optimization][Topology][SIMP]") {
+    
+    test_cached_weights();
+}
+
+} // namespace Volume
+} // namespace SIMP
+} // namespace Topology
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
@@ -0,0 +1,249 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#ifndef MAST_TESTING
+#define MAST_TESTING 1
+#endif
+
+#include <structural/example_6/example_6.cpp>
+#include <mast/optimization/utility/design_parameter_map.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+extern libMesh::LibMeshInit* p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Optimization {
+namespace Utility {
+namespace DesignParameterMap {
+
+using traits_t = MAST::Examples::Structural::Example6::Traits<real_t, real_t, real_t, MAST::Mesh::Generation::Bracket2D>;
+using map_t    = MAST::Optimization::Utility::DesignParameterMap<real_t>;
+
+
+/*!
+ * @returns the value stored at density dof \p i in the test vectors
+ */
+inline real_t dof_value(uint_t i) { return 1. + 0.5 * i;}
+
+
+/*!
+ * @returns the values of density dofs of all design parameters, computed independently
+ * of the map using a sum over all ranks.
+ */
+inline std::vector<real_t>
+replicated_reference(const MAST::Optimization::DesignParameterVector<real_t> &dvs) {
+    
+    std::vector<real_t>
+    x(dvs.size(), 0.);
+    
+    for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++)
+        x[i] = dof_value(dvs.dof_id(i));
+    
+    dvs.comm().sum(x);
+    
+    return x;
+}
+
+
+template <typename VecType>
+inline void check_gather(const MAST::Optimization::DesignParameterVector<real_t> &dvs,
+                         const VecType                                           &v) {
+    
+    map_t
+    local      (dvs, map_t::LOCAL),
+    replicated (dvs, map_t::REPLICATED);
+    
+    REQUIRE(local.layout()           == map_t::LOCAL);
+    REQUIRE(replicated.layout()      == map_t::REPLICATED);
+    REQUIRE(local.vector_size()      == dvs.local_end() - dvs.local_begin());
+    REQUIRE(replicated.vector_size() == dvs.size());
+    
+    // the local layout has only the values of local design parameters
+    std::vector<real_t>
+    x(local.vector_size(), 0.);
+    
+    local.gather(v, x);
+    
+    for (uint_t i=0; i<x.size(); i++)
+        CHECK(x[i] == Catch::Detail::Approx(dof_value(dvs.dof_id(dvs.local_begin()+i))));
+    
+    // the replicated layout has values of all design parameters on all ranks
+    x.assign(replicated.vector_size(), 0.);
+    
+    replicated.gather(v, x);
+    
+    CHECK_THAT(x, Catch::Approx(replicated_reference(dvs)));
+}
+
+
+/*!
+ * @returns the value of design parameter with ID \p i in the test vectors
+ */
+inline real_t dv_value(uint_t i) { return 2. + 0.25 * i;}
+
+
+/*!
+ * scatters design parameters in layout \p layout to \p v, whose entries are initialized
+ * to -1, and checks that only the dofs of local parameters are modified.
+ */
+template <typename VecType>
+inline void check_scatter(MAST::Optimization::DesignParameterVector<real_t> &dvs,
+                          typename map_t::Layout                             layout,
+                          VecType                                           &v,
+                          const uint_t                                       first_local_rho,
+                          const uint_t                                       last_local_rho) {
+    
+    map_t
+    dv_map(dvs, layout);
+    
+    std::vector<real_t>
+    x(dv_map.vector_size(), 0.);
+    
+    const uint_t
+    offset = (layout == map_t::REPLICATED)? 0 : dvs.local_begin();
+    
+    for (uint_t i=0; i<x.size(); i++)
+        x[i] = dv_value(offset+i);
+    
+    for (uint_t i=first_local_rho; i<last_local_rho; i++)
+        MAST::Numerics::Utility::set(v, i, -1.);
+    MAST::Numerics::Utility::finalize(v);
+    
+    dv_map.scatter(x, v);
+    
+    std::vector<real_t>
+    ref(last_local_rho - first_local_rho, -1.);
+    
+    for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++)
+        ref[dvs.dof_id(i) - first_local_rho] = dv_value(i);
+    
+    for (uint_t i=first_local_rho; i<last_local_rho; i++)
+        CHECK(MAST::Numerics::Utility::get(v, i) ==
+              Catch::Detail::Approx(ref[i - first_local_rho]));
+    
+    // the values copied back to the design parameter vector should match
+    for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++)
+        dvs[i]() = 0.;
+    
+    dv_map.gather(v, dvs);
+    
+    for (uint_t i=dvs.local_begin(); i<dvs.local_end(); i++)
+        CHECK(dvs[i]() == Catch::Detail::Approx(dv_value(i)));
+}
+
+
+inline void test_gather() {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    MAST::Optimization::DesignParameterVector<real_t> dvs(p_global_init->comm());
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    const uint_t
+    n_rho_vals      = ex_init.rho_sys->n_dofs(),
+    first_local_rho = ex_init.rho_sys->get_dof_map().first_dof(ex_init.rho_sys->comm().rank()),
+    last_local_rho  = ex_init.rho_sys->get_dof_map().end_dof(ex_init.rho_sys->comm().rank());
+    
+    // distributed libMesh vector
+    std::unique_ptr<libMesh::NumericVector<real_t>>
+    v(ex_init.rho_sys->solution->zero_clone().release());
+    
+    for (uint_t i=first_local_rho; i<last_local_rho; i++)
+        v->set(i, dof_value(i));
+    v->close();
+    
+    check_gather(dvs, *v);
+    
+    // Eigen vector with values for all dofs
+    Eigen::Matrix<real_t, Eigen::Dynamic, 1>
+    v_eigen = Eigen::Matrix<real_t, Eigen::Dynamic, 1>::Zero(n_rho_vals);
+    
+    for (uint_t i=0; i<n_rho_vals; i++)
+        v_eigen(i) = dof_value(i);
+    
+    check_gather(dvs, v_eigen);
+}
+
+
+inline void test_scatter() {
+    
+    char *args[] = {
+        (char*)" ",
+        (char*)"filter_radius=0.05",
+        NULL
+    };
+    
+    MAST::Utility::GetPotWrapper input(2, args);
+    
+    typename traits_t::ex_init_t ex_init(p_global_init->comm(), input);
+    
+    MAST::Optimization::DesignParameterVector<real_t> dvs(p_global_init->comm());
+    ex_init.model->init_simp_dvs(ex_init, dvs);
+    
+    const uint_t
+    n_rho_vals      = ex_init.rho_sys->n_dofs(),
+    first_local_rho = ex_init.rho_sys->get_dof_map().first_dof(ex_init.rho_sys->comm().rank()),
+    last_local_rho  = ex_init.rho_sys->get_dof_map().end_dof(ex_init.rho_sys->comm().rank());
+    
+    std::unique_ptr<libMesh::NumericVector<real_t>>
+    v(ex_init.rho_sys->solution->zero_clone().release());
+    
+    Eigen::Matrix<real_t, Eigen::Dynamic, 1>
+    v_eigen = Eigen::Matrix<real_t, Eigen::Dynamic, 1>::Zero(n_rho_vals);
+    
+    check_scatter(dvs, map_t::LOCAL,      *v, first_local_rho, last_local_rho);
+    check_scatter(dvs, map_t::REPLICATED, *v, first_local_rho, last_local_rho);
+    check_scatter(dvs, map_t::LOCAL,      v_eigen, first_local_rho, last_local_rho);
+    check_scatter(dvs, map_t::REPLICATED, v_eigen, first_local_rho, last_local_rho);
+}
+
+
+TEST_CASE("design_parameter_map_gather",
+          "[Optimization][Utility]") {
+    
+    test_gather();
+}
+
+
+TEST_CASE("design_parameter_map_scatter",
+          "[Optimization][Utility]") {
+    
+    test_scatter();
+}
+
+} // namespace DesignParameterMap
+} // namespace Utility
+} // namespace Optimization
+} // namespace Test
+} // namespace MAST
@@ -62,8 +62,8 @@ struct Traits {
     using scalar_t          = typename MAST::DeducedScalarType<typename MAST::DeducedScalarType<BasisScalarType, NodalScalarType>::type, SolScalarType>::type;
     using vector_t          = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
     using matrix_t          = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
-    using quadrature_t      = MAST::Quadrature::libMeshWrapper::Quadrature<BasisScalarType, 2>;
     using fe_basis_t        = typename MAST::FEBasis::libMeshWrapper::FEBasis<BasisScalarType, Dim>;
+    using quadrature_t      = typename fe_basis_t::quadrature_t;
     using fe_shape_t        = typename MAST::FEBasis::Evaluation::FEShapeDerivative<BasisScalarType, NodalScalarType, Dim, Dim, fe_basis_t>;
     using fe_var_t          = typename MAST::FEBasis::FEVarData<BasisScalarType, NodalScalarType, SolScalarType, Dim, Dim, Context, fe_shape_t>;
     using modulus_t         = typename MAST::Base::ScalarConstant<SolScalarType>;
@@ -292,6 +292,83 @@ TEST_CASE("linear_strain_energy",
         delete nodes[i];
 }
 
+
+TEST_CASE("linear_strain_energy_single_precision",
+          "[2D][QUAD4][Elasticity][Linear][StrainEnergy][SinglePrecision]") {
+    
+    Eigen::Matrix<real_t, 4, 1>
+    x_vec,
+    y_vec;
+    
+    x_vec << -1., 1., 1., -1.;
+    y_vec << -1., -1., 1., 1.;
+    
+    // randomly perturb the coordinates
+    x_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    y_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    
+    std::unique_ptr<libMesh::Elem>
+    e(libMesh::Elem::build(libMesh::QUAD4).release());
+    
+    std::vector<libMesh::Node*> nodes(4, nullptr);
+    for (uint_t i=0; i<e->n_nodes(); i++) {
+        nodes[i] = libMesh::Node::build(libMesh::Point(x_vec(i), y_vec(i)), i).release();
+        e->set_node(i) = nodes[i];
+    }
+    
+    using traits_t         = Traits<real_t, real_t, real_t, 2>;
+    using traits_single_t  = Traits<float, float, float, 2>;
+    
+    typename traits_t::vector_t
+    sol,
+    res,
+    res_s;
+
+    typename traits_t::matrix_t
+    jac,
+    jac_s;
+
+    ElemOps<traits_t> e_ops;
+    e_ops.init(e.get());
+    
+    sol    = 0.1 * traits_t::vector_t::Random(e_ops.n_dofs());
+    res    = traits_t::vector_t::Zero(e_ops.n_dofs());
+    jac    = traits_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs());
+
+    e_ops.compute(sol, res, &jac);
+
+    // the basis, geometry and element quantities are computed in single precision
+    // and converted to double precision, as would be done during accumulation
+    {
+        typename traits_single_t::vector_t
+        res_f = traits_single_t::vector_t::Zero(e_ops.n_dofs());
+        
+        typename traits_single_t::matrix_t
+        jac_f = traits_single_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs());
+
+        ElemOps<traits_single_t> e_ops_s;
+        e_ops_s.init(e.get());
+        
+        e_ops_s.compute(sol.cast<float>(), res_f, &jac_f);
+        
+        res_s = res_f.cast<real_t>();
+        jac_s = jac_f.cast<real_t>();
+    }
+
+    // single precision results should agree within the precision of float, relative
+    // to the magnitude of the largest entry
+    const real_t
+    tol = 1.e-5;
+    
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_s),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)).margin(tol * res.cwiseAbs().maxCoeff()));
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(jac_s),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(jac)).margin(tol * jac.cwiseAbs().maxCoeff()));
+
+    for (uint_t i=0; i<nodes.size(); i++)
+        delete nodes[i];
+}
+
 } // namespace LinearStrainEnergy
 } // namespace Elasticity
 } // namespace Physics
@@ -26,7 +26,9 @@
 #include <mast/fe/fe_var_data.hpp>
 #include <mast/base/scalar_constant.hpp>
 #include <mast/physics/elasticity/isotropic_stiffness.hpp>
+#include <mast/physics/elasticity/linear_strain_energy.hpp>
 #include <mast/physics/elasticity/linear_thermoelastic_load.hpp>
+#include <mast/physics/elasticity/linear_thermoelastic_strain_energy.hpp>
 
 // Test includes
 #include <test_helpers.h>
@@ -76,6 +78,8 @@ struct Traits {
     using prop_t        = typename MAST::Physics::Elasticity::IsotropicMaterialStiffness<SolScalarType, Dim, modulus_t, nu_t, Context>;
     using temperature_t = typename MAST::Base::ScalarConstant<SolScalarType>;
     using temp_load_t   = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticLoad<fe_var_t, temperature_t, alpha_t, prop_t, Dim, Context>;
+    using energy_t      = typename MAST::Physics::Elasticity::LinearContinuum::StrainEnergy<fe_var_t, prop_t, Dim, Context>;
+    using fused_t       = typename MAST::Physics::Elasticity::LinearContinuum::ThermoelasticStrainEnergy<fe_var_t, temperature_t, alpha_t, prop_t, Dim, Context>;
 };
 
 
@@ -335,6 +339,156 @@ TEST_CASE("linear_thermoelastic_load",
         delete nodes[i];
 }
 
+
+
+TEST_CASE("linear_thermoelastic_strain_energy_fused",
+          "[2D][QUAD4][Elasticity][Linear][ThermoelasticLoad]") {
+    
+    Eigen::Matrix<real_t, 4, 1>
+    x_vec,
+    y_vec;
+    
+    x_vec << -1., 1., 1., -1.;
+    y_vec << -1., -1., 1., 1.;
+    
+    // randomly perturb the coordinates
+    x_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    y_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    
+    std::unique_ptr<libMesh::Elem>
+    e(libMesh::Elem::build(libMesh::QUAD4).release());
+    
+    std::vector<libMesh::Node*> nodes(4, nullptr);
+    for (uint_t i=0; i<e->n_nodes(); i++) {
+        nodes[i] = libMesh::Node::build(libMesh::Point(x_vec(i), y_vec(i)), i).release();
+        e->set_node(i) = nodes[i];
+    }
+    
+    using traits_t         = Traits<real_t, real_t, real_t, 2>;
+    
+    // the fused kernel caches element quantities by element ID
+    e->set_id(0);
+    
+    ElemOps<traits_t> e_ops;
+    e_ops.init(e.get());
+
+    // strain energy and the fused kernel share the data of the thermoelastic load
+    typename traits_t::energy_t energy;
+    energy.set_section_property(*e_ops.prop);
+    energy.set_fe_var_data(*e_ops.fe_var);
+
+    typename traits_t::fused_t fused;
+    fused.set_section_property(*e_ops.prop);
+    fused.set_coeff_thermal_expansion(*e_ops.alpha);
+    fused.set_temperature(*e_ops.dt);
+    fused.set_fe_var_data(*e_ops.fe_var);
+
+    typename traits_t::vector_t
+    sol    = 0.1 * traits_t::vector_t::Random(e_ops.n_dofs()),
+    res    = traits_t::vector_t::Zero(e_ops.n_dofs()),
+    res_f  = traits_t::vector_t::Zero(e_ops.n_dofs());
+
+    typename traits_t::matrix_t
+    jac    = traits_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs()),
+    jac_f  = traits_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs());
+
+    e_ops.fe_var->init(e_ops.c, sol);
+
+    // residual and Jacobian
+    {
+        energy.compute(e_ops.c, res, &jac);
+        e_ops.therm_e->compute(e_ops.c, res, &jac);
+        fused.compute(e_ops.c, res_f, &jac_f);
+
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)));
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(jac_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(jac)));
+    }
+
+    // sensitivity wrt E and dt
+    {
+        res.setZero(); jac.setZero(); res_f.setZero(); jac_f.setZero();
+        energy.derivative(e_ops.c, *e_ops.E, res, &jac);
+        e_ops.therm_e->derivative(e_ops.c, *e_ops.E, res, &jac);
+        fused.derivative(e_ops.c, *e_ops.E, res_f, &jac_f);
+
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)));
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(jac_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(jac)));
+
+        res.setZero(); res_f.setZero();
+        e_ops.therm_e->derivative(e_ops.c, *e_ops.dt, res);
+        fused.derivative(e_ops.c, *e_ops.dt, res_f);
+
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)));
+    }
+
+    // load for the temperature field provided as argument
+    {
+        res.setZero(); res_f.setZero();
+        e_ops.therm_e->compute(e_ops.c, res);
+        fused.temperature_load(e_ops.c, *e_ops.dt, res_f);
+
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)));
+        
+        // the load is linear in the temperature
+        typename traits_t::temperature_t
+        dt2(2. * (*e_ops.dt)());
+        
+        res_f.setZero();
+        fused.temperature_load(e_ops.c, dt2, res_f);
+        res *= 2.;
+        
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res)));
+    }
+
+    // the operator is cached for the element, and changes in the property and the
+    // coefficient of thermal expansion are applied at each call
+    {
+        typename traits_t::vector_t
+        res_0 = traits_t::vector_t::Zero(e_ops.n_dofs());
+        
+        fused.clear_temperature_load();
+        fused.temperature_load(e_ops.c, *e_ops.dt, res_0);
+        CHECK(fused.n_cached_temperature_loads() == 1);
+        
+        const real_t
+        alpha0 = (*e_ops.alpha)(),
+        E0     = (*e_ops.E)();
+        (*e_ops.alpha) = 2. * alpha0;
+        (*e_ops.E)     = 3. * E0;
+        
+        res_f.setZero();
+        fused.temperature_load(e_ops.c, *e_ops.dt, res_f);
+        CHECK(fused.n_cached_temperature_loads() == 1);
+        
+        res_0 *= 6.;
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res_0)));
+        
+        // the operator is recomputed after the cache is cleared
+        fused.clear_temperature_load();
+        CHECK(fused.n_cached_temperature_loads() == 0);
+        
+        res_f.setZero();
+        fused.temperature_load(e_ops.c, *e_ops.dt, res_f);
+        CHECK(fused.n_cached_temperature_loads() == 1);
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res_f),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res_0)));
+        
+        (*e_ops.alpha) = alpha0;
+        (*e_ops.E)     = E0;
+    }
+
+    for (uint_t i=0; i<nodes.size(); i++)
+        delete nodes[i];
+}
+
 } // namespace PressureLoad
 } // namespace Elasticity
 } // namespace Physics
@@ -331,6 +331,99 @@ TEST_CASE("mindlin_plate_strain_energy_complex_step",
         delete nodes[i];
 }
 
+
+TEST_CASE("mindlin_plate_strain_energy_dual",
+          "[2D][QUAD4][Elasticity][Linear][StrainEnergy][Mindlin][Bending][Dual]") {
+    
+    Eigen::Matrix<real_t, 4, 1>
+    x_vec,
+    y_vec;
+    
+    x_vec << -1., 1., 1., -1.;
+    y_vec << -1., -1., 1., 1.;
+    
+    // randomly perturb the coordinates
+    x_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    y_vec += 0.1 * Eigen::Matrix<real_t, 4, 1>::Random();
+    
+    std::unique_ptr<libMesh::Elem>
+    e(libMesh::Elem::build(libMesh::QUAD4).release());
+    
+    std::vector<libMesh::Node*> nodes(4, nullptr);
+    for (uint_t i=0; i<e->n_nodes(); i++) {
+        nodes[i] = libMesh::Node::build(libMesh::Point(x_vec(i), y_vec(i)), i).release();
+        e->set_node(i) = nodes[i];
+    }
+    
+    using dual_t           = MAST::Dual<3>;
+    using traits_t         = Traits<real_t, real_t, real_t>;
+    using traits_dual_t    = Traits<real_t, real_t, dual_t>;
+
+    typename traits_t::vector_t
+    sol,
+    res,
+    res_d;
+
+    typename traits_t::matrix_t
+    jac,
+    jac_d;
+
+    ElemOps<traits_t> e_ops;
+    e_ops.init(e.get());
+    
+    sol    = 0.1 * traits_t::vector_t::Random(e_ops.n_dofs());
+    res    = traits_t::vector_t::Zero(e_ops.n_dofs());
+    jac    = traits_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs());
+    e_ops.compute(sol, res, &jac);
+
+    // a single evaluation with E, nu and th as the three derivative directions
+    typename traits_dual_t::vector_t
+    sol_dual,
+    res_dual;
+    
+    typename traits_dual_t::matrix_t
+    jac_dual;
+
+    ElemOps<traits_dual_t> e_ops_d;
+    e_ops_d.init(e.get());
+    
+    (*e_ops_d.E)()  = dual_t::variable((*e_ops.E)(),  0);
+    (*e_ops_d.nu)() = dual_t::variable((*e_ops.nu)(), 1);
+    (*e_ops_d.th)() = dual_t::variable((*e_ops.th)(), 2);
+
+    sol_dual = sol.cast<dual_t>();
+    res_dual = traits_dual_t::vector_t::Zero(e_ops.n_dofs());
+    jac_dual = traits_dual_t::matrix_t::Zero(e_ops.n_dofs(), e_ops.n_dofs());
+    
+    e_ops_d.compute(sol_dual, res_dual, &jac_dual);
+    
+    res_d = res_dual.unaryExpr([](const dual_t& v) { return v.value();});
+    
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res_d)));
+
+    std::vector<typename traits_t::modulus_t*>
+    params = {e_ops.E.get(), e_ops.nu.get(), e_ops.th.get()};
+    
+    for (uint_t k=0; k<params.size(); k++) {
+        
+        res.setZero();
+        jac.setZero();
+        e_ops.derivative(*params[k], res, &jac);
+        
+        res_d = res_dual.unaryExpr([k](const dual_t& v) { return v.derivative(k);});
+        jac_d = jac_dual.unaryExpr([k](const dual_t& v) { return v.derivative(k);});
+        
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(res),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(res_d)));
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(jac),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(jac_d)));
+    }
+    
+    for (uint_t i=0; i<nodes.size(); i++)
+        delete nodes[i];
+}
+
 } // namespace MindlinPlateStrainEnergy
 } // namespace Elasticity
 } // namespace Physics
@@ -0,0 +1,177 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/base/mast_data_types.h>
+#include <mast/solvers/eigen/constrained_generalized_hermitian_eigen_solver.hpp>
+#include <mast/solvers/eigen/constrained_sparse_generalized_hermitian_eigen_solver.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// Eigen includes
+#include <Eigen/SparseCholesky>
+
+
+namespace MAST {
+namespace Test {
+namespace Solvers {
+namespace EigenWrapper {
+
+/*!
+ * sparse stiffness and mass matrices of a bar with \p n nodes, of which the two
+ * end nodes are constrained
+ */
+inline void
+setup_sparse_matrices (uint_t                        n,
+                       real_t                        L,
+                       real_t                        EA,
+                       real_t                        rhoA,
+                       Eigen::SparseMatrix<real_t>  &A,
+                       Eigen::SparseMatrix<real_t>  &B,
+                       std::vector<uint_t>          &unconstrained_dofs) {
+
+    real_t h = L/(n-1);
+
+    unconstrained_dofs.clear();
+    for (uint_t i=1; i<n-1; i++)
+        unconstrained_dofs.push_back(i);
+
+    Eigen::Matrix<real_t, 2, 2>
+    k_e = Eigen::Matrix<real_t, 2, 2>::Zero(),
+    m_e = Eigen::Matrix<real_t, 2, 2>::Zero();
+    
+    k_e << 1, -1, -1, 1,
+    m_e << 2./3., 1./3., 1./3., 2./3.;
+
+    k_e *= EA/h;
+    m_e *= rhoA*h/2.;
+    
+    std::vector<Eigen::Triplet<real_t>>
+    a,
+    b;
+    
+    for (uint_t i=0; i<n-1; i++)
+        for (uint_t j=0; j<2; j++)
+            for (uint_t k=0; k<2; k++) {
+                
+                a.push_back(Eigen::Triplet<real_t>(i+j, i+k, k_e(j,k)));
+                b.push_back(Eigen::Triplet<real_t>(i+j, i+k, m_e(j,k)));
+            }
+    
+    A.resize(n, n);
+    B.resize(n, n);
+    A.setFromTriplets(a.begin(), a.end());
+    B.setFromTriplets(b.begin(), b.end());
+}
+
+
+
+TEST_CASE("eigen_constrained_sparse_generalized_hermitian_eigen_solver",
+          "[Algebra][Solvers][Eigen][Sensitivity]") {
+    
+    uint_t
+    n_ev = 5;
+    
+    real_t
+    L              = 3,
+    EA             = 3.,
+    rhoA           = 0.5;
+
+    using vector_t        = Eigen::Matrix<real_t, Eigen::Dynamic, 1>;
+    using dense_matrix_t  = Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using matrix_t        = Eigen::SparseMatrix<real_t>;
+    
+    matrix_t
+    A,
+    B,
+    Asens,
+    Bsens;
+    
+    std::vector<uint_t>
+    unconstrained_dofs;
+
+    setup_sparse_matrices(200, L, EA, rhoA,     A,     B, unconstrained_dofs);
+    setup_sparse_matrices(200, L, 1.,   0., Asens, Bsens, unconstrained_dofs);
+
+    // reference solution from the dense solver
+    dense_matrix_t
+    A_d = dense_matrix_t(A),
+    B_d = dense_matrix_t(B);
+    
+    MAST::Solvers::EigenWrapper::ConstrainedGeneralizedHermitianEigenSolver
+    <real_t,
+     Eigen::GeneralizedSelfAdjointEigenSolver<dense_matrix_t>,
+     dense_matrix_t,
+     vector_t>
+    dense_solver(unconstrained_dofs);
+    
+    dense_solver.solve(A_d, B_d, true);
+    
+    MAST::Solvers::EigenWrapper::ConstrainedSparseGeneralizedHermitianEigenSolver
+    <real_t,
+     Eigen::SimplicialLDLT<matrix_t>,
+     matrix_t,
+     vector_t>
+    solver(unconstrained_dofs);
+    
+    solver.solve(A, B, n_ev, true);
+    
+    REQUIRE(solver.n_converged() == n_ev);
+    CHECK(solver.n_iterations() < unconstrained_dofs.size());
+    
+    for (uint_t i=0; i<n_ev; i++) {
+        
+        // check the eigenvalues
+        CHECK(solver.eig(i) == Catch::Detail::Approx(dense_solver.eig(i)));
+
+        // check the residual of the eigenpair
+        vector_t
+        x = vector_t::Zero(A.rows());
+        solver.getEigenVector(i, x);
+        
+        CHECK(x.dot(B * x) == Catch::Detail::Approx(1.));
+        
+        // the residual is checked only for the unconstrained dofs
+        vector_t
+        r = A * x - solver.eig(i) * (B * x);
+        r(0)          = 0.;
+        r(A.rows()-1) = 0.;
+        CHECK(r.norm() <= 1.e-6 * solver.eig(i));
+        
+        // check sensitivity values
+        CHECK(solver.sensitivity_solve(B, Asens, Bsens, i) ==
+              Catch::Detail::Approx(solver.eig(i)/EA));
+    }
+    
+    // eigenvalues closest to a shift within the spectrum
+    solver.shift = 0.5 * (solver.eig(2) + solver.eig(3));
+    solver.solve(A, B, 2, false);
+    
+    REQUIRE(solver.n_converged() == 2);
+    CHECK(solver.eig(0) == Catch::Detail::Approx(dense_solver.eig(2)));
+    CHECK(solver.eig(1) == Catch::Detail::Approx(dense_solver.eig(3)));
+}
+
+} // namespace EigenWrapper
+} // namespace Solvers
+} // namespace Test
+} // namespace MAST
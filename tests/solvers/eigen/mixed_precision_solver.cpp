@@ -0,0 +1,136 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/solvers/eigen/mixed_precision_solver.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// Eigen includes
+#include <Eigen/SparseLU>
+
+
+namespace MAST {
+namespace Test {
+namespace Solvers {
+namespace EigenWrapper {
+
+/*!
+ * five-point finite difference Laplacian on a \p n x \p n grid
+ */
+inline void
+laplacian(uint_t n, Eigen::SparseMatrix<real_t>& m) {
+    
+    std::vector<Eigen::Triplet<real_t>>
+    t;
+    
+    for (uint_t i=0; i<n; i++)
+        for (uint_t j=0; j<n; j++) {
+            
+            uint_t
+            k = i*n+j;
+            
+            t.push_back(Eigen::Triplet<real_t>(k, k, 4.));
+            if (i > 0)   t.push_back(Eigen::Triplet<real_t>(k, k-n, -1.));
+            if (i < n-1) t.push_back(Eigen::Triplet<real_t>(k, k+n, -1.));
+            if (j > 0)   t.push_back(Eigen::Triplet<real_t>(k, k-1, -1.));
+            if (j < n-1) t.push_back(Eigen::Triplet<real_t>(k, k+1, -1.));
+        }
+    
+    m.resize(n*n, n*n);
+    m.setFromTriplets(t.begin(), t.end());
+}
+
+
+TEST_CASE("eigen_mixed_precision_solver",
+          "[Algebra][Solvers][Linear][Eigen]") {
+    
+    using matrix_t        = Eigen::SparseMatrix<real_t>;
+    using vector_t        = Eigen::Matrix<real_t, Eigen::Dynamic, 1>;
+    using low_solver_t    = Eigen::SparseLU<Eigen::SparseMatrix<float>>;
+    using high_solver_t   = Eigen::SparseLU<matrix_t>;
+    using solver_t        = MAST::Solvers::EigenWrapper::MixedPrecisionSolver
+    <matrix_t, low_solver_t, high_solver_t>;
+    
+    matrix_t
+    m;
+    laplacian(20, m);
+    
+    vector_t
+    b     = vector_t::Random(m.rows()),
+    x_ref = high_solver_t(m).solve(b);
+
+    SECTION("iterative refinement") {
+        
+        solver_t
+        solver;
+        solver.compute(m);
+        
+        vector_t
+        x = solver.solve(b);
+        
+        CHECK_FALSE(solver.if_full_precision());
+        CHECK(solver.n_fallbacks() == 0);
+        CHECK(solver.n_refinement_iterations() > 0);
+        CHECK((b - m * x).norm() <= solver.tol * b.norm());
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)));
+        
+        // numeric factorization with the same pattern
+        m     *= 2.;
+        x_ref /= 2.;
+        solver.factorize(m);
+        x = solver.solve(b);
+        
+        CHECK(solver.n_fallbacks() == 0);
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)));
+    }
+
+    SECTION("full precision fallback") {
+        
+        solver_t
+        solver;
+        
+        // no refinement iterations are allowed, so that the solver must fallback to
+        // the full precision factorization
+        solver.max_iter = 0;
+        solver.compute(m);
+        
+        vector_t
+        x = solver.solve(b);
+
+        CHECK(solver.if_full_precision());
+        CHECK(solver.n_fallbacks() == 1);
+        CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+                   Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)));
+        
+        // subsequent solves use the full precision factorization
+        x = solver.solve(b);
+        CHECK(solver.n_fallbacks() == 1);
+    }
+}
+
+} // namespace EigenWrapper
+} // namespace Solvers
+} // namespace Test
+} // namespace MAST
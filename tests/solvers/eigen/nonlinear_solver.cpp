@@ -28,6 +28,8 @@
 
 // Eigen includes
 #include <Eigen/LU>
+#include <Eigen/SparseLU>
+#include <Eigen/SparseCholesky>
 
 
 namespace MAST {
@@ -106,6 +108,71 @@ protected:
 
 
 
+/*!
+ * same function as \p Function with the Jacobian stored in a sparse matrix, whose
+ * sparsity pattern is the diagonal and does not change with \p x.
+ */
+template <typename ScalarType>
+class SparseFunction: public Function<ScalarType> {
+  
+public:
+
+    using scalar_t = ScalarType;
+    using vector_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
+    using matrix_t = Eigen::SparseMatrix<scalar_t>;
+    
+    SparseFunction(const ScalarType &dp_val): Function<ScalarType>(dp_val) { }
+
+    virtual ~SparseFunction() { }
+    
+    inline void init_matrix(matrix_t &m) {
+        
+        m.resize(this->n, this->n);
+        m.setIdentity();
+        m.makeCompressed();
+    }
+    
+    inline void jacobian(const vector_t &x, matrix_t &jac) {
+
+        for (int_t i=0; i<this->n; i++)
+            jac.coeffRef(i, i) = 2.*x(i);
+
+        jac.coeffRef(this->perturb_idx, this->perturb_idx) =
+        2.*(x(this->perturb_idx)-this->dp);
+    }
+};
+
+
+/*!
+ * counts the symbolic and numeric factorizations computed by \p SolverType
+ */
+template <typename SolverType>
+class CountingSolver: public SolverType {
+    
+public:
+    
+    CountingSolver(): SolverType(), n_analyze(0), n_factorize(0) { }
+    
+    template <typename MatType>
+    inline void analyzePattern(const MatType &m) {
+        
+        n_analyze++;
+        SolverType::analyzePattern(m);
+    }
+
+    template <typename MatType>
+    inline void factorize(const MatType &m) {
+        
+        n_factorize++;
+        SolverType::factorize(m);
+    }
+    
+    uint_t n_analyze;
+    uint_t n_factorize;
+};
+
+
+
 template <typename FuncType>
 void xinit(FuncType                                 &f,
            Eigen::Matrix<real_t, Eigen::Dynamic, 1> &x) {
@@ -273,6 +340,161 @@ TEST_CASE("eigen_nonlinear_solver",
 #endif
 }
 
+
+
+TEST_CASE("eigen_nonlinear_solver_factorization_reuse",
+          "[Algebra][Solvers][Nonlinear][Eigen]") {
+
+    using func_t          = MAST::Test::Solvers::EigenWrapper::Function<real_t>;
+    using vector_t        = typename func_t::vector_t;
+    using matrix_t        = typename func_t::matrix_t;
+    using linear_solver_t = typename Eigen::PartialPivLU<matrix_t>;
+
+    real_t
+    dp;
+    MAST::Test::Solvers::EigenWrapper::perturb(dp);
+
+    func_t f(dp);
+    
+    vector_t
+    x,
+    x_ref,
+    dres,
+    dx,
+    dx_adj,
+    dx_ref;
+    
+    MAST::Solvers::EigenWrapper::NonlinearSolver<real_t, linear_solver_t, func_t>
+    solver;
+    solver.rtol = 1.e-10;
+    solver.tol  = 1.e-10;
+    
+    // modified Newton iterations with the factorization lagged by two iterations
+    solver.lag_factorization = 2;
+    
+    MAST::Test::Solvers::EigenWrapper::xinit(f, x);
+    solver.solve(f, x);
+    f.ref_solution(x_ref);
+
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)).margin(1.e-3));
+
+    // factorization at the converged solution is used for the sensitivity solve
+    solver.factorize(f, x);
+    f.residual_sensitivity(x, dres);
+    f.ref_solution_sens(dx_ref);
+
+    solver.solve_linear(dres, dx);
+    dx *= -1.;
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(dx),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(dx_ref)).margin(1.e-3));
+    
+    // Jacobian of this function is diagonal, so the adjoint solve gives the same vector
+    solver.solve_adjoint(dres, dx_adj);
+    dx_adj *= -1.;
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(dx_adj),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(dx_ref)).margin(1.e-3));
+}
+
+
+
+template <typename LinearSolverType>
+void
+check_sparse_factorization_reuse() {
+    
+    using func_t          = MAST::Test::Solvers::EigenWrapper::SparseFunction<real_t>;
+    using vector_t        = typename func_t::vector_t;
+    using linear_solver_t = MAST::Test::Solvers::EigenWrapper::CountingSolver<LinearSolverType>;
+
+    real_t
+    dp;
+    MAST::Test::Solvers::EigenWrapper::perturb(dp);
+
+    func_t f(dp);
+    
+    vector_t
+    x,
+    x_ref,
+    dres,
+    dx,
+    dx_ref;
+    
+    f.ref_solution(x_ref);
+    
+    MAST::Solvers::EigenWrapper::NonlinearSolver<real_t, linear_solver_t, func_t>
+    solver;
+    solver.rtol = 1.e-10;
+    solver.tol  = 1.e-10;
+    
+    // Newton iterations factorize the Jacobian at every iteration, and the
+    // sparsity pattern is analyzed only once
+    x = vector_t::Constant(f.n, 0.7);
+    solver.solve(f, x);
+
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)).margin(1.e-3));
+    CHECK(solver.linear_solver().n_analyze   == 1);
+    CHECK(solver.n_factorizations()          == solver.n_iterations());
+    CHECK(solver.linear_solver().n_factorize == solver.n_factorizations());
+
+    // modified Newton with the factorization lagged by three iterations. The residual
+    // of this function decreases with the lagged factorization, so the stagnation
+    // criterion is disabled and the factorizations follow the lag.
+    const uint_t
+    lag     = 3,
+    n_fact0 = solver.n_factorizations();
+    
+    solver.lag_factorization    = lag;
+    solver.lag_stagnation_ratio = 1.;
+    
+    x = vector_t::Constant(f.n, 0.7);
+    solver.solve(f, x);
+    
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(x),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(x_ref)).margin(1.e-3));
+    CHECK(solver.n_iterations() > lag);
+    CHECK(solver.n_factorizations() - n_fact0 == (solver.n_iterations() + lag - 1)/lag);
+    CHECK(solver.linear_solver().n_analyze   == 1);
+    CHECK(solver.linear_solver().n_factorize == solver.n_factorizations());
+
+    // factorization at the converged solution is used for the sensitivity solve,
+    // and reuses the symbolic analysis
+    solver.factorize(f, x);
+    f.residual_sensitivity(x, dres);
+    f.ref_solution_sens(dx_ref);
+
+    solver.solve_linear(dres, dx);
+    dx *= -1.;
+    CHECK_THAT(MAST::Test::eigen_matrix_to_std_vector(dx),
+               Catch::Approx(MAST::Test::eigen_matrix_to_std_vector(dx_ref)).margin(1.e-3));
+    CHECK(solver.linear_solver().n_analyze   == 1);
+
+    // the pattern is analyzed again after the solver is cleared
+    solver.clear();
+    x = vector_t::Constant(f.n, 0.7);
+    solver.solve(f, x);
+    
+    CHECK(solver.linear_solver().n_analyze   == 2);
+}
+
+
+
+TEST_CASE("eigen_nonlinear_solver_sparse_factorization_reuse",
+          "[Algebra][Solvers][Nonlinear][Eigen]") {
+
+    using matrix_t = Eigen::SparseMatrix<real_t>;
+    
+    SECTION("SparseLU") {
+        
+        check_sparse_factorization_reuse<Eigen::SparseLU<matrix_t, Eigen::COLAMDOrdering<int>>>();
+    }
+    
+    SECTION("SimplicialLDLT") {
+        
+        check_sparse_factorization_reuse<Eigen::SimplicialLDLT<matrix_t>>();
+    }
+}
+
 } // namespace EigenWrapper
 } // namespace Solvers
 } // namespace Test
@@ -0,0 +1,443 @@
+/*
+* MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+* Copyright (C) 2013-2020  Manav Bhatia and MAST authors
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Catch includes
+#include "catch.hpp"
+
+// MAST includes
+#include <mast/solvers/petsc/linear_solver.hpp>
+
+// Test includes
+#include <test_helpers.h>
+
+// libMesh includes
+#include <libmesh/libmesh.h>
+#include <libmesh/parallel.h>
+
+extern libMesh::LibMeshInit *p_global_init;
+
+namespace MAST {
+namespace Test {
+namespace Solvers {
+namespace PETSc {
+
+
+TEST_CASE("petsc_linear_solver_multiple_rhs",
+          "[Algebra][Solvers][Linear][PETSc]") {
+
+    const int_t
+    n     = 10,
+    n_rhs = 3;
+    
+    // symmetric positive definite tridiagonal matrix
+    Mat A;
+    MatCreateSeqAIJ(PETSC_COMM_SELF, n, n, 3, PETSC_NULL, &A);
+    for (int_t i=0; i<n; i++) {
+        
+        MatSetValue(A, i, i, 4., INSERT_VALUES);
+        if (i > 0)   MatSetValue(A, i, i-1, -1., INSERT_VALUES);
+        if (i < n-1) MatSetValue(A, i, i+1, -1., INSERT_VALUES);
+    }
+    MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    
+    MAST::Solvers::PETScWrapper::LinearSolver
+    solver(PETSC_COMM_SELF);
+    solver.init(A);
+    KSPSetTolerances(solver.ksp(), 1.e-12, 1.e-14, PETSC_DEFAULT, PETSC_DEFAULT);
+
+    std::vector<Vec>
+    b(n_rhs, nullptr),
+    x(n_rhs, nullptr),
+    x_ref(n_rhs, nullptr);
+    
+    for (int_t i=0; i<n_rhs; i++) {
+        
+        MatCreateVecs(A, &x[i], &b[i]);
+        VecDuplicate(x[i], &x_ref[i]);
+        VecSetRandom(b[i], PETSC_NULL);
+        
+        // reference solution from independent solves
+        solver.solve(x_ref[i], b[i]);
+    }
+    
+    // all right-hand sides solved together
+    solver.solve(x, b);
+    
+    for (int_t i=0; i<n_rhs; i++) {
+        
+        const real_t
+        *v     = nullptr,
+        *v_ref = nullptr;
+        
+        VecGetArrayRead(x[i], &v);
+        VecGetArrayRead(x_ref[i], &v_ref);
+
+        CHECK_THAT(std::vector<real_t>(v, v+n),
+                   Catch::Approx(std::vector<real_t>(v_ref, v_ref+n)));
+
+        VecRestoreArrayRead(x[i], &v);
+        VecRestoreArrayRead(x_ref[i], &v_ref);
+        
+        VecDestroy(&b[i]);
+        VecDestroy(&x[i]);
+        VecDestroy(&x_ref[i]);
+    }
+    
+    MatDestroy(&A);
+}
+
+
+TEST_CASE("petsc_linear_solver_recycled_subspace",
+          "[Algebra][Solvers][Linear][PETSc]") {
+
+    const int_t
+    n     = 50;
+    
+    // symmetric positive definite tridiagonal matrix
+    Mat A;
+    MatCreateSeqAIJ(PETSC_COMM_SELF, n, n, 3, PETSC_NULL, &A);
+    for (int_t i=0; i<n; i++) {
+        
+        MatSetValue(A, i, i, 4., INSERT_VALUES);
+        if (i > 0)   MatSetValue(A, i, i-1, -1., INSERT_VALUES);
+        if (i < n-1) MatSetValue(A, i, i+1, -1., INSERT_VALUES);
+    }
+    MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    
+    Vec
+    b,
+    x,
+    x_ref;
+    MatCreateVecs(A, &x, &b);
+    VecDuplicate(x, &x_ref);
+    VecSetRandom(b, PETSC_NULL);
+    
+    MAST::Solvers::PETScWrapper::RecycledSubspace
+    subspace;
+    
+    MAST::Solvers::PETScWrapper::LinearSolver
+    solver(PETSC_COMM_SELF),
+    solver_ref(PETSC_COMM_SELF);
+    
+    solver.set_recycled_subspace(&subspace);
+    
+    PC pc;
+    for (auto s: {&solver, &solver_ref}) {
+        
+        s->init(A);
+        KSPSetType(s->ksp(), KSPCG);
+        KSPGetPC(s->ksp(), &pc);
+        PCSetType(pc, PCNONE);
+        KSPSetTolerances(s->ksp(), 1.e-10, 1.e-14, PETSC_DEFAULT, PETSC_DEFAULT);
+    }
+
+    solver.solve(x, b);
+    CHECK(subspace.size() == 1);
+    
+    const uint_t
+    n_its_first = solver.n_iterations();
+
+    // perturb the operator, similar to a design update
+    MatShift(A, 0.05);
+    
+    solver.update_operators(A);
+    solver_ref.update_operators(A);
+    
+    solver.solve(x, b);
+    solver_ref.solve(x_ref, b);
+    
+    // the recycled solution reduces the iterations of the second solve
+    CHECK(subspace.n_initial_guesses() == 1);
+    CHECK(solver.n_solves() == 2);
+    CHECK(solver.n_iterations() - n_its_first < solver_ref.n_iterations());
+    
+    const real_t
+    *v     = nullptr,
+    *v_ref = nullptr;
+    
+    VecGetArrayRead(x, &v);
+    VecGetArrayRead(x_ref, &v_ref);
+
+    CHECK_THAT(std::vector<real_t>(v, v+n),
+               Catch::Approx(std::vector<real_t>(v_ref, v_ref+n)));
+
+    VecRestoreArrayRead(x, &v);
+    VecRestoreArrayRead(x_ref, &v_ref);
+
+    VecDestroy(&b);
+    VecDestroy(&x);
+    VecDestroy(&x_ref);
+    MatDestroy(&A);
+}
+
+TEST_CASE("petsc_linear_solver_recycled_subspace_sequence",
+          "[Algebra][Solvers][Linear][PETSc]") {
+
+    const int_t
+    n     = 50,
+    n_sys = 5;
+    
+    // symmetric positive definite tridiagonal matrix
+    Mat A;
+    MatCreateSeqAIJ(PETSC_COMM_SELF, n, n, 3, PETSC_NULL, &A);
+    for (int_t i=0; i<n; i++) {
+        
+        MatSetValue(A, i, i, 4., INSERT_VALUES);
+        if (i > 0)   MatSetValue(A, i, i-1, -1., INSERT_VALUES);
+        if (i < n-1) MatSetValue(A, i, i+1, -1., INSERT_VALUES);
+    }
+    MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    
+    Vec
+    b,
+    x,
+    x_ref;
+    MatCreateVecs(A, &x, &b);
+    VecDuplicate(x, &x_ref);
+    
+    MAST::Solvers::PETScWrapper::RecycledSubspace
+    subspace;
+    
+    MAST::Solvers::PETScWrapper::LinearSolver
+    solver(PETSC_COMM_SELF),
+    solver_ref(PETSC_COMM_SELF);
+    
+    solver.set_recycled_subspace(&subspace);
+    
+    bool
+    direct = false;
+    
+    SECTION("direct solver") {
+        
+        direct = true;
+    }
+    
+    SECTION("conjugate gradient") {
+        
+        direct = false;
+    }
+
+    PC pc;
+    for (auto s: {&solver, &solver_ref}) {
+        
+        s->init(A);
+        KSPGetPC(s->ksp(), &pc);
+        
+        if (direct) {
+            
+            KSPSetType(s->ksp(), KSPPREONLY);
+            PCSetType(pc, PCLU);
+        }
+        else {
+            
+            KSPSetType(s->ksp(), KSPCG);
+            PCSetType(pc, PCNONE);
+            KSPSetTolerances(s->ksp(), 1.e-10, 1.e-14, PETSC_DEFAULT, PETSC_DEFAULT);
+        }
+    }
+    
+    for (int_t i=0; i<n_sys; i++) {
+        
+        // operator and right-hand side change slowly over the sequence,
+        // similar to design updates
+        if (i > 0) MatShift(A, 0.02);
+        VecSet(b, 1.);
+        VecSetValue(b, i, 2., INSERT_VALUES);
+        VecAssemblyBegin(b);
+        VecAssemblyEnd(b);
+        
+        solver.update_operators(A);
+        solver_ref.update_operators(A);
+        
+        solver.solve(x, b);
+        solver_ref.solve(x_ref, b);
+        
+        const real_t
+        *v     = nullptr,
+        *v_ref = nullptr;
+        
+        VecGetArrayRead(x, &v);
+        VecGetArrayRead(x_ref, &v_ref);
+        
+        CHECK_THAT(std::vector<real_t>(v, v+n),
+                   Catch::Approx(std::vector<real_t>(v_ref, v_ref+n)));
+        
+        VecRestoreArrayRead(x, &v);
+        VecRestoreArrayRead(x_ref, &v_ref);
+    }
+    
+    CHECK(solver.n_solves() == n_sys);
+    
+    if (direct) {
+        
+        // the subspace is not used with the direct solver
+        CHECK(subspace.size() == 0);
+        CHECK(subspace.n_initial_guesses() == 0);
+    }
+    else {
+        
+        // all solves after the first start from the recycled solutions, which
+        // reduces the total number of iterations
+        CHECK(subspace.size() == n_sys);
+        CHECK(subspace.n_initial_guesses() == n_sys-1);
+        CHECK(solver.n_iterations() < solver_ref.n_iterations());
+    }
+    
+    VecDestroy(&b);
+    VecDestroy(&x);
+    VecDestroy(&x_ref);
+    MatDestroy(&A);
+}
+
+
+TEST_CASE("petsc_linear_solver_near_null_space",
+          "[Algebra][Solvers][Linear][PETSc]") {
+
+    const int_t
+    n     = 50;
+    
+    // symmetric positive definite tridiagonal matrix
+    Mat A;
+    MatCreateSeqAIJ(PETSC_COMM_SELF, n, n, 3, PETSC_NULL, &A);
+    for (int_t i=0; i<n; i++) {
+        
+        MatSetValue(A, i, i, 2.01, INSERT_VALUES);
+        if (i > 0)   MatSetValue(A, i, i-1, -1., INSERT_VALUES);
+        if (i < n-1) MatSetValue(A, i, i+1, -1., INSERT_VALUES);
+    }
+    MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    
+    Vec
+    b,
+    x;
+    MatCreateVecs(A, &x, &b);
+    VecSet(b, 1.);
+    
+    // the constant vector is the near-nullspace of the operator
+    MatNullSpace
+    nsp     = nullptr,
+    mat_nsp = nullptr;
+    MatNullSpaceCreate(PETSC_COMM_SELF, PETSC_TRUE, 0, PETSC_NULL, &nsp);
+    
+    // algebraic multigrid selected for the scope of this solver only
+    const std::string
+    scope = "amg_test";
+    PetscOptionsSetValue(PETSC_NULL, "-amg_test_pc_type", "gamg");
+    
+    MAST::Solvers::PETScWrapper::LinearSolver
+    solver(PETSC_COMM_SELF);
+    solver.set_near_null_space(nsp);
+    solver.init(A, &scope);
+    KSPSetTolerances(solver.ksp(), 1.e-10, 1.e-14, PETSC_DEFAULT, PETSC_DEFAULT);
+    
+    // the near-nullspace is attached to the operator
+    MatGetNearNullSpace(A, &mat_nsp);
+    CHECK(mat_nsp == nsp);
+    
+    PC pc;
+    PCType type = nullptr;
+    KSPGetPC(solver.ksp(), &pc);
+    PCGetType(pc, &type);
+    CHECK(std::string(type) == PCGAMG);
+
+    solver.solve(x, b);
+    
+    KSPConvergedReason reason;
+    KSPGetConvergedReason(solver.ksp(), &reason);
+    CHECK(reason > 0);
+    
+    // the near-nullspace is attached to a new operator
+    Mat B;
+    MatDuplicate(A, MAT_COPY_VALUES, &B);
+    solver.update_operators(B);
+    MatGetNearNullSpace(B, &mat_nsp);
+    CHECK(mat_nsp == nsp);
+    
+    // the solver holds its own reference to the near-nullspace
+    MatNullSpaceDestroy(&nsp);
+    solver.solve(x, b);
+    KSPGetConvergedReason(solver.ksp(), &reason);
+    CHECK(reason > 0);
+    
+    PetscOptionsClearValue(PETSC_NULL, "-amg_test_pc_type");
+    
+    VecDestroy(&b);
+    VecDestroy(&x);
+    MatDestroy(&B);
+    MatDestroy(&A);
+}
+
+
+TEST_CASE("petsc_linear_solver_amg_default_options",
+          "[Algebra][Solvers][Linear][PETSc]") {
+
+#if defined(PETSC_HAVE_HYPRE)
+
+    const int_t
+    n     = 10;
+    
+    Mat A;
+    MatCreateSeqAIJ(PETSC_COMM_SELF, n, n, 3, PETSC_NULL, &A);
+    for (int_t i=0; i<n; i++) {
+        
+        MatSetValue(A, i, i, 4., INSERT_VALUES);
+        if (i > 0)   MatSetValue(A, i, i-1, -1., INSERT_VALUES);
+        if (i < n-1) MatSetValue(A, i, i+1, -1., INSERT_VALUES);
+    }
+    MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    
+    const std::string
+    scope = "hypre_test";
+    PetscOptionsSetValue(PETSC_NULL, "-hypre_test_pc_type", "hypre");
+    
+    MAST::Solvers::PETScWrapper::LinearSolver
+    solver(PETSC_COMM_SELF);
+    solver.init(A, &scope);
+    
+    // the defaults set by the solver are not left in the options database
+    PetscBool
+    flg = PETSC_TRUE;
+    PetscOptionsHasName(PETSC_NULL, "hypre_test_", "-pc_hypre_boomeramg_strong_threshold", &flg);
+    CHECK(flg == PETSC_FALSE);
+    PetscOptionsHasName(PETSC_NULL, PETSC_NULL, "-pc_hypre_boomeramg_strong_threshold", &flg);
+    CHECK(flg == PETSC_FALSE);
+    
+    // options provided by the user are retained
+    PetscOptionsSetValue(PETSC_NULL, "-hypre_test_pc_hypre_boomeramg_strong_threshold", "0.25");
+    solver.clear();
+    solver.init(A, &scope);
+    PetscOptionsHasName(PETSC_NULL, "hypre_test_", "-pc_hypre_boomeramg_strong_threshold", &flg);
+    CHECK(flg == PETSC_TRUE);
+    
+    PetscOptionsClearValue(PETSC_NULL, "-hypre_test_pc_hypre_boomeramg_strong_threshold");
+    PetscOptionsClearValue(PETSC_NULL, "-hypre_test_pc_type");
+    
+    MatDestroy(&A);
+#endif // PETSC_HAVE_HYPRE
+}
+
+} // namespace PETSc
+} // namespace Solvers
+} // namespace Test
+} // namespace MAST
+
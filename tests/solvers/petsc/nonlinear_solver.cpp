@@ -103,6 +103,56 @@ protected:
 
 
 
+/*!
+ * \f$ R_i(x) = \tan^{-1}(x_i) \f$, for which the full Newton step diverges for
+ * \f$ |x_i| > 1.39 \f$ and a line search is needed for convergence.
+ */
+class ArctanFunction: public Function {
+  
+public:
+
+    ArctanFunction(MPI_Comm comm):
+    Function(comm) { }
+
+    virtual ~ArctanFunction() { }
+    
+    inline void residual(Vec x, Vec res) {
+        
+        real_t
+        v = 0.;
+        
+        VecZeroEntries(res);
+        
+        for (int_t i=0; i<n; i++) {
+            
+            VecGetValues(x, 1, &i, &v);
+            VecSetValue(res, i, std::atan(v), INSERT_VALUES);
+        }
+        
+        VecAssemblyBegin(res);
+        VecAssemblyEnd(res);
+    }
+    
+    inline void jacobian(Vec x, Mat jac) {
+
+        real_t
+        v = 0.;
+        
+        MatZeroEntries(jac);
+        
+        for (int_t i=0; i<n; i++) {
+            
+            VecGetValues(x, 1, &i, &v);
+            MatSetValue(jac, i, i, 1./(1.+v*v), INSERT_VALUES);
+        }
+        
+        MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);
+    }
+};
+
+
+
 
 TEST_CASE("petsc_nonlinear_solver",
           "[Algebra][Solvers][Nonlinear][PETSc]") {
@@ -120,6 +170,11 @@ TEST_CASE("petsc_nonlinear_solver",
     
     solver.solve(f, x);
 
+    // full Newton steps satisfy the sufficient decrease condition for this
+    // function, so the line search does not need additional residuals
+    CHECK(solver.n_residual_evaluations() == solver.n_iterations() + 1);
+    CHECK(solver.n_jacobian_evaluations() == solver.n_iterations());
+
     real_t *vals;
     VecGetArray(x, &vals);
 
@@ -128,6 +183,155 @@ TEST_CASE("petsc_nonlinear_solver",
                Catch::Approx(std::vector<real_t>(f.n, 0.)).margin(1.e-3));
 }
 
+
+
+TEST_CASE("petsc_nonlinear_solver_lagged_preconditioner",
+          "[Algebra][Solvers][Nonlinear][PETSc]") {
+
+    using f_type = MAST::Test::Solvers::PETSc::Function;
+    
+    f_type f(p_global_init->comm().get());
+    
+    MAST::Solvers::PETScWrapper::NonlinearSolver<f_type>
+    solver(p_global_init->comm().get());
+    
+    // preconditioner is computed only for the first iteration. The residual
+    // reduces by a factor of 4 in each iteration for this function, which
+    // does not trigger a recompute due to stagnation.
+    solver.lag_preconditioner = 0;
+    
+    Vec x;
+    MatCreateVecs(*f.matrix(), &x, PETSC_NULL);
+    VecSetRandom(x, PETSC_NULL);
+    VecShift(x, 1.);
+    
+    solver.solve(f, x);
+
+    CHECK(solver.linear_solver().n_preconditioner_setups() == 1);
+
+    real_t *vals;
+    VecGetArray(x, &vals);
+    
+    CHECK_THAT(std::vector<real_t>(vals, vals+f.n),
+               Catch::Approx(std::vector<real_t>(f.n, 0.)).margin(1.e-3));
+    
+    VecRestoreArray(x, &vals);
+
+    // the KSP is retained for a second solve, which recomputes the
+    // preconditioner at its first iteration
+    VecSet(x, 1.);
+    solver.solve(f, x);
+
+    CHECK(solver.linear_solver().n_preconditioner_setups() == 2);
+    
+    VecDestroy(&x);
+}
+
+
+
+TEST_CASE("petsc_nonlinear_solver_line_search",
+          "[Algebra][Solvers][Nonlinear][PETSc]") {
+
+    using f_type = MAST::Test::Solvers::PETSc::ArctanFunction;
+    
+    f_type f(p_global_init->comm().get());
+    
+    MAST::Solvers::PETScWrapper::NonlinearSolver<f_type>
+    solver(p_global_init->comm().get());
+    
+    // line search is not used unless requested
+    CHECK(!solver.line_search);
+    
+    solver.line_search = true;
+    
+    Vec x;
+    MatCreateVecs(*f.matrix(), &x, PETSC_NULL);
+    
+    // the full Newton step diverges from this point
+    VecSet(x, 3.);
+    solver.solve(f, x);
+
+    CHECK(solver.n_line_search_failures() == 0);
+    CHECK(solver.n_residual_evaluations() > solver.n_iterations() + 1);
+
+    real_t *vals;
+    VecGetArray(x, &vals);
+    
+    CHECK_THAT(std::vector<real_t>(vals, vals+f.n),
+               Catch::Approx(std::vector<real_t>(f.n, 0.)).margin(1.e-3));
+    
+    VecRestoreArray(x, &vals);
+
+    // without any reductions of the step the sufficient decrease condition is
+    // not satisfied, which is reported
+    solver.line_search_max_iter = 0;
+    solver.max_iter             = 1;
+    VecSet(x, 3.);
+    solver.solve(f, x);
+
+    CHECK(solver.n_line_search_failures() == 1);
+    
+    VecDestroy(&x);
+}
+
+
+
+TEST_CASE("petsc_nonlinear_solver_eisenstat_walker",
+          "[Algebra][Solvers][Nonlinear][PETSc]") {
+
+    using f_type = MAST::Test::Solvers::PETSc::Function;
+    
+    f_type f(p_global_init->comm().get());
+    
+    MAST::Solvers::PETScWrapper::NonlinearSolver<f_type>
+    solver(p_global_init->comm().get());
+    
+    Vec x;
+    MatCreateVecs(*f.matrix(), &x, PETSC_NULL);
+    VecSet(x, 1.);
+    
+    // the first solve creates the KSP, whose tolerance is then set as a user would
+    solver.solve(f, x);
+    
+    const PetscReal
+    rtol = 1.e-9;
+    
+    KSPSetTolerances(solver.linear_solver().ksp(),
+                     rtol,
+                     PETSC_DEFAULT,
+                     PETSC_DEFAULT,
+                     PETSC_DEFAULT);
+
+    solver.eisenstat_walker = true;
+    VecSet(x, 1.);
+    solver.solve(f, x);
+    
+    // the tolerance modified by the forcing terms is restored after the solve
+    PetscReal
+    ksp_rtol   = 0.,
+    ksp_abstol = 0.,
+    ksp_dtol   = 0.;
+    PetscInt
+    ksp_maxits = 0;
+    
+    KSPGetTolerances(solver.linear_solver().ksp(),
+                     &ksp_rtol,
+                     &ksp_abstol,
+                     &ksp_dtol,
+                     &ksp_maxits);
+    
+    CHECK(ksp_rtol == Catch::Detail::Approx(rtol));
+
+    real_t *vals;
+    VecGetArray(x, &vals);
+    
+    CHECK_THAT(std::vector<real_t>(vals, vals+f.n),
+               Catch::Approx(std::vector<real_t>(f.n, 0.)).margin(1.e-3));
+    
+    VecRestoreArray(x, &vals);
+    VecDestroy(&x);
+}
+
 } // namespace PETSc
 } // namespace Solvers
 } // namespace Test
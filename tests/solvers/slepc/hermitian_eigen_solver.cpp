@@ -142,6 +142,99 @@ TEST_CASE("slepc_hermitian_interface",
     }
 }
 
+
+TEST_CASE("slepc_hermitian_repeated_solve",
+          "[Algebra][Solvers][SLEPc]") {
+    
+    uint_t
+    n_ev = 2;
+    
+    real_t
+    L              = 3,
+    EA             = 3.,
+    rhoA           = 0.5,
+    scale          = 1.01;
+    
+    Mat A, B;
+    
+    setup_matrices(L, EA, rhoA, &A, &B);
+
+    MAST::Solvers::SLEPcWrapper::HermitianEigenSolver
+    eig_solver(p_global_init->comm().get(), EPS_GHEP),
+    eig_solver_ref(p_global_init->comm().get(), EPS_GHEP);
+    
+    eig_solver.solve(A, &B, n_ev, EPS_SMALLEST_REAL, true);
+    
+    REQUIRE(eig_solver.n_converged() >= n_ev);
+
+    std::vector<real_t>
+    eig(n_ev, 0.);
+    
+    for (uint_t i=0; i<n_ev; i++)
+        eig[i] = eig_solver.eig(i);
+    
+    // scaling the stiffness scales the eigenvalues and leaves the eigenvectors
+    // unchanged, so that the warm start provides the converged eigenvectors
+    MatScale(A, scale);
+    
+    eig_solver.solve(A, &B, n_ev, EPS_SMALLEST_REAL, true);
+    eig_solver_ref.solve(A, &B, n_ev, EPS_SMALLEST_REAL, true);
+    
+    REQUIRE(eig_solver.n_converged() >= n_ev);
+    REQUIRE(eig_solver_ref.n_converged() >= n_ev);
+
+    for (uint_t i=0; i<n_ev; i++) {
+        
+        CHECK(eig_solver.eig(i) == Catch::Detail::Approx(scale * eig[i]));
+        CHECK(eig_solver.eig(i) == Catch::Detail::Approx(eig_solver_ref.eig(i)));
+    }
+    
+    // the warm start does not require more iterations than a new solve
+    CHECK(eig_solver.n_iterations() <= eig_solver_ref.n_iterations());
+    
+    MatDestroy(&A);
+    MatDestroy(&B);
+}
+
+
+TEST_CASE("slepc_hermitian_options_override",
+          "[Algebra][Solvers][SLEPc]") {
+    
+    uint_t
+    n_ev = 2;
+    
+    real_t
+    L              = 3,
+    EA             = 3.,
+    rhoA           = 0.5,
+    pi             = acos(-1.),
+    eig_min        = EA/rhoA* pow(pi/L, 2);
+    
+    Mat A, B;
+    
+    setup_matrices(L, EA, rhoA, &A, &B);
+
+    // the command line option for the spectrum takes precedence over the argument of
+    // solve, for the first and for the repeated solves
+    PetscOptionsSetValue(PETSC_NULL, "-eps_largest_real", PETSC_NULL);
+    
+    MAST::Solvers::SLEPcWrapper::HermitianEigenSolver
+    eig_solver(p_global_init->comm().get(), EPS_GHEP);
+    
+    for (uint_t i=0; i<2; i++) {
+        
+        eig_solver.solve(A, &B, n_ev, EPS_SMALLEST_REAL, true);
+        
+        REQUIRE(eig_solver.n_converged() >= n_ev);
+        CHECK(eig_solver.eig(0) > 1.e2 * eig_min);
+    }
+    
+    PetscOptionsClearValue(PETSC_NULL, "-eps_largest_real");
+    
+    MatDestroy(&A);
+    MatDestroy(&B);
+}
+
 } // namespace SLEPc
 } // namespace Solvers
 } // namespace Test